@@ -9,6 +9,7 @@ log_args=("--min-log-severity" "stat")
 conn_args=()
 case "${1}" in
 	posixmq) conn_args+=("--msgbus-posix-mqueue");;
+	posixshm) conn_args+=("--msgbus-posix-shmem");;
 	udpip4) conn_args+=("--msgbus-asio-udp-ipv4");;
 	tcpip4) conn_args+=("--msgbus-asio-tcp-ipv4");;
 	local|*) conn_args+=("--msgbus-asio-local-stream");;
@@ -37,7 +37,7 @@ auto main(main_ctx& ctx) -> int {
         if(the_file_server.update_message_age().update_and_process_all()) {
             std::this_thread::sleep_for(std::chrono::microseconds(125));
         } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            bus.wait_for_work(std::chrono::milliseconds(10));
         }
         alive.notify();
     }
@@ -39,18 +39,34 @@ auto main(main_ctx& ctx) -> int {
         return arg;
     }};
 
-    const auto enqueue{[&](url locator) {
-        if(locator) {
-            node.stream_resource(
-              {.locator = std::move(locator),
-               .max_time = blob_timeout,
-               .priority = msgbus::message_priority::critical});
-        }
-    }};
+    const auto enqueue{
+      [&](url locator, const std::optional<std::filesystem::path>& output) {
+          if(locator) {
+              const msgbus::resource_request_params params{
+                .locator = std::move(locator),
+                .max_time = blob_timeout,
+                .priority = msgbus::message_priority::critical};
+              if(output) {
+                  // the resource is stored into the file as it arrives
+                  return node.store_resource(params, *output).first != 0;
+              }
+              node.stream_resource(params);
+              return true;
+          }
+          return false;
+      }};
 
     const auto enqueue_next{[&] {
-        if(const auto arg{next_arg()}) {
-            enqueue(url{arg});
+        while(const auto arg{next_arg()}) {
+            std::optional<std::filesystem::path> output;
+            if(const auto tag{arg.next()}; tag.is_long_tag("output")) {
+                if(const auto path{tag.next()}) {
+                    output = path.get_string();
+                }
+            }
+            if(enqueue(url{arg}, output)) {
+                break;
+            }
         }
     }};
 
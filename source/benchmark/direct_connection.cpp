@@ -0,0 +1,114 @@
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+import eagine.core;
+import eagine.sslplus;
+import eagine.msgbus;
+import std;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+namespace msgbus {
+//------------------------------------------------------------------------------
+class direct_connection_benchmark : public main_ctx_object {
+public:
+    direct_connection_benchmark(main_ctx_parent parent)
+      : main_ctx_object{"DrctCnBnch", parent} {}
+
+    void run() noexcept;
+
+private:
+    template <typename Factory>
+    void _run(string_view kind, Factory factory) noexcept;
+
+    const span_size_t _message_count{
+      cfg_init("msgbus.benchmark.message_count", span_size_t(2'000'000))};
+    const span_size_t _message_size{
+      cfg_init("msgbus.benchmark.message_size", span_size_t(64))};
+
+    const message_id _msg_id{"Benchmark", "Direct"};
+    std::vector<byte> _content;
+};
+//------------------------------------------------------------------------------
+template <typename Factory>
+void direct_connection_benchmark::_run(
+  string_view kind,
+  Factory factory) noexcept {
+    auto acceptor{factory->make_acceptor(identifier{"Benchmark"})
+                    .as(std::type_identity<direct_acceptor_intf>{})};
+    if(not acceptor) {
+        return;
+    }
+    auto consumer_conn{acceptor->make_connection()};
+    shared_holder<connection> producer_conn;
+    acceptor->process_accepted(
+      {construct_from, [&](shared_holder<connection> conn) {
+           producer_conn = std::move(conn);
+       }});
+    if(not consumer_conn or not producer_conn) {
+        log_error("failed to connect ${kind}").arg("kind", kind);
+        return;
+    }
+
+    span_size_t received{0};
+    const auto start{std::chrono::steady_clock::now()};
+
+    std::thread consumer{[&] {
+        while(received < _message_count) {
+            consumer_conn->fetch_messages(
+              {construct_from,
+               [&](const message_id, const message_age, const message_view&)
+                 -> bool {
+                   ++received;
+                   return true;
+               }});
+        }
+    }};
+    std::thread producer{[&] {
+        for(span_size_t i = 0; i < _message_count; ++i) {
+            message_view message{view(_content)};
+            message.set_sequence_no(message_sequence_t(i));
+            producer_conn->send(_msg_id, message);
+        }
+    }};
+    producer.join();
+    consumer.join();
+
+    const std::chrono::duration<float> interval{
+      std::chrono::steady_clock::now() - start};
+
+    log_stat("${kind}: ${msgsPerSec} messages per second")
+      .tag("drctCnThrp")
+      .arg("kind", kind)
+      .arg("count", _message_count)
+      .arg("size", "ByteSize", _message_size)
+      .arg("interval", interval)
+      .arg("msgsPerSec", "RatePerSec", float(received) / interval.count());
+}
+//------------------------------------------------------------------------------
+void direct_connection_benchmark::run() noexcept {
+    _content.resize(std_size(_message_size));
+    std::fill(_content.begin(), _content.end(), byte(0x5A));
+
+    _run("spinlock", make_direct_connection_factory(*this));
+    _run("lock-free", make_direct_lock_free_connection_factory(*this));
+}
+//------------------------------------------------------------------------------
+} // namespace msgbus
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    msgbus::direct_connection_benchmark{ctx}.run();
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagine::main_ctx_options options;
+    options.app_id = "DrctCnBnch";
+    return eagine::main_impl(argc, argv, options, &eagine::main);
+}
+//------------------------------------------------------------------------------
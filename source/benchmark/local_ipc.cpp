@@ -0,0 +1,209 @@
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+import eagine.core;
+import eagine.sslplus;
+import eagine.msgbus;
+import std;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+namespace msgbus {
+//------------------------------------------------------------------------------
+class local_ipc_benchmark : public main_ctx_object {
+public:
+    local_ipc_benchmark(main_ctx_parent parent)
+      : main_ctx_object{"LclIPCBnch", parent} {}
+
+    void run() noexcept;
+
+private:
+    void _run(unique_holder<connection_factory> factory) noexcept;
+
+    auto _connect(connection_factory&) noexcept -> bool;
+    void _update() noexcept;
+    void _measure_throughput(identifier kind) noexcept;
+    void _measure_latency(identifier kind) noexcept;
+
+    const span_size_t _message_count{
+      cfg_init("msgbus.benchmark.message_count", span_size_t(200'000))};
+    const span_size_t _message_size{
+      cfg_init("msgbus.benchmark.message_size", span_size_t(256))};
+    const span_size_t _roundtrip_count{
+      cfg_init("msgbus.benchmark.roundtrip_count", span_size_t(20'000))};
+
+    const message_id _msg_id{"Benchmark", "LocalIPC"};
+    std::vector<byte> _content;
+    shared_holder<acceptor> _acceptor;
+    shared_holder<connection> _client;
+    shared_holder<connection> _server;
+};
+//------------------------------------------------------------------------------
+void local_ipc_benchmark::_update() noexcept {
+    _acceptor->update();
+    _client->update();
+    _server->update();
+}
+//------------------------------------------------------------------------------
+auto local_ipc_benchmark::_connect(connection_factory& factory) noexcept
+  -> bool {
+    _acceptor = factory.make_acceptor(identifier{"LocalIPC"});
+    _client = factory.make_connector(identifier{"LocalIPC"});
+    _server.reset();
+
+    const timeout connect_time{std::chrono::seconds{10}};
+    while(not _server and not connect_time) {
+        _acceptor->update();
+        _client->update();
+        _acceptor->process_accepted(
+          {construct_from, [this](shared_holder<connection> conn) {
+               _server = std::move(conn);
+           }});
+    }
+    if(_server) {
+        // wait until the connection handshake is done
+        message_view ping{view(_content)};
+        _client->send(_msg_id, ping);
+        bool received{false};
+        while(not received and not connect_time) {
+            _update();
+            _server->fetch_messages(
+              {construct_from,
+               [&](const message_id, const message_age, const message_view&)
+                 -> bool {
+                   received = true;
+                   return true;
+               }});
+        }
+        return received;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+void local_ipc_benchmark::_measure_throughput(identifier kind) noexcept {
+    span_size_t sent{0};
+    span_size_t received{0};
+    const auto start{std::chrono::steady_clock::now()};
+    while(received < _message_count) {
+        for(span_size_t i = 0; (i < 64) and (sent < _message_count); ++i) {
+            message_view message{view(_content)};
+            message.set_sequence_no(message_sequence_t(sent));
+            if(_client->send(_msg_id, message)) {
+                ++sent;
+            }
+        }
+        _update();
+        _server->fetch_messages(
+          {construct_from,
+           [&](const message_id, const message_age, const message_view&)
+             -> bool {
+               ++received;
+               return true;
+           }});
+    }
+    const std::chrono::duration<float> interval{
+      std::chrono::steady_clock::now() - start};
+
+    log_stat("${kind}: ${msgsPerSec} messages per second")
+      .tag("lclIPCThrp")
+      .arg("kind", kind)
+      .arg("count", _message_count)
+      .arg("size", "ByteSize", _message_size)
+      .arg("interval", interval)
+      .arg("msgsPerSec", "RatePerSec", float(received) / interval.count())
+      .arg(
+        "bytesPerSec",
+        "ByteSize",
+        span_size_t(float(received * _message_size) / interval.count()));
+}
+//------------------------------------------------------------------------------
+void local_ipc_benchmark::_measure_latency(identifier kind) noexcept {
+    std::vector<std::chrono::steady_clock::duration> roundtrips;
+    roundtrips.reserve(std_size(_roundtrip_count));
+
+    const auto echo{[&](shared_holder<connection>& from, auto&& func) {
+        bool received{false};
+        while(not received) {
+            _update();
+            from->fetch_messages(
+              {construct_from,
+               [&](const message_id, const message_age, const message_view&)
+                 -> bool {
+                   received = true;
+                   func();
+                   return true;
+               }});
+        }
+    }};
+
+    for(span_size_t i = 0; i < _roundtrip_count; ++i) {
+        const auto start{std::chrono::steady_clock::now()};
+        _client->send(_msg_id, message_view{view(_content)});
+        echo(_server, [this] {
+            _server->send(_msg_id, message_view{view(_content)});
+        });
+        echo(_client, [] {});
+        roundtrips.push_back(std::chrono::steady_clock::now() - start);
+    }
+    std::sort(roundtrips.begin(), roundtrips.end());
+
+    const auto percentile{[&](float p) {
+        return std::chrono::duration<float, std::micro>(roundtrips[std::min(
+          roundtrips.size() - 1U,
+          static_cast<std::size_t>(float(roundtrips.size()) * p))]);
+    }};
+
+    log_stat("${kind}: median round-trip time ${median}")
+      .tag("lclIPCLtnc")
+      .arg("kind", kind)
+      .arg("count", _roundtrip_count)
+      .arg("size", "ByteSize", _message_size)
+      .arg("median", percentile(0.50F))
+      .arg("p90", percentile(0.90F))
+      .arg("p99", percentile(0.99F));
+}
+//------------------------------------------------------------------------------
+void local_ipc_benchmark::_run(
+  unique_holder<connection_factory> factory) noexcept {
+    if(not factory) {
+        return;
+    }
+    const auto kind{factory->type_id()};
+    if(_connect(*factory)) {
+        _measure_throughput(kind);
+        _measure_latency(kind);
+    } else {
+        log_error("failed to connect ${kind}").arg("kind", kind);
+    }
+    _server.reset();
+    _client.reset();
+    _acceptor.reset();
+}
+//------------------------------------------------------------------------------
+void local_ipc_benchmark::run() noexcept {
+    _content.resize(std_size(_message_size));
+    std::fill(_content.begin(), _content.end(), byte(0x5A));
+
+    _run(make_posix_shmem_connection_factory(*this));
+    _run(make_posix_mqueue_connection_factory(*this));
+    _run(make_asio_local_stream_connection_factory(*this));
+}
+//------------------------------------------------------------------------------
+} // namespace msgbus
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    msgbus::local_ipc_benchmark{ctx}.run();
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagine::main_ctx_options options;
+    options.app_id = "LclIPCBnch";
+    return eagine::main_impl(argc, argv, options, &eagine::main);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,792 @@
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#define EAGINE_MSGBUS_BENCHMARK_USE_RUSAGE 1
+#else
+#define EAGINE_MSGBUS_BENCHMARK_USE_RUSAGE 0
+#endif
+
+import eagine.core;
+import eagine.sslplus;
+import eagine.msgbus;
+import std;
+
+//------------------------------------------------------------------------------
+// allocation counting
+//------------------------------------------------------------------------------
+static std::atomic<std::uint64_t> benchmark_allocation_count{0U};
+
+auto operator new(std::size_t size) -> void* {
+    benchmark_allocation_count.fetch_add(1U, std::memory_order_relaxed);
+    if(void* ptr{std::malloc(size > 0U ? size : 1U)}) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace eagine {
+//------------------------------------------------------------------------------
+namespace msgbus {
+//------------------------------------------------------------------------------
+// Snapshot of the wall-clock time, process CPU time and allocation count.
+struct benchmark_usage {
+    std::chrono::steady_clock::time_point wall_time{
+      std::chrono::steady_clock::now()};
+    std::chrono::duration<double> cpu_time{cpu_time_now()};
+    std::uint64_t allocations{
+      benchmark_allocation_count.load(std::memory_order_relaxed)};
+
+    static auto cpu_time_now() noexcept -> std::chrono::duration<double> {
+#if EAGINE_MSGBUS_BENCHMARK_USE_RUSAGE
+        ::rusage usage{};
+        if(::getrusage(RUSAGE_SELF, &usage) == 0) {
+            const auto seconds{[](const ::timeval& tv) {
+                return double(tv.tv_sec) + double(tv.tv_usec) / 1'000'000.0;
+            }};
+            return std::chrono::duration<double>{
+              seconds(usage.ru_utime) + seconds(usage.ru_stime)};
+        }
+#endif
+        return {};
+    }
+};
+//------------------------------------------------------------------------------
+// Resource usage between two snapshots, per processed message.
+struct benchmark_cost {
+    std::chrono::duration<double> interval{};
+    double cpu_us_per_msg{0.0};
+    double allocs_per_msg{0.0};
+
+    benchmark_cost(
+      const benchmark_usage& start,
+      const span_size_t message_count) noexcept {
+        const benchmark_usage finish{};
+        const auto count{double(std::max(message_count, span_size_t(1)))};
+        interval = finish.wall_time - start.wall_time;
+        cpu_us_per_msg =
+          (finish.cpu_time - start.cpu_time).count() * 1'000'000.0 / count;
+        allocs_per_msg = double(finish.allocations - start.allocations) / count;
+    }
+};
+//------------------------------------------------------------------------------
+// One client-side connection and the server-side connection receiving from it.
+struct benchmark_link {
+    shared_holder<connection> client;
+    shared_holder<connection> server;
+};
+//------------------------------------------------------------------------------
+// Simulated link built from a loopback connection. Drops messages randomly
+// and the ones exceeding the capacity of a single tick (like a slow bridge).
+class benchmark_lossy_link {
+public:
+    benchmark_lossy_link(
+      const float loss,
+      const span_size_t capacity,
+      const std::uint32_t seed) noexcept
+      : _rng{seed}
+      , _drop{loss}
+      , _capacity{capacity} {}
+
+    auto send(const message_id msg_id, const message_view& message) noexcept
+      -> bool {
+        ++_sent_count;
+        _sent_bytes += message.data().size();
+        if(((_capacity > 0) and (_tick_count >= _capacity)) or _drop(_rng)) {
+            ++_dropped_count;
+            return true;
+        }
+        ++_tick_count;
+        return _loopback.send(msg_id, message);
+    }
+
+    template <typename Function>
+    void deliver(Function func) noexcept {
+        _loopback.fetch_messages(
+          {construct_from,
+           [&](
+             const message_id msg_id,
+             const message_age,
+             const message_view& message) -> bool {
+               func(msg_id, message);
+               return true;
+           }});
+        _tick_count = 0;
+    }
+
+    auto sent_count() const noexcept -> span_size_t {
+        return _sent_count;
+    }
+
+    auto sent_bytes() const noexcept -> span_size_t {
+        return _sent_bytes;
+    }
+
+    auto dropped_count() const noexcept -> span_size_t {
+        return _dropped_count;
+    }
+
+private:
+    loopback_connection _loopback;
+    std::mt19937 _rng;
+    std::bernoulli_distribution _drop;
+    const span_size_t _capacity;
+    span_size_t _tick_count{0};
+    span_size_t _sent_count{0};
+    span_size_t _sent_bytes{0};
+    span_size_t _dropped_count{0};
+};
+//------------------------------------------------------------------------------
+class message_bus_benchmark : public main_ctx_object {
+public:
+    message_bus_benchmark(main_ctx_parent parent)
+      : main_ctx_object{"MsgBusBnch", parent} {}
+
+    void run() noexcept;
+
+private:
+    void _run(
+      const identifier kind,
+      unique_holder<connection_factory> factory,
+      const bool default_address) noexcept;
+    void _run_loopback() noexcept;
+    void _run_connected(const identifier kind) noexcept;
+
+    auto _connect(connection_factory&, const bool default_address) noexcept
+      -> bool;
+    auto _pair_accepted(std::vector<shared_holder<connection>>&) noexcept
+      -> bool;
+    void _update() noexcept;
+    template <typename Function>
+    auto _receive(const span_size_t fan_out, Function func) noexcept -> bool;
+
+    void _measure_throughput(
+      const identifier kind,
+      const span_size_t size,
+      const span_size_t fan_out) noexcept;
+    void _measure_latency(const identifier kind, const span_size_t size) noexcept;
+    void _measure_signing(const span_size_t size) noexcept;
+    void _measure_storage(const span_size_t size, const bool partial) noexcept;
+    void _measure_blob_transfer(
+      const float loss,
+      const span_size_t capacity,
+      const bool windowed) noexcept;
+
+    auto _out() noexcept -> std::ostream&;
+    auto _min_size() const noexcept -> span_size_t {
+        return std::max(_min_message_size, span_size_t(1));
+    }
+
+    const span_size_t _message_count{
+      cfg_init("msgbus.benchmark.message_count", span_size_t(100'000))};
+    const span_size_t _roundtrip_count{
+      cfg_init("msgbus.benchmark.roundtrip_count", span_size_t(10'000))};
+    const span_size_t _batch_size{
+      cfg_init("msgbus.benchmark.batch_size", span_size_t(64))};
+    const span_size_t _min_message_size{
+      cfg_init("msgbus.benchmark.min_message_size", span_size_t(64))};
+    const span_size_t _max_message_size{
+      cfg_init("msgbus.benchmark.max_message_size", span_size_t(4096))};
+    const span_size_t _max_fan_out{
+      cfg_init("msgbus.benchmark.max_fan_out", span_size_t(4))};
+    const std::chrono::seconds _idle_timeout{
+      cfg_init("msgbus.benchmark.idle_timeout", std::chrono::seconds(5))};
+    const span_size_t _blob_size{
+      cfg_init("msgbus.benchmark.blob_size", span_size_t(1024 * 1024))};
+    const span_size_t _blob_burst{
+      cfg_init("msgbus.benchmark.blob_burst", span_size_t(32))};
+    const std::chrono::seconds _blob_timeout{
+      cfg_init("msgbus.benchmark.blob_timeout", std::chrono::seconds(20))};
+
+    const message_id _msg_id{"Benchmark", "MessageBus"};
+    std::vector<byte> _content;
+    std::ofstream _output_file;
+    shared_holder<acceptor> _acceptor;
+    std::vector<benchmark_link> _links;
+};
+//------------------------------------------------------------------------------
+auto message_bus_benchmark::_out() noexcept -> std::ostream& {
+    if(_output_file.is_open()) {
+        return _output_file;
+    }
+    return std::cout;
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_update() noexcept {
+    if(_acceptor) {
+        _acceptor->update();
+    }
+    for(auto& link : _links) {
+        link.client->update();
+        if(link.server) {
+            link.server->update();
+        }
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Function>
+auto message_bus_benchmark::_receive(
+  const span_size_t fan_out,
+  Function func) noexcept -> bool {
+    bool received{false};
+    // several links may share one server-side connection (datagrams)
+    std::vector<connection*> servers;
+    for(span_size_t l = 0; l < fan_out; ++l) {
+        auto* server{std::addressof(*_links[std_size(l)].server)};
+        if(std::find(servers.begin(), servers.end(), server) == servers.end()) {
+            servers.push_back(server);
+            server->fetch_messages(
+              {construct_from,
+               [&](const message_id, const message_age, const message_view& msg)
+                 -> bool {
+                   received = true;
+                   func(msg);
+                   return true;
+               }});
+        }
+    }
+    return received;
+}
+//------------------------------------------------------------------------------
+auto message_bus_benchmark::_pair_accepted(
+  std::vector<shared_holder<connection>>& accepted) noexcept -> bool {
+    // each client announces its index and the server that gets it is paired
+    for(std::size_t i = 0U; i < _links.size(); ++i) {
+        message_view message{};
+        message.set_sequence_no(message_sequence_t(i));
+        _links[i].client->send(_msg_id, message);
+    }
+    std::size_t paired{0U};
+    const timeout pair_time{std::chrono::seconds{10}};
+    while(paired < _links.size() and not pair_time) {
+        _update();
+        for(auto& server : accepted) {
+            server->update();
+            server->fetch_messages(
+              {construct_from,
+               [&](const message_id, const message_age, const message_view& msg)
+                 -> bool {
+                   const auto i{std_size(msg.sequence_no)};
+                   if(i < _links.size() and not _links[i].server) {
+                       _links[i].server = server;
+                       ++paired;
+                   }
+                   return true;
+               }});
+        }
+    }
+    std::erase_if(_links, [](const auto& link) { return not link.server; });
+    return not _links.empty();
+}
+//------------------------------------------------------------------------------
+auto message_bus_benchmark::_connect(
+  connection_factory& factory,
+  const bool default_address) noexcept -> bool {
+    const identifier address{"MsgBusBnch"};
+    _acceptor = default_address ? factory.make_acceptor()
+                                : factory.make_acceptor(address);
+    if(not _acceptor) {
+        return false;
+    }
+    for(span_size_t l = 0; l < _max_fan_out; ++l) {
+        auto client{
+          default_address ? factory.make_connector()
+                          : factory.make_connector(address)};
+        if(not client) {
+            return false;
+        }
+        _links.push_back({.client = std::move(client), .server = {}});
+    }
+
+    std::vector<shared_holder<connection>> accepted;
+    const timeout connect_time{std::chrono::seconds{5}};
+    while(accepted.size() < _links.size() and not connect_time) {
+        _update();
+        _acceptor->process_accepted(
+          {construct_from, [&](shared_holder<connection> conn) {
+               accepted.push_back(std::move(conn));
+           }});
+    }
+    return not accepted.empty() and _pair_accepted(accepted);
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_measure_throughput(
+  const identifier kind,
+  const span_size_t size,
+  const span_size_t fan_out) noexcept {
+    const auto content{head(view(_content), size)};
+    const auto expected{_message_count * fan_out};
+    std::vector<span_size_t> sent(std_size(fan_out), 0);
+    span_size_t received{0};
+
+    const benchmark_usage start{};
+    timeout idle{_idle_timeout};
+    while(received < expected and not idle) {
+        for(span_size_t l = 0; l < fan_out; ++l) {
+            auto& link_sent{sent[std_size(l)]};
+            auto& client{*_links[std_size(l)].client};
+            for(span_size_t i = 0;
+                (i < _batch_size) and (link_sent < _message_count);
+                ++i) {
+                message_view message{content};
+                message.set_sequence_no(message_sequence_t(link_sent));
+                if(not client.send(_msg_id, message)) {
+                    break;
+                }
+                ++link_sent;
+            }
+        }
+        _update();
+        if(_receive(fan_out, [&](const message_view&) { ++received; })) {
+            idle.reset();
+        }
+    }
+    const benchmark_cost cost{start, received};
+
+    log_stat("${kind}: ${msgsPerSec} messages per second")
+      .tag("msgBusThrp")
+      .arg("kind", kind)
+      .arg("size", "ByteSize", size)
+      .arg("fanOut", fan_out)
+      .arg("interval", cost.interval)
+      .arg("msgsPerSec", "RatePerSec", float(received) / cost.interval.count());
+
+    _out() << std::format(
+      R"({{"benchmark":"throughput","connection":"{}","size":{},)"
+      R"("fanOut":{},"messages":{},"lost":{},"seconds":{:.6f},)"
+      R"("msgsPerSec":{:.1f},"bytesPerSec":{:.1f},)"
+      R"("cpuUsPerMsg":{:.3f},"allocsPerMsg":{:.3f}}})",
+      kind.name().view(),
+      size,
+      fan_out,
+      received,
+      expected - received,
+      cost.interval.count(),
+      double(received) / cost.interval.count(),
+      double(received * size) / cost.interval.count(),
+      cost.cpu_us_per_msg,
+      cost.allocs_per_msg)
+           << std::endl;
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_measure_latency(
+  const identifier kind,
+  const span_size_t size) noexcept {
+    const auto content{head(view(_content), size)};
+    auto& link{_links.front()};
+    std::vector<std::chrono::duration<double, std::micro>> roundtrips;
+    roundtrips.reserve(std_size(_roundtrip_count));
+
+    const auto wait_for{[&](connection& conn) {
+        bool received{false};
+        const timeout wait_time{_idle_timeout};
+        while(not received and not wait_time) {
+            _update();
+            conn.fetch_messages(
+              {construct_from,
+               [&](const message_id, const message_age, const message_view&)
+                 -> bool {
+                   received = true;
+                   return true;
+               }});
+        }
+        return received;
+    }};
+
+    span_size_t lost{0};
+    const benchmark_usage start{};
+    for(span_size_t i = 0; i < _roundtrip_count; ++i) {
+        const auto send_time{std::chrono::steady_clock::now()};
+        link.client->send(_msg_id, message_view{content});
+        if(wait_for(*link.server)) {
+            link.server->send(_msg_id, message_view{content});
+            if(wait_for(*link.client)) {
+                roundtrips.push_back(
+                  std::chrono::steady_clock::now() - send_time);
+                continue;
+            }
+        }
+        ++lost;
+    }
+    const benchmark_cost cost{start, span_size(roundtrips.size()) * 2};
+    if(roundtrips.empty()) {
+        log_error("${kind}: no round-trips completed").arg("kind", kind);
+        return;
+    }
+    std::sort(roundtrips.begin(), roundtrips.end());
+
+    const auto percentile{[&](double p) {
+        return roundtrips[std::min(
+                            roundtrips.size() - 1U,
+                            static_cast<std::size_t>(
+                              double(roundtrips.size()) * p))]
+          .count();
+    }};
+
+    log_stat("${kind}: median round-trip time ${p50} us")
+      .tag("msgBusLtnc")
+      .arg("kind", kind)
+      .arg("size", "ByteSize", size)
+      .arg("p50", percentile(0.5))
+      .arg("p99", percentile(0.99))
+      .arg("p999", percentile(0.999));
+
+    _out() << std::format(
+      R"({{"benchmark":"latency","connection":"{}","size":{},)"
+      R"("roundtrips":{},"lost":{},"p50Us":{:.3f},"p99Us":{:.3f},)"
+      R"("p999Us":{:.3f},"cpuUsPerMsg":{:.3f},"allocsPerMsg":{:.3f}}})",
+      kind.name().view(),
+      size,
+      roundtrips.size(),
+      lost,
+      percentile(0.5),
+      percentile(0.99),
+      percentile(0.999),
+      cost.cpu_us_per_msg,
+      cost.allocs_per_msg)
+           << std::endl;
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_measure_signing(const span_size_t size) noexcept {
+    const auto ctx{make_context(*this)};
+    const auto content{head(view(_content), size)};
+    stored_message message;
+
+    const auto report{[&](string_view scheme, const benchmark_cost& cost) {
+        log_stat("${scheme}: ${msgsPerSec} signed messages per second")
+          .tag("msgBusSign")
+          .arg("scheme", scheme)
+          .arg("size", "ByteSize", size)
+          .arg("interval", cost.interval)
+          .arg(
+            "msgsPerSec",
+            "RatePerSec",
+            float(_message_count) / cost.interval.count());
+
+        _out() << std::format(
+          R"({{"benchmark":"signing","scheme":"{}","size":{},"messages":{},)"
+          R"("seconds":{:.6f},"msgsPerSec":{:.1f},"cpuUsPerMsg":{:.3f},)"
+          R"("allocsPerMsg":{:.3f}}})",
+          to_string(scheme),
+          size,
+          _message_count,
+          cost.interval.count(),
+          double(_message_count) / cost.interval.count(),
+          cost.cpu_us_per_msg,
+          cost.allocs_per_msg)
+               << std::endl;
+    }};
+
+    // the private key signature used by post_signed,
+    // without a private key the messages are stored unsigned
+    {
+        const benchmark_usage start{};
+        for(span_size_t i = 0; i < _message_count; ++i) {
+            message.crypto_flags = {};
+            if(not message.store_and_sign(content, size + 1024, *ctx, *this)) {
+                break;
+            }
+        }
+        const benchmark_cost cost{start, _message_count};
+        report(
+          message.crypto_flags.has(message_crypto_flag::asymmetric)
+            ? string_view{"asymmetric"}
+            : string_view{"none"},
+          cost);
+    }
+
+    // the MAC used by post_authenticated once the target acknowledged
+    // the session key, the key agreement needs a remote node so the cost
+    // is measured with a fixed key here
+    {
+        const std::array<byte, 32> key{};
+        const benchmark_usage start{};
+        for(span_size_t i = 0; i < _message_count; ++i) {
+            message.store_content(content);
+            if(not ctx->compute_message_mac(view(key), content)) {
+                break;
+            }
+        }
+        const benchmark_cost cost{start, _message_count};
+        report("mac", cost);
+    }
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_measure_storage(
+  const span_size_t size,
+  const bool partial) noexcept {
+    const auto content{head(view(_content), size)};
+    message_storage storage;
+    span_size_t stored{0};
+    span_size_t fetched{0};
+
+    // a partial fetch leaves every other message in the storage
+    const auto handler{[&](
+                         const message_id,
+                         const message_age,
+                         const message_view& message) noexcept {
+        if(partial and (message.sequence_no % 2U == 0U)) {
+            return false;
+        }
+        ++fetched;
+        return true;
+    }};
+    const auto fetch_rest{
+      [&](const message_id, const message_age, const message_view&) noexcept {
+          ++fetched;
+          return true;
+      }};
+
+    const benchmark_usage start{};
+    while(stored < _message_count) {
+        for(span_size_t i = 0; (i < _batch_size) and (stored < _message_count);
+            ++i) {
+            message_view message{content};
+            message.set_sequence_no(message_sequence_t(stored));
+            storage.push(_msg_id, message);
+            ++stored;
+        }
+        storage.fetch_all({construct_from, handler});
+        if(partial) {
+            // the kept messages are handled in a second pass
+            storage.fetch_all({construct_from, fetch_rest});
+        }
+    }
+    const benchmark_cost cost{start, fetched};
+    const string_view fetch_kind{partial ? "partial" : "whole"};
+
+    log_stat("${fetch}: ${msgsPerSec} stored messages per second")
+      .tag("msgBusStor")
+      .arg("fetch", fetch_kind)
+      .arg("size", "ByteSize", size)
+      .arg("interval", cost.interval)
+      .arg("allocsPerMsg", cost.allocs_per_msg)
+      .arg("msgsPerSec", "RatePerSec", float(fetched) / cost.interval.count());
+    storage.log_stats(*this);
+
+    _out() << std::format(
+      R"({{"benchmark":"storage","fetch":"{}","size":{},"messages":{},)"
+      R"("seconds":{:.6f},"msgsPerSec":{:.1f},"cpuUsPerMsg":{:.3f},)"
+      R"("allocsPerMsg":{:.3f}}})",
+      to_string(fetch_kind),
+      size,
+      fetched,
+      cost.interval.count(),
+      double(fetched) / cost.interval.count(),
+      cost.cpu_us_per_msg,
+      cost.allocs_per_msg)
+           << std::endl;
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_measure_blob_transfer(
+  const float loss,
+  const span_size_t capacity,
+  const bool windowed) noexcept {
+    const message_id blob_msg_id{"Benchmark", "Blob"};
+    const message_id fragment_msg_id{"Benchmark", "blobFrgmnt"};
+    const message_id resend_msg_id{"Benchmark", "blobResend"};
+    const message_id prepare_msg_id{"Benchmark", "blobPrpare"};
+    const message_id ack_msg_id{"Benchmark", "blobFrgAck"};
+    blob_manipulator sender{
+      *this, fragment_msg_id, resend_msg_id, prepare_msg_id, ack_msg_id};
+    blob_manipulator receiver{
+      *this, fragment_msg_id, resend_msg_id, prepare_msg_id, ack_msg_id};
+    benchmark_lossy_link s2r{loss, capacity, 1U};
+    benchmark_lossy_link r2s{loss, capacity, 2U};
+
+    auto send_s2r{[&](const message_id msg_id, const message_view& message) {
+        return s2r.send(msg_id, message);
+    }};
+    const blob_manipulator::send_handler handler_s2r{construct_from, send_s2r};
+    auto send_r2s{[&](const message_id msg_id, const message_view& message) {
+        return r2s.send(msg_id, message);
+    }};
+    const blob_manipulator::send_handler handler_r2s{construct_from, send_r2s};
+
+    bool done{false};
+    auto handle_fetch{
+      [&](const message_id, const message_age, const message_view&) -> bool {
+          done = true;
+          return true;
+      }};
+    const blob_manipulator::fetch_handler handler_fetch{
+      construct_from, handle_fetch};
+
+    std::vector<byte> blob(std_size(_blob_size), byte(0x5A));
+    sender.push_outgoing(
+      blob_msg_id,
+      1U,
+      2U,
+      blob_id_t(0U),
+      view(blob),
+      std::chrono::hours{1},
+      windowed ? blob_options{blob_option::windowed} : blob_options{},
+      message_priority::normal);
+
+    // the sender may produce several fragments per tick of the link
+    const benchmark_usage start{};
+    const timeout deadline{_blob_timeout};
+    while(not done and not deadline) {
+        sender.update(handler_s2r, _max_message_size);
+        for(span_size_t i = 0; i < _blob_burst; ++i) {
+            sender.process_outgoing(handler_s2r, _max_message_size, 1);
+        }
+        s2r.deliver([&](const message_id, const message_view& message) {
+            receiver.process_incoming(message);
+        });
+        receiver.update(handler_r2s, _max_message_size);
+        receiver.fetch_all(handler_fetch);
+        r2s.deliver([&](const message_id msg_id, const message_view& message) {
+            if(msg_id == resend_msg_id) {
+                sender.process_resend(message);
+            } else if(msg_id == ack_msg_id) {
+                sender.process_ack(message);
+            }
+        });
+    }
+    const benchmark_cost cost{start, s2r.sent_count()};
+    const string_view scheme{windowed ? "windowed" : "fixed"};
+
+    log_stat("${scheme}: ${bytesPerSec} blob bytes per second")
+      .tag("msgBusBlob")
+      .arg("scheme", scheme)
+      .arg("loss", loss)
+      .arg("capacity", capacity)
+      .arg("completed", yes_no_maybe(done))
+      .arg("interval", cost.interval)
+      .arg(
+        "bytesPerSec",
+        "RatePerSec",
+        done ? float(_blob_size) / cost.interval.count() : 0.F);
+
+    _out() << std::format(
+      R"({{"benchmark":"blob","scheme":"{}","loss":{:.3f},"capacity":{},)"
+      R"("size":{},"completed":{},"seconds":{:.6f},"bytesPerSec":{:.1f},)"
+      R"("fragments":{},"dropped":{},"feedback":{},"overhead":{:.3f},)"
+      R"("cpuUsPerMsg":{:.3f},"allocsPerMsg":{:.3f}}})",
+      to_string(scheme),
+      loss,
+      capacity,
+      _blob_size,
+      done,
+      cost.interval.count(),
+      done ? double(_blob_size) / cost.interval.count() : 0.0,
+      s2r.sent_count(),
+      s2r.dropped_count(),
+      r2s.sent_count(),
+      double(s2r.sent_bytes()) / double(std::max(_blob_size, span_size_t(1))),
+      cost.cpu_us_per_msg,
+      cost.allocs_per_msg)
+           << std::endl;
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_run_connected(const identifier kind) noexcept {
+    for(span_size_t size = _min_size(); size <= _max_message_size; size *= 4) {
+        for(span_size_t fan_out = 1; fan_out <= span_size(_links.size());
+            fan_out *= 2) {
+            _measure_throughput(kind, size, fan_out);
+        }
+        _measure_latency(kind, size);
+    }
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_run_loopback() noexcept {
+    // a loopback connection receives what it sends, the fan-out is
+    // made of independent connections
+    for(span_size_t l = 0; l < _max_fan_out; ++l) {
+        shared_holder<connection> conn{hold<loopback_connection>};
+        _links.push_back({.client = conn, .server = conn});
+    }
+    _run_connected(identifier{"Loopback"});
+    _links.clear();
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::_run(
+  const identifier kind,
+  unique_holder<connection_factory> factory,
+  const bool default_address) noexcept {
+    if(factory) {
+        if(_connect(*factory, default_address)) {
+            _run_connected(kind);
+        } else {
+            log_error("failed to connect ${kind}").arg("kind", kind);
+        }
+    }
+    _links.clear();
+    _acceptor.reset();
+}
+//------------------------------------------------------------------------------
+void message_bus_benchmark::run() noexcept {
+    std::string output_path;
+    if(main_context().config().fetch(
+         "msgbus.benchmark.output_path", output_path)) {
+        _output_file.open(output_path);
+    }
+
+    _content.resize(std_size(_max_message_size));
+    std::fill(_content.begin(), _content.end(), byte(0x5A));
+
+    _run_loopback();
+    _run(identifier{"Direct"}, make_direct_connection_factory(*this), false);
+    _run(
+      identifier{"DirectLF"},
+      make_direct_lock_free_connection_factory(*this),
+      false);
+    _run(
+      identifier{"PosixMQue"}, make_posix_mqueue_connection_factory(*this), false);
+    _run(
+      identifier{"AsioLocal"},
+      make_asio_local_stream_connection_factory(*this),
+      false);
+    _run(
+      identifier{"AsioTcpIp4"}, make_asio_tcp_ipv4_connection_factory(*this), true);
+    _run(
+      identifier{"AsioUdpIp4"}, make_asio_udp_ipv4_connection_factory(*this), true);
+
+    for(span_size_t size = _min_size(); size <= _max_message_size; size *= 4) {
+        _measure_signing(size);
+    }
+
+    // the buffer pool traffic of message_storage, the allocsPerMsg values
+    // of different revisions can be compared directly
+    for(span_size_t size = _min_size(); size <= _max_message_size; size *= 4) {
+        _measure_storage(size, false);
+        _measure_storage(size, true);
+    }
+
+    // blob transfer over simulated links, with and without congestion control
+    for(const auto capacity : {span_size_t(0), span_size_t(8)}) {
+        for(const auto loss : {0.F, 0.01F, 0.05F}) {
+            _measure_blob_transfer(loss, capacity, false);
+            _measure_blob_transfer(loss, capacity, true);
+        }
+    }
+}
+//------------------------------------------------------------------------------
+} // namespace msgbus
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    msgbus::message_bus_benchmark{ctx}.run();
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagine::main_ctx_options options;
+    options.app_id = "MsgBusBnch";
+    return eagine::main_impl(argc, argv, options, &eagine::main);
+}
+//------------------------------------------------------------------------------
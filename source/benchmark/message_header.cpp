@@ -0,0 +1,171 @@
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+import eagine.core;
+import eagine.sslplus;
+import eagine.msgbus;
+import std;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+namespace msgbus {
+//------------------------------------------------------------------------------
+class message_header_benchmark : public main_ctx_object {
+public:
+    message_header_benchmark(main_ctx_parent parent)
+      : main_ctx_object{"MsgHdrBnch", parent} {}
+
+    void run() noexcept;
+
+private:
+    template <typename Function>
+    void _measure(
+      string_view kind,
+      string_view operation,
+      Function func) noexcept;
+
+    void _portable() noexcept;
+    void _compact() noexcept;
+
+    const span_size_t _repeat_count{
+      cfg_init("msgbus.benchmark.repeat_count", span_size_t(1'000'000))};
+
+    const message_id _msg_id{"Benchmark", "MsgHeader"};
+    message_view _message{};
+    std::array<byte, 128> _buffer{};
+};
+//------------------------------------------------------------------------------
+template <typename Function>
+void message_header_benchmark::_measure(
+  string_view kind,
+  string_view operation,
+  Function func) noexcept {
+    std::size_t checksum{0U};
+    const auto start{std::chrono::steady_clock::now()};
+    for(span_size_t i = 0; i < _repeat_count; ++i) {
+        checksum += func(i);
+    }
+    const std::chrono::duration<float> interval{
+      std::chrono::steady_clock::now() - start};
+
+    log_stat("${kind} ${operation}: ${nsPerOp} ns per operation")
+      .tag("msgHdrBnch")
+      .arg("kind", kind)
+      .arg("operation", operation)
+      .arg("repeats", _repeat_count)
+      .arg("checksum", checksum)
+      .arg("interval", interval)
+      .arg("nsPerOp", interval.count() * 1e9F / float(_repeat_count))
+      .arg("opsPerSec", "RatePerSec", float(_repeat_count) / interval.count());
+}
+//------------------------------------------------------------------------------
+void message_header_benchmark::_portable() noexcept {
+    span_size_t size{0};
+    _measure("portable", "encode", [&](span_size_t i) -> std::size_t {
+        _message.set_sequence_no(message_sequence_t(i));
+        block_data_sink sink{cover(_buffer)};
+        default_serializer_backend backend{sink};
+        if(serialize_message_header(_msg_id, _message, backend)) [[likely]] {
+            size = sink.done().size();
+        }
+        return std::size_t(size);
+    });
+
+    const auto encoded{head(view(_buffer), size)};
+    stored_message dest;
+    _measure("portable", "decode", [&](span_size_t) -> std::size_t {
+        block_data_source source{encoded};
+        default_deserializer_backend backend{source};
+        identifier class_id{};
+        identifier method_id{};
+        if(deserialize_message_header(class_id, method_id, dest, backend))
+          [[likely]] {
+            return dest.sequence_no;
+        }
+        return 0U;
+    });
+
+    // without a fixed layout the header has to be parsed and rewritten
+    std::array<byte, 128> patched{};
+    _measure("portable", "patch", [&](span_size_t) -> std::size_t {
+        block_data_source source{encoded};
+        default_deserializer_backend read_backend{source};
+        identifier class_id{};
+        identifier method_id{};
+        if(deserialize_message_header(class_id, method_id, dest, read_backend))
+          [[likely]] {
+            dest.add_hop();
+            block_data_sink sink{cover(patched)};
+            default_serializer_backend write_backend{sink};
+            if(serialize_message_header(
+                 message_id{class_id, method_id},
+                 message_view{dest, {}},
+                 write_backend)) [[likely]] {
+                dest.hop_count = 0;
+                return std::size_t(sink.done().size());
+            }
+        }
+        return 0U;
+    });
+}
+//------------------------------------------------------------------------------
+void message_header_benchmark::_compact() noexcept {
+    _measure("compact", "encode", [&](span_size_t i) -> std::size_t {
+        _message.set_sequence_no(message_sequence_t(i));
+        if(compact_message_header::store(_msg_id, _message, cover(_buffer)))
+          [[likely]] {
+            return std::size_t(compact_message_header::size());
+        }
+        return 0U;
+    });
+
+    const auto encoded{head(view(_buffer), compact_message_header::size())};
+    message_info dest;
+    _measure("compact", "decode", [&](span_size_t) -> std::size_t {
+        identifier class_id{};
+        identifier method_id{};
+        if(compact_message_header::load(encoded, class_id, method_id, dest))
+          [[likely]] {
+            return dest.sequence_no;
+        }
+        return 0U;
+    });
+
+    _measure("compact", "patch", [&](span_size_t) -> std::size_t {
+        dest.add_hop();
+        compact_message_header::patch_routing(
+          head(cover(_buffer), compact_message_header::size()), dest);
+        dest.hop_count = 0;
+        return std::size_t(_buffer[2]);
+    });
+}
+//------------------------------------------------------------------------------
+void message_header_benchmark::run() noexcept {
+    _message.set_source_id(random_identifier().value());
+    _message.set_target_id(random_identifier().value());
+    _message.set_serializer_id(random_identifier());
+    _message.set_priority(message_priority::high);
+    _message.add_age(std::chrono::milliseconds{750});
+
+    _portable();
+    _compact();
+}
+//------------------------------------------------------------------------------
+} // namespace msgbus
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    msgbus::message_header_benchmark{ctx}.run();
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagine::main_ctx_options options;
+    options.app_id = "MsgHdrBnch";
+    return eagine::main_impl(argc, argv, options, &eagine::main);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+import eagine.core;
+import eagine.sslplus;
+import eagine.msgbus;
+import std;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+namespace msgbus {
+//------------------------------------------------------------------------------
+class router_update_benchmark : public main_ctx_object {
+public:
+    router_update_benchmark(main_ctx_parent parent)
+      : main_ctx_object{"RtrUpdBnch", parent} {}
+
+    void run() noexcept;
+
+private:
+    void _update() noexcept;
+    auto _connect() noexcept -> bool;
+
+    const span_size_t _message_count{
+      cfg_init("msgbus.benchmark.message_count", span_size_t(5'000'000))};
+    const span_size_t _batch_size{
+      cfg_init("msgbus.benchmark.batch_size", span_size_t(1'000))};
+    const span_size_t _message_size{
+      cfg_init("msgbus.benchmark.message_size", span_size_t(64))};
+
+    const message_id _msg_id{"Benchmark", "RtrUpdate"};
+    std::vector<byte> _content;
+    router _router{*this};
+    endpoint _sender{"Sender", *this};
+    endpoint _receiver{"Receiver", *this};
+};
+//------------------------------------------------------------------------------
+void router_update_benchmark::_update() noexcept {
+    _sender.update();
+    _router.update();
+    _receiver.update();
+}
+//------------------------------------------------------------------------------
+auto router_update_benchmark::_connect() noexcept -> bool {
+    auto acceptor{make_direct_acceptor(*this)};
+    _sender.add_connection(acceptor->make_connection());
+    _receiver.add_connection(acceptor->make_connection());
+    _router.add_acceptor(std::move(acceptor));
+
+    const timeout get_id_time{std::chrono::seconds{10}};
+    while(not(_sender.has_id() and _receiver.has_id())) {
+        if(get_id_time) {
+            return false;
+        }
+        _update();
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+void router_update_benchmark::run() noexcept {
+    _content.resize(std_size(_message_size));
+    std::fill(_content.begin(), _content.end(), byte(0x5A));
+
+    if(not _connect()) {
+        log_error("failed to get endpoint ids");
+        return;
+    }
+
+    span_size_t sent{0};
+    span_size_t received{0};
+    const auto count_received{
+      [&](const message_context&, const stored_message&) -> bool {
+          ++received;
+          return true;
+      }};
+
+    const auto start{std::chrono::steady_clock::now()};
+    while(received < _message_count) {
+        for(span_size_t i = 0; (i < _batch_size) and (sent < _message_count);
+            ++i) {
+            message_view message{view(_content)};
+            message.set_target_id(_receiver.get_id());
+            message.set_sequence_no(message_sequence_t(sent));
+            if(_sender.post(_msg_id, message)) {
+                ++sent;
+            }
+        }
+        _update();
+        _receiver.process_everything({construct_from, count_received});
+    }
+    const std::chrono::duration<float> interval{
+      std::chrono::steady_clock::now() - start};
+
+    log_stat("routed ${msgsPerSec} messages per second")
+      .tag("rtrUpdThrp")
+      .arg("count", _message_count)
+      .arg("batchSize", _batch_size)
+      .arg("size", "ByteSize", _message_size)
+      .arg("interval", interval)
+      .arg("msgsPerSec", "RatePerSec", float(received) / interval.count());
+}
+//------------------------------------------------------------------------------
+} // namespace msgbus
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    enable_message_bus(ctx);
+    msgbus::router_update_benchmark{ctx}.run();
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagine::main_ctx_options options;
+    options.app_id = "RtrUpdBnch";
+    return eagine::main_impl(argc, argv, options, &eagine::main);
+}
+//------------------------------------------------------------------------------
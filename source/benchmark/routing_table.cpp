@@ -0,0 +1,126 @@
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+import eagine.core;
+import eagine.sslplus;
+import eagine.msgbus;
+import std;
+
+namespace eagine {
+//------------------------------------------------------------------------------
+namespace msgbus {
+//------------------------------------------------------------------------------
+class routing_table_benchmark : public main_ctx_object {
+public:
+    routing_table_benchmark(main_ctx_parent parent)
+      : main_ctx_object{"RtTblBench", parent} {}
+
+    void run() noexcept;
+
+private:
+    template <typename Lookup>
+    void _measure(string_view kind, Lookup lookup) noexcept;
+
+    void _populate() noexcept;
+
+    const identifier_t _id_base{
+      cfg_init("msgbus.benchmark.id_base", identifier_t(1U) << 32U)};
+    const span_size_t _endpoint_count{
+      cfg_init("msgbus.benchmark.endpoint_count", span_size_t(4096))};
+    const span_size_t _node_count{
+      cfg_init("msgbus.benchmark.node_count", span_size_t(32))};
+    const span_size_t _lookup_count{
+      cfg_init("msgbus.benchmark.lookup_count", span_size_t(10'000'000))};
+    const float _miss_ratio{cfg_init("msgbus.benchmark.miss_ratio", 0.1F)};
+
+    std::vector<endpoint_id_t> _targets;
+    basic_routing_table<int> _table;
+    flat_map<endpoint_id_t, endpoint_id_t> _endpoint_idx;
+};
+//------------------------------------------------------------------------------
+void routing_table_benchmark::_populate() noexcept {
+    std::default_random_engine rng{std::random_device{}()};
+
+    _table.reserve(_endpoint_count);
+    for(span_size_t i = 0; i < _endpoint_count; ++i) {
+        const endpoint_id_t endpoint_id{_id_base + identifier_t(i) + 1U};
+        const endpoint_id_t node_id{_id_base + identifier_t(i % _node_count)};
+        _table[endpoint_id].route_through(node_id);
+        _endpoint_idx[endpoint_id] = node_id;
+    }
+
+    // sample the looked-up targets, some of them unknown to the table
+    std::uniform_int_distribution<span_size_t> known{1, _endpoint_count};
+    std::bernoulli_distribution is_miss{_miss_ratio};
+    _targets.resize(std_size(math::minimum(_lookup_count, span_size_t(1024 * 1024))));
+    for(auto& target : _targets) {
+        target = endpoint_id_t{
+          _id_base + identifier_t(known(rng)) +
+          (is_miss(rng) ? identifier_t(_endpoint_count) : 0U)};
+    }
+}
+//------------------------------------------------------------------------------
+template <typename Lookup>
+void routing_table_benchmark::_measure(
+  string_view kind,
+  Lookup lookup) noexcept {
+    identifier_t checksum{0};
+    span_size_t hits{0};
+    const auto start{std::chrono::steady_clock::now()};
+    for(span_size_t i = 0; i < _lookup_count; ++i) {
+        const auto target_id{_targets[std_size(i) % _targets.size()]};
+        if(const auto outgoing_id{lookup(target_id)}) {
+            checksum += outgoing_id.value();
+            ++hits;
+        }
+    }
+    const std::chrono::duration<float> interval{
+      std::chrono::steady_clock::now() - start};
+
+    log_stat("${kind}: ${lkpsPerSec} lookups per second")
+      .tag("rtTblLkps")
+      .arg("kind", kind)
+      .arg("endpoints", _endpoint_count)
+      .arg("nodes", _node_count)
+      .arg("lookups", _lookup_count)
+      .arg("hits", hits)
+      .arg("checksum", checksum)
+      .arg("interval", interval)
+      .arg("lkpsPerSec", "RatePerSec", float(_lookup_count) / interval.count());
+}
+//------------------------------------------------------------------------------
+void routing_table_benchmark::run() noexcept {
+    _populate();
+
+    _measure("routing table", [this](endpoint_id_t target_id) {
+        if(const auto entry{_table.find(target_id)}) {
+            if(entry->is_routed()) {
+                return entry->outgoing_id;
+            }
+        }
+        return endpoint_id_t{};
+    });
+
+    _measure("flat_map", [this](endpoint_id_t target_id) {
+        return find(_endpoint_idx, target_id).or_default();
+    });
+}
+//------------------------------------------------------------------------------
+} // namespace msgbus
+//------------------------------------------------------------------------------
+auto main(main_ctx& ctx) -> int {
+    msgbus::routing_table_benchmark{ctx}.run();
+    return 0;
+}
+//------------------------------------------------------------------------------
+} // namespace eagine
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    eagine::main_ctx_options options;
+    options.app_id = "RtTblBench";
+    return eagine::main_impl(argc, argv, options, &eagine::main);
+}
+//------------------------------------------------------------------------------
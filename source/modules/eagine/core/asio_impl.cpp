@@ -7,11 +7,15 @@
 ///
 module;
 
+#include <asio/bind_executor.hpp>
+#include <asio/executor_work_guard.hpp>
 #include <asio/io_context.hpp>
 #include <asio/ip/tcp.hpp>
 #include <asio/ip/udp.hpp>
 #include <asio/local/stream_protocol.hpp>
+#include <asio/post.hpp>
 #include <asio/read.hpp>
+#include <asio/strand.hpp>
 #include <asio/write.hpp>
 #include <cassert>
 
@@ -77,9 +81,30 @@ private:
 };
 //------------------------------------------------------------------------------
 struct asio_common_state {
-    asio::io_context context;
+private:
+    // the I/O threads share the ownership of the io_context, so when this
+    // state is released by a handler on one of the threads, the io_context
+    // is destroyed only after that thread returns from run()
+    const std::shared_ptr<asio::io_context> _context{
+      std::make_shared<asio::io_context>()};
+
+public:
+    asio::io_context& context{*_context};
 
     asio_common_state() = default;
+
+    // the io_context is run by a pool of dedicated I/O threads,
+    // instead of being polled from the connection update functions
+    asio_common_state(const span_size_t io_thread_count) {
+        if(io_thread_count > 0) {
+            _work.emplace(asio::make_work_guard(context));
+            for(span_size_t i = 0; i < io_thread_count; ++i) {
+                _io_threads.emplace_back(
+                  [io_context{_context}] { io_context->run(); });
+            }
+        }
+    }
+
     asio_common_state(asio_common_state&&) = delete;
     asio_common_state(const asio_common_state&) = delete;
     auto operator=(asio_common_state&&) = delete;
@@ -90,6 +115,23 @@ struct asio_common_state {
             update();
             std::this_thread::yield();
         }
+        if(is_threaded()) {
+            _work.reset();
+            context.stop();
+            for(auto& io_thread : _io_threads) {
+                if(io_thread.get_id() == std::this_thread::get_id()) {
+                    // the thread leaves run() after the current handler
+                    // and then releases the io_context
+                    io_thread.detach();
+                } else {
+                    io_thread.join();
+                }
+            }
+        }
+    }
+
+    auto is_threaded() const noexcept -> bool {
+        return not _io_threads.empty();
     }
 
     template <typename Socket>
@@ -139,6 +181,67 @@ private:
       asio_flushing_sockets<asio::ip::tcp::socket>,
       asio_flushing_sockets<asio::ip::udp::socket>>
       _flushing;
+
+    std::optional<asio::executor_work_guard<asio::io_context::executor_type>>
+      _work;
+    std::vector<std::thread> _io_threads;
+};
+//------------------------------------------------------------------------------
+// Single-producer/single-consumer queue of blocks received by the I/O thread
+// and handed over to the thread updating the connection without locking.
+// The blocks are received directly into the queue slots.
+class asio_received_blocks {
+public:
+    asio_received_blocks(
+      const span_size_t block_size,
+      const span_size_t depth) noexcept
+      : _sizes(std_size(depth)) {
+        _blocks.reserve(std_size(depth));
+        for(span_size_t i = 0; i < depth; ++i) {
+            _blocks.emplace_back(block_size, max_span_align());
+        }
+    }
+
+    auto empty() const noexcept -> bool {
+        return _head.load(std::memory_order_acquire) ==
+               _tail.load(std::memory_order_acquire);
+    }
+
+    // producer side
+    auto free_block() noexcept -> memory::block {
+        const auto tail{_tail.load(std::memory_order_relaxed)};
+        if(tail - _head.load(std::memory_order_acquire) < _blocks.size()) {
+            return cover(_blocks[tail % _blocks.size()]);
+        }
+        return {};
+    }
+
+    void publish(const span_size_t size) noexcept {
+        const auto tail{_tail.load(std::memory_order_relaxed)};
+        _sizes[tail % _sizes.size()] = size;
+        _tail.store(tail + 1U, std::memory_order_release);
+    }
+
+    // consumer side
+    template <typename Function>
+    auto fetch(const Function& func) noexcept -> work_done {
+        some_true something_done{};
+        auto pos{_head.load(std::memory_order_relaxed)};
+        const auto end{_tail.load(std::memory_order_acquire)};
+        for(; pos != end; ++pos) {
+            const auto idx{pos % _blocks.size()};
+            func(head(view(_blocks[idx]), _sizes[idx]));
+            _head.store(pos + 1U, std::memory_order_release);
+            something_done();
+        }
+        return something_done;
+    }
+
+private:
+    std::vector<memory::buffer> _blocks;
+    std::vector<span_size_t> _sizes;
+    std::atomic<std::size_t> _head{0U};
+    std::atomic<std::size_t> _tail{0U};
 };
 //------------------------------------------------------------------------------
 template <connection_addr_kind Kind, connection_protocol Proto>
@@ -149,6 +252,11 @@ struct asio_connection_group : interface<asio_connection_group<Kind, Proto>> {
     virtual auto pack_into(endpoint_type&, memory::block) noexcept
       -> message_pack_info = 0;
 
+    virtual auto gather_into(
+      endpoint_type&,
+      const span_size_t max_size,
+      std::vector<memory::const_block>&) noexcept -> message_pack_info = 0;
+
     virtual void on_sent(
       const endpoint_type&,
       const message_pack_info& to_be_removed) noexcept = 0;
@@ -159,18 +267,141 @@ struct asio_connection_group : interface<asio_connection_group<Kind, Proto>> {
 
     virtual auto has_received() noexcept -> bool = 0;
 
+    virtual auto queue_depth() noexcept -> span_size_t = 0;
+
     virtual auto self_ref() noexcept
       -> std::shared_ptr<asio_connection_base<Kind, Proto>> = 0;
 };
 //------------------------------------------------------------------------------
+class asio_batching_policy {
+public:
+    using clock_type = std::chrono::steady_clock;
+    using clock_time = typename clock_type::time_point;
+
+    asio_batching_policy(
+      const bool adaptive,
+      const span_size_t max_block_size,
+      const std::chrono::microseconds max_deadline) noexcept
+      : _max_block_size{max_block_size}
+      , _block_size{
+          adaptive ? std::min(_min_block_size, max_block_size)
+                   : max_block_size}
+      , _max_deadline{max_deadline}
+      , _adaptive{adaptive} {}
+
+    auto is_adaptive() const noexcept -> bool {
+        return _adaptive;
+    }
+
+    auto block_size() const noexcept -> span_size_t {
+        return _block_size;
+    }
+
+    auto has_pending() const noexcept -> bool {
+        return _pending_since != clock_time{};
+    }
+
+    auto should_send(
+      const message_pack_info& packed,
+      const span_size_t queue_depth,
+      const clock_time now) noexcept -> bool {
+        _has_backlog = queue_depth > packed.count();
+        if(
+          _has_backlog or (packed.max_priority() >= message_priority::high) or
+          packed.is_max_count(packed.count()) or
+          (packed.used() * 4 >= packed.total() * 3)) {
+            _pending_since = {};
+            return true;
+        }
+        if(_pending_since == clock_time{}) {
+            _pending_since = now;
+        }
+        if(now - _pending_since >= _deadline) {
+            _pending_since = {};
+            return true;
+        }
+        return false;
+    }
+
+    void on_sent(
+      const message_pack_info& packed,
+      const clock_type::duration latency) noexcept {
+        _usage = 0.8F * _usage + 0.2F * packed.usage();
+        _latency = 0.8F * _latency +
+                   0.2F * std::chrono::duration<float, std::micro>(latency);
+        if(not _adaptive) {
+            return;
+        }
+        if(_has_backlog or (_usage > 0.75F)) {
+            // heavy load, larger and denser blocks
+            _block_size = std::min(_block_size * 2, _max_block_size);
+            // waiting longer than it takes to send a block does not pay off
+            const auto max_deadline{std::min(
+              _max_deadline,
+              std::max(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                  _latency),
+                _deadline_step))};
+            _deadline = std::min(
+              std::max(_deadline * 2, _deadline_step), max_deadline);
+        } else if(_usage < 0.25F) {
+            // light load, smaller blocks sent without delay
+            _block_size = std::max(_block_size / 2, _min_block_size);
+            _deadline = _deadline < _deadline_step
+                          ? std::chrono::microseconds{0}
+                          : _deadline / 2;
+        }
+    }
+
+    void query(connection_statistics& stats) const noexcept {
+        stats.batching_policy = _adaptive ? connection_batching_policy::adaptive
+                                          : connection_batching_policy::fixed;
+        stats.block_size = limit_cast<std::int32_t>(_block_size);
+        stats.flush_deadline_us = limit_cast<std::int32_t>(_deadline.count());
+        stats.send_latency_us = std::int32_t(_latency.count());
+    }
+
+private:
+    static constexpr const span_size_t _min_block_size{512};
+    static constexpr const std::chrono::microseconds _deadline_step{50};
+    const span_size_t _max_block_size;
+    span_size_t _block_size;
+    const std::chrono::microseconds _max_deadline;
+    std::chrono::microseconds _deadline{0};
+    std::chrono::duration<float, std::micro> _latency{0.F};
+    clock_time _pending_since{};
+    float _usage{0.F};
+    bool _has_backlog{false};
+    const bool _adaptive;
+};
+//------------------------------------------------------------------------------
 struct asio_connection_state_base : main_ctx_object {
     using clock_type = std::chrono::steady_clock;
     using clock_time = typename clock_type::time_point;
 
     const shared_holder<asio_common_state> common;
+    asio::strand<asio::io_context::executor_type> strand;
+    asio_received_blocks received;
+    std::mutex readiness_lock;
+    shared_holder<connection_readiness> waiting_readiness;
     const memory::buffer push_buffer{};
     const memory::buffer read_buffer{};
     const memory::buffer write_buffer{};
+    const bool prefer_stream_framing{
+      cfg_init("msgbus.asio.stream_framing", false)};
+    const bool prefer_compact_header{
+      cfg_init("msgbus.asio.compact_header", false)};
+    std::array<byte, 4> local_preamble{};
+    std::array<byte, 4> remote_preamble{};
+    std::array<byte, 4> frame_header{};
+    std::vector<memory::const_block> gathered_blocks;
+    std::vector<asio::const_buffer> gathered_buffers;
+    asio_batching_policy batching{
+      cfg_init("msgbus.asio.adaptive_batching", false),
+      write_buffer.size(),
+      cfg_init(
+        "msgbus.asio.max_flush_deadline", std::chrono::microseconds{2000})};
+    clock_time send_block_time{};
     span_size_t total_used_size{0};
     span_size_t total_sent_size{0};
     clock_time send_start_time{clock_type::now()};
@@ -178,8 +409,20 @@ struct asio_connection_state_base : main_ctx_object {
     std::int32_t total_sent_blocks{0};
     float usage_ratio{-1.F};
     float used_per_sec{-1.F};
+    // with threaded I/O the statistics are published from the strand
+    // and read by the updating thread
+    std::mutex stats_lock;
+    connection_statistics published_stats{};
     bool is_sending{false};
     bool is_recving{false};
+    bool sent_preamble{false};
+    bool got_preamble{false};
+    std::atomic<bool> is_framed{false};
+    std::atomic<bool> recv_framed{false};
+    std::atomic<bool> is_compact{false};
+    std::atomic<bool> is_open{false};
+    std::atomic<bool> update_posted{false};
+    std::atomic<bool> send_posted{false};
 
     asio_connection_state_base(
       main_ctx_parent parent,
@@ -187,6 +430,14 @@ struct asio_connection_state_base : main_ctx_object {
       const span_size_t block_size) noexcept
       : main_ctx_object{"AsioConnSt", parent}
       , common{std::move(asio_state)}
+      , strand{asio::make_strand(common->context)}
+      , received{
+          block_size,
+          common->is_threaded()
+            ? std::max(
+                cfg_init("msgbus.asio.receive_queue_depth", span_size_t(8)),
+                span_size_t(1))
+            : span_size_t(0)}
       , push_buffer{block_size, max_span_align()}
       , read_buffer{block_size, max_span_align()}
       , write_buffer{block_size, max_span_align()} {
@@ -202,6 +453,165 @@ struct asio_connection_state_base : main_ctx_object {
           .arg("size", "ByteSize", write_buffer.size());
         log_debug("allocating read buffer of ${size}")
           .arg("size", "ByteSize", read_buffer.size());
+        publish_statistics();
+    }
+
+    // if stream framing or the compact header is enabled, the stream
+    // starts with a short preamble announcing that the side sends
+    // length-prefixed frames carrying only the used part of the block
+    // instead of whole fixed-size blocks, and/or messages with the compact
+    // header. The sender does not wait for the preamble of the peer,
+    // peers not sending one are handled as legacy peers sending whole
+    // blocks with the portable message header. Legacy peers cannot read
+    // the preamble, so the features are disabled by default and should be
+    // enabled only if all peers of the node support them.
+    static constexpr const span_size_t frame_header_size{4};
+    static constexpr const byte framing_flag{0x01U};
+    // the receiver recognizes the header format of each message,
+    // the flag is only informative.
+    static constexpr const byte compact_header_flag{0x02U};
+
+    auto is_threaded() const noexcept -> bool {
+        return common->is_threaded();
+    }
+
+    // all completion handlers of a connection run on its strand,
+    // so there is no need to synchronize the socket access
+    template <typename Handler>
+    auto on_strand(Handler handler) noexcept {
+        return asio::bind_executor(strand, std::move(handler));
+    }
+
+    auto receive_block() noexcept -> memory::block {
+        return is_threaded() ? received.free_block() : cover(read_buffer);
+    }
+
+    void publish_received(const memory::const_block data) noexcept {
+        received.publish(data.size());
+        const std::unique_lock lock{readiness_lock};
+        if(waiting_readiness) {
+            waiting_readiness->notify();
+        }
+    }
+
+    auto wants_preamble() const noexcept -> bool {
+        return prefer_stream_framing or prefer_compact_header;
+    }
+
+    auto is_preamble() const noexcept -> bool {
+        return (remote_preamble[0] == byte('E')) and
+               (remote_preamble[1] == byte('M')) and
+               (remote_preamble[2] == byte('B'));
+    }
+
+    auto make_preamble() noexcept -> memory::const_block {
+        is_framed = prefer_stream_framing;
+        is_compact = prefer_compact_header;
+        local_preamble = {
+          byte('E'),
+          byte('M'),
+          byte('B'),
+          byte(
+            (prefer_stream_framing ? framing_flag : byte(0U)) |
+            (prefer_compact_header ? compact_header_flag : byte(0U)))};
+        return view(local_preamble);
+    }
+
+    void accept_preamble() noexcept {
+        recv_framed = (remote_preamble[3] & framing_flag) == framing_flag;
+        got_preamble = true;
+        log_debug("received stream connection preamble")
+          .arg("framed", yes_no_maybe(is_framed.load()))
+          .arg("peerFramed", yes_no_maybe(recv_framed.load()))
+          .arg("peerCompact",
+            yes_no_maybe(
+              (remote_preamble[3] & compact_header_flag) ==
+              compact_header_flag));
+    }
+
+    void accept_legacy_peer() noexcept {
+        recv_framed = false;
+        got_preamble = true;
+        if(wants_preamble()) {
+            log_warning("stream connection peer did not send a preamble")
+              .arg("framed", yes_no_maybe(is_framed.load()))
+              .arg("compact", yes_no_maybe(is_compact.load()));
+        } else {
+            log_debug("stream connection peer did not send a preamble");
+        }
+    }
+
+    void reset_negotiation() noexcept {
+        sent_preamble = false;
+        got_preamble = false;
+        is_framed = false;
+        recv_framed = false;
+        is_compact = false;
+    }
+
+    auto header_format() const noexcept -> message_header_format {
+        return is_compact ? message_header_format::compact
+                          : message_header_format::portable;
+    }
+
+    void fill_statistics(connection_statistics& stats) const noexcept {
+        stats.block_usage_ratio = usage_ratio;
+        stats.bytes_per_second = used_per_sec;
+        batching.query(stats);
+        if(not is_framed) {
+            // only framed connections send blocks of the adapted size
+            stats.block_size = limit_cast<std::int32_t>(write_buffer.size());
+        }
+    }
+
+    void publish_statistics() noexcept {
+        if(is_threaded()) {
+            const std::unique_lock lock{stats_lock};
+            fill_statistics(published_stats);
+        }
+    }
+
+    void query_statistics(connection_statistics& stats) noexcept {
+        if(is_threaded()) {
+            const std::unique_lock lock{stats_lock};
+            stats.block_usage_ratio = published_stats.block_usage_ratio;
+            stats.bytes_per_second = published_stats.bytes_per_second;
+            stats.batching_policy = published_stats.batching_policy;
+            stats.block_size = published_stats.block_size;
+            stats.flush_deadline_us = published_stats.flush_deadline_us;
+            stats.send_latency_us = published_stats.send_latency_us;
+        } else {
+            fill_statistics(stats);
+        }
+    }
+
+    auto sent_size(const message_pack_info& packed) const noexcept
+      -> span_size_t {
+        return is_framed ? frame_header_size + packed.used() : packed.total();
+    }
+
+    // the frame header and the pooled serialized messages are handed
+    // to the socket as they are, without copying them into write_buffer
+    auto gather_buffers(const message_pack_info& packed) noexcept
+      -> const std::vector<asio::const_buffer>& {
+        const auto size{limit_cast<std::uint32_t>(packed.used())};
+        frame_header = {
+          byte(size & 0xFFU),
+          byte((size >> 8U) & 0xFFU),
+          byte((size >> 16U) & 0xFFU),
+          byte((size >> 24U) & 0xFFU)};
+        gathered_buffers.clear();
+        gathered_buffers.emplace_back(frame_header.data(), frame_header.size());
+        for(const auto blk : gathered_blocks) {
+            gathered_buffers.emplace_back(blk.data(), std_size(blk.size()));
+        }
+        return gathered_buffers;
+    }
+
+    auto frame_size() const noexcept -> span_size_t {
+        const auto hdr{view(read_buffer)};
+        return span_size(hdr[0]) | (span_size(hdr[1]) << 8U) |
+               (span_size(hdr[2]) << 16U) | (span_size(hdr[3]) << 24U);
     }
 };
 //------------------------------------------------------------------------------
@@ -222,7 +632,9 @@ struct asio_connection_state : asio_connection_state_base {
       asio_socket_type<Kind, Proto> sock,
       const span_size_t block_size) noexcept
       : asio_connection_state_base{parent, std::move(asio_state), block_size}
-      , socket{std::move(sock)} {}
+      , socket{std::move(sock)} {
+        is_open = socket.is_open();
+    }
 
     asio_connection_state(
       main_ctx_parent parent,
@@ -234,8 +646,36 @@ struct asio_connection_state : asio_connection_state_base {
           asio_socket_type<Kind, Proto>{asio_state->context},
           block_size} {}
 
+    // with threaded I/O the socket is opened and closed on the strand
     auto is_usable() const noexcept -> bool {
-        return common and socket.is_open();
+        return common and (is_threaded() ? is_open.load() : socket.is_open());
+    }
+
+    void mark_open() noexcept {
+        is_open = socket.is_open();
+    }
+
+    void close_socket() noexcept {
+        socket.close();
+        is_open = false;
+    }
+
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept -> bool {
+        if(is_threaded()) {
+            // the socket is watched by the I/O threads, which signal
+            // the readiness when they publish a received block
+            {
+                const std::unique_lock lock{readiness_lock};
+                waiting_readiness = readiness;
+            }
+            return received.empty();
+        }
+        if(is_usable() and not is_sending and not batching.has_pending()) {
+            readiness->watch(static_cast<int>(socket.native_handle()));
+            return true;
+        }
+        return false;
     }
 
     void do_log_usage_stats() noexcept {
@@ -262,11 +702,13 @@ struct asio_connection_state : asio_connection_state_base {
           .arg("sentPerSec", "ByteSize", sent_per_sec)
           .arg("addrKind", Kind)
           .arg("protocol", Proto)
+          .arg("framed", yes_no_maybe(is_framed.load()))
           .arg("slack", "Ratio", slack);
 
         total_used_size = 0;
         total_sent_size = 0;
         send_start_time = now;
+        publish_statistics();
     }
 
     void log_usage_stats(const span_size_t threshold = 0) noexcept {
@@ -279,18 +721,25 @@ struct asio_connection_state : asio_connection_state_base {
     void start_async_send(
       const stream_protocol_tag,
       const endpoint_type&,
-      const memory::const_block blk,
+      const message_pack_info& packed,
       Handler handler) noexcept {
-        asio::async_write(
-          socket, asio::buffer(blk.data(), blk.size()), std::move(handler));
+        if(is_framed) {
+            asio::async_write(
+              socket, gather_buffers(packed), std::move(handler));
+        } else {
+            const auto blk{view(write_buffer)};
+            asio::async_write(
+              socket, asio::buffer(blk.data(), blk.size()), std::move(handler));
+        }
     }
 
     template <typename Handler>
     void start_async_send(
       const datagram_protocol_tag,
       const endpoint_type& target,
-      const memory::const_block blk,
+      const message_pack_info&,
       Handler handler) noexcept {
+        const auto blk{view(write_buffer)};
         socket.async_send_to(
           asio::buffer(blk.data(), blk.size()), target, std::move(handler));
     }
@@ -298,7 +747,8 @@ struct asio_connection_state : asio_connection_state_base {
     void handle_send_error(const std::error_code error) noexcept {
         log_error("failed to send data: ${error}").arg("error", error.message());
         is_sending = false;
-        socket.close();
+        close_socket();
+        reset_negotiation();
     }
 
     void do_start_send(
@@ -306,23 +756,28 @@ struct asio_connection_state : asio_connection_state_base {
       const endpoint_type& target,
       const message_pack_info& packed) noexcept {
 
+        const auto size{sent_size(packed)};
+        send_block_time = clock_type::now();
         start_async_send(
           connection_protocol_tag<Proto>{},
           target,
-          view(write_buffer),
-          [this, self{group.self_ref()}, &group, target, packed](
-            const std::error_code error,
-            [[maybe_unused]] const std::size_t length) {
+          packed,
+          on_strand([this, self{group.self_ref()}, &group, target, packed, size](
+                      const std::error_code error,
+                      [[maybe_unused]] const std::size_t length) {
               if(not error) [[likely]] {
-                  assert(span_size(length) == packed.total());
+                  assert(span_size(length) == size);
+                  batching.on_sent(
+                    packed, clock_type::now() - send_block_time);
+                  publish_statistics();
                   handle_sent(group, target, packed);
               } else {
                   handle_send_error(error);
               }
-          });
+          }));
 
         total_used_size += packed.used();
-        total_sent_size += packed.total();
+        total_sent_size += size;
         total_sent_messages += packed.count();
         total_sent_blocks += 1;
 
@@ -346,11 +801,52 @@ struct asio_connection_state : asio_connection_state_base {
         return send_countdown <= priority_to_countdown(priority);
     }
 
+    auto pack_outgoing(
+      asio_connection_group<Kind, Proto>& group,
+      endpoint_type& target) noexcept -> message_pack_info {
+        if(is_framed) {
+            gathered_blocks.clear();
+            if(const auto packed{group.gather_into(
+                 target, batching.block_size(), gathered_blocks)}) {
+                return packed;
+            }
+            if(batching.block_size() < write_buffer.size()) {
+                // messages larger than the adapted block size must go out too
+                gathered_blocks.clear();
+                return group.gather_into(
+                  target, write_buffer.size(), gathered_blocks);
+            }
+            return {write_buffer.size()};
+        }
+        return group.pack_into(target, cover(write_buffer));
+    }
+
+    auto start_adaptive_send_if_needed(
+      asio_connection_group<Kind, Proto>& group) noexcept -> bool {
+        endpoint_type target{conn_endpoint};
+        const auto packed{pack_outgoing(group, target)};
+        if(not packed.is_empty()) {
+            if(batching.should_send(
+                 packed, group.queue_depth(), clock_type::now())) {
+                is_sending = true;
+                do_start_send(group, target, packed);
+                return true;
+            }
+            is_sending = false;
+            return true;
+        }
+        is_sending = false;
+        return false;
+    }
+
     auto start_send_if_needed(
       asio_connection_group<Kind, Proto>& group,
       bool force) noexcept -> bool {
+        if(batching.is_adaptive()) {
+            return start_adaptive_send_if_needed(group);
+        }
         endpoint_type target{conn_endpoint};
-        const auto packed{group.pack_into(target, cover(write_buffer))};
+        const auto packed{pack_outgoing(group, target)};
         if(force or not packed.is_empty()) {
             const auto curr_packed_count{packed.count()};
             update_send_countdown(curr_packed_count);
@@ -372,9 +868,33 @@ struct asio_connection_state : asio_connection_state_base {
         return false;
     }
 
+    void start_send_preamble(
+      asio_connection_group<Kind, Proto>& group) noexcept {
+        is_sending = true;
+        const auto preamble{make_preamble()};
+        asio::async_write(
+          socket,
+          asio::buffer(preamble.data(), preamble.size()),
+          on_strand([this, self{group.self_ref()}, &group](
+                      const std::error_code error, const std::size_t) {
+              if(not error) [[likely]] {
+                  sent_preamble = true;
+                  start_send_if_needed(group, false);
+              } else {
+                  handle_send_error(error);
+              }
+          }));
+    }
+
     auto start_send(asio_connection_group<Kind, Proto>& group) noexcept
       -> bool {
         if(not is_sending) {
+            if constexpr(Proto == connection_protocol::stream) {
+                if(wants_preamble() and not sent_preamble) [[unlikely]] {
+                    start_send_preamble(group);
+                    return true;
+                }
+            }
             return start_send_if_needed(group, false);
         }
         return true;
@@ -417,6 +937,8 @@ struct asio_connection_state : asio_connection_state_base {
         } else {
             if(error == asio::error::eof) {
                 log_debug("received end-of-file");
+            } else if(error == asio::error::operation_aborted) {
+                log_debug("receive operation cancelled");
             } else if(error == asio::error::connection_reset) {
                 log_debug("connection reset by peer");
             } else {
@@ -425,25 +947,134 @@ struct asio_connection_state : asio_connection_state_base {
             }
         }
         is_recving = false;
-        socket.close();
+        close_socket();
+        reset_negotiation();
+    }
+
+    void do_receive_preamble(
+      asio_connection_group<Kind, Proto>& group) noexcept {
+        is_recving = true;
+        asio::async_read(
+          socket,
+          asio::buffer(remote_preamble.data(), remote_preamble.size()),
+          on_strand([this, selfref{group.self_ref()}, &group](
+                      const std::error_code error, const std::size_t) {
+              if(not error) [[likely]] {
+                  if(is_preamble()) [[likely]] {
+                      accept_preamble();
+                      do_start_receive(group);
+                  } else {
+                      accept_legacy_peer();
+                      do_receive_legacy_block(group);
+                  }
+              } else {
+                  handle_receive_error({}, group, error);
+              }
+          }));
+    }
+
+    // the bytes read as preamble are the start of the first legacy block
+    void do_receive_legacy_block(
+      asio_connection_group<Kind, Proto>& group) noexcept {
+        auto blk{receive_block()};
+        if(blk.size() < span_size(remote_preamble.size())) [[unlikely]] {
+            log_error("no buffer for the first block of legacy peer");
+            is_recving = false;
+            close_socket();
+            reset_negotiation();
+            return;
+        }
+        copy(view(remote_preamble), blk);
+        const auto rest{skip(blk, span_size(remote_preamble.size()))};
+        asio::async_read(
+          socket,
+          asio::buffer(rest.data(), rest.size()),
+          on_strand([this, selfref{group.self_ref()}, &group, blk](
+                      const std::error_code error, const std::size_t length) {
+              memory::const_block rcvd{head(
+                blk, span_size(length) + span_size(remote_preamble.size()))};
+              if(not error) [[likely]] {
+                  handle_received(rcvd, group);
+              } else {
+                  handle_receive_error(rcvd, group, error);
+              }
+          }));
+    }
+
+    void do_receive_frame(
+      asio_connection_group<Kind, Proto>& group,
+      memory::block dest) noexcept {
+        is_recving = true;
+        asio::async_read(
+          socket,
+          asio::buffer(cover(read_buffer).data(), std_size(frame_header_size)),
+          on_strand([this, selfref{group.self_ref()}, &group, dest](
+                      const std::error_code error, const std::size_t) {
+              if(error) [[unlikely]] {
+                  handle_receive_error({}, group, error);
+                  return;
+              }
+              const auto size{frame_size()};
+              if(size > dest.size()) [[unlikely]] {
+                  log_error("received frame larger than the read buffer")
+                    .arg("frameSize", "ByteSize", size)
+                    .arg("bufferSize", "ByteSize", read_buffer.size());
+                  is_recving = false;
+                  close_socket();
+                  reset_negotiation();
+                  return;
+              }
+              auto blk{head(dest, size)};
+              asio::async_read(
+                socket,
+                asio::buffer(blk.data(), blk.size()),
+                on_strand([this, selfref, &group, blk](
+                            const std::error_code error,
+                            const std::size_t length) {
+                    memory::const_block rcvd{head(blk, span_size(length))};
+                    if(not error) [[likely]] {
+                        handle_received(rcvd, group);
+                    } else {
+                        handle_receive_error(rcvd, group, error);
+                    }
+                }));
+          }));
     }
 
     void do_start_receive(asio_connection_group<Kind, Proto>& group) noexcept {
-        auto blk = cover(read_buffer);
+        if constexpr(Proto == connection_protocol::stream) {
+            if(not got_preamble) [[unlikely]] {
+                do_receive_preamble(group);
+                return;
+            }
+        }
+        auto blk{receive_block()};
+        if(not blk) [[unlikely]] {
+            // the received queue is full, the receiving is resumed
+            // when the updating thread fetches some of the blocks
+            is_recving = false;
+            return;
+        }
+        if constexpr(Proto == connection_protocol::stream) {
+            if(recv_framed) {
+                do_receive_frame(group, blk);
+                return;
+            }
+        }
 
         is_recving = true;
         do_start_receive(
           connection_protocol_tag<Proto>{},
           blk,
-          [this, selfref{group.self_ref()}, &group, blk](
-            const std::error_code error, const std::size_t length) {
+          on_strand([this, selfref{group.self_ref()}, &group, blk](
+                      const std::error_code error, const std::size_t length) {
               memory::const_block rcvd{head(blk, span_size(length))};
               if(not error) [[likely]] {
                   handle_received(rcvd, group);
               } else {
                   handle_receive_error(rcvd, group, error);
               }
-          });
+          }));
     }
 
     auto start_receive(asio_connection_group<Kind, Proto>& group) noexcept
@@ -451,18 +1082,33 @@ struct asio_connection_state : asio_connection_state_base {
         if(not is_recving) {
             do_start_receive(group);
         }
-        return group.has_received();
+        // with threaded I/O the received blocks are picked up by update
+        return not is_threaded() and group.has_received();
     }
 
     void handle_received(
       const memory::const_block data,
       asio_connection_group<Kind, Proto>& group) noexcept {
-        group.on_received(conn_endpoint, data);
+        if(is_threaded()) {
+            publish_received(data);
+        } else {
+            group.on_received(conn_endpoint, data);
+        }
         do_start_receive(group);
     }
 
+    auto fetch_received(asio_connection_group<Kind, Proto>& group) noexcept
+      -> work_done {
+        return received.fetch([&](const memory::const_block data) {
+            group.on_received(conn_endpoint, data);
+        });
+    }
+
     auto update() noexcept -> work_done {
         some_true something_done{};
+        if(is_threaded()) {
+            return something_done;
+        }
         if(const auto count{common->context.poll()}) {
             something_done();
         } else {
@@ -471,7 +1117,48 @@ struct asio_connection_state : asio_connection_state_base {
         return something_done;
     }
 
+    // with threaded I/O, the socket is accessed only from the strand
+    // and the updating thread just picks up the received blocks
+    template <typename Function>
+    auto update(
+      asio_connection_group<Kind, Proto>& group,
+      Function io_update) noexcept -> work_done {
+        if(is_threaded()) {
+            const auto something_done{fetch_received(group)};
+            if(not update_posted.exchange(true)) {
+                asio::post(
+                  strand, [this, selfref{group.self_ref()}, io_update]() {
+                      update_posted = false;
+                      io_update();
+                  });
+            }
+            return something_done;
+        }
+        some_true something_done{io_update()};
+        something_done(update());
+        return something_done;
+    }
+
+    void post_send(asio_connection_group<Kind, Proto>& group) noexcept {
+        if(is_threaded() and not send_posted.exchange(true)) {
+            asio::post(strand, [this, selfref{group.self_ref()}, &group]() {
+                send_posted = false;
+                if(socket.is_open()) {
+                    start_send(group);
+                }
+            });
+        }
+    }
+
     void cleanup(asio_connection_group<Kind, Proto>& group) noexcept {
+        if(is_threaded()) {
+            asio::post(strand, [this, selfref{group.self_ref()}]() {
+                log_usage_stats();
+                // cancels the pending receive and releases its handler
+                close_socket();
+            });
+            return;
+        }
         log_usage_stats();
         const timeout too_long{std::chrono::seconds{5}};
         while(is_usable() and start_send(group) and not too_long) {
@@ -555,23 +1242,35 @@ public:
     using base::conn_state;
 
     auto update() noexcept -> work_done override {
-        some_true something_done{};
-        if(conn_state().socket.is_open()) [[likely]] {
-            something_done(conn_state().start_receive(*this));
-            something_done(conn_state().start_send(*this));
-        }
-        something_done(conn_state().update());
-        return something_done;
+        return conn_state().update(*this, [this]() -> work_done {
+            some_true something_done{};
+            if(conn_state().socket.is_open()) [[likely]] {
+                something_done(conn_state().start_receive(*this));
+                something_done(conn_state().start_send(*this));
+            }
+            return something_done;
+        });
     }
 
     auto pack_into(endpoint_type&, memory::block data) noexcept
       -> message_pack_info final {
+        const std::unique_lock lock{_outgoing_lock};
         return _outgoing.pack_into(data);
     }
 
+    auto gather_into(
+      endpoint_type&,
+      const span_size_t max_size,
+      std::vector<memory::const_block>& dest) noexcept
+      -> message_pack_info final {
+        const std::unique_lock lock{_outgoing_lock};
+        return _outgoing.gather_into(max_size, dest);
+    }
+
     void on_sent(
       const endpoint_type&,
       const message_pack_info& to_be_removed) noexcept final {
+        const std::unique_lock lock{_outgoing_lock};
         return _outgoing.cleanup(to_be_removed);
     }
 
@@ -584,6 +1283,11 @@ public:
         return not _incoming.empty();
     }
 
+    auto queue_depth() noexcept -> span_size_t final {
+        const std::unique_lock lock{_outgoing_lock};
+        return _outgoing.count();
+    }
+
     auto self_ref() noexcept
       -> std::shared_ptr<asio_connection_base<Kind, Proto>> final {
         return this->shared_from_this();
@@ -591,8 +1295,18 @@ public:
 
     auto send(const message_id msg_id, const message_view& message) noexcept
       -> bool final {
-        return _outgoing.enqueue(
-          *this, msg_id, message, cover(conn_state().push_buffer));
+        bool result{false};
+        {
+            const std::unique_lock lock{_outgoing_lock};
+            result = _outgoing.enqueue(
+              *this,
+              msg_id,
+              message,
+              cover(conn_state().push_buffer),
+              conn_state().header_format());
+        }
+        conn_state().post_send(*this);
+        return result;
     }
 
     auto fetch_messages(const connection::fetch_handler handler) noexcept
@@ -600,10 +1314,31 @@ public:
         return _incoming.fetch_messages(*this, handler);
     }
 
+    auto fetch_serialized(
+      const connection::fetch_serialized_handler handler) noexcept
+      -> work_done final {
+        return _incoming.fetch_serialized(*this, handler);
+    }
+
+    auto send_serialized(
+      const message_id msg_id,
+      const message_view& message,
+      const shared_serialized_message& serialized) noexcept -> bool final {
+        if(serialized and conn_state().is_compact) {
+            if(const auto shared{serialized.share()}) [[likely]] {
+                {
+                    const std::unique_lock lock{_outgoing_lock};
+                    _outgoing.enqueue_shared(shared, message.priority);
+                }
+                conn_state().post_send(*this);
+                return true;
+            }
+        }
+        return send(msg_id, message);
+    }
+
     auto query_statistics(connection_statistics& stats) noexcept -> bool final {
-        auto& state = conn_state();
-        stats.block_usage_ratio = state.usage_ratio;
-        stats.bytes_per_second = state.used_per_sec;
+        conn_state().query_statistics(stats);
         return true;
     }
 
@@ -611,15 +1346,31 @@ public:
         return 1.1F;
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        if(conn_state().is_threaded() and queue_depth() > 0) {
+            return false;
+        }
+        return conn_state().prepare_wait(readiness);
+    }
+
     void cleanup() noexcept final {
         const timeout too_long{std::chrono::seconds{5}};
-        while(not _outgoing.empty() and not too_long) {
-            if(conn_state().socket.is_open()) {
-                if(not conn_state().start_send(*this)) {
-                    break;
+        if(conn_state().is_threaded()) {
+            while(queue_depth() > 0 and not too_long) {
+                update();
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        } else {
+            while(not _outgoing.empty() and not too_long) {
+                if(conn_state().socket.is_open()) {
+                    if(not conn_state().start_send(*this)) {
+                        break;
+                    }
                 }
+                conn_state().update();
             }
-            conn_state().update();
         }
         conn_state().cleanup(*this);
         _outgoing.log_stats(*this);
@@ -627,6 +1378,7 @@ public:
     }
 
 private:
+    std::mutex _outgoing_lock;
     connection_outgoing_messages _outgoing{};
     connection_incoming_messages _incoming{};
 };
@@ -679,9 +1431,7 @@ public:
     }
 
     auto query_statistics(connection_statistics& stats) noexcept -> bool final {
-        auto& state = conn_state();
-        stats.block_usage_ratio = state.usage_ratio;
-        stats.bytes_per_second = state.used_per_sec;
+        conn_state().query_statistics(stats);
         return true;
     }
 
@@ -689,6 +1439,12 @@ public:
         return 1.0F;
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        return conn_state().prepare_wait(readiness);
+    }
+
     auto update() noexcept -> work_done final {
         some_true something_done{};
         something_done(conn_state().update());
@@ -743,6 +1499,14 @@ public:
         return {0};
     }
 
+    auto gather_into(
+      endpoint_type&,
+      const span_size_t,
+      std::vector<memory::const_block>&) noexcept -> message_pack_info final {
+        unreachable();
+        return {0};
+    }
+
     void on_sent(
       const endpoint_type& ep,
       const message_pack_info& to_be_removed) noexcept final {
@@ -768,6 +1532,16 @@ public:
         return false;
     }
 
+    auto queue_depth() noexcept -> span_size_t final {
+        span_size_t result{0};
+        for(const auto& p : _current) {
+            const auto& outgoing = std::get<0>(std::get<1>(p));
+            assert(outgoing);
+            result += outgoing->count();
+        }
+        return result;
+    }
+
     auto self_ref() noexcept -> std::shared_ptr<
       asio_connection_base<Kind, connection_protocol::datagram>> final {
         return this->shared_from_this();
@@ -917,19 +1691,20 @@ public:
       , _addr{parse_ipv4_addr(addr_str)} {}
 
     auto update() noexcept -> work_done final {
-        some_true something_done{};
-        if(conn_state().socket.is_open()) [[likely]] {
-            something_done(conn_state().start_receive(*this));
-            something_done(conn_state().start_send(*this));
-        } else if(not _connecting) {
-            if(_should_reconnect) {
-                _should_reconnect.reset();
-                _start_resolve();
-                something_done();
+        return conn_state().update(*this, [this]() -> work_done {
+            some_true something_done{};
+            if(conn_state().socket.is_open()) [[likely]] {
+                something_done(conn_state().start_receive(*this));
+                something_done(conn_state().start_send(*this));
+            } else if(not _connecting) {
+                if(_should_reconnect) {
+                    _should_reconnect.reset();
+                    _start_resolve();
+                    something_done();
+                }
             }
-        }
-        something_done(conn_state().update());
-        return something_done;
+            return something_done;
+        });
     }
 
 private:
@@ -952,12 +1727,13 @@ private:
 
         conn_state().socket.async_connect(
           ep,
-          [this, selfref{self_ref()}, resolved, port](
-            const std::error_code error) mutable {
+          conn_state().on_strand([this, selfref{self_ref()}, resolved, port](
+                                   const std::error_code error) mutable {
               if(not error) {
                   this->log_debug("connected on address ${host}:${port}")
                     .arg("host", "IpV4Host", std::get<0>(_addr))
                     .arg("port", "IpV4Port", std::get<1>(_addr));
+                  conn_state().mark_open();
                   this->_connecting = false;
               } else {
                   if(++resolved != asio::ip::tcp::resolver::iterator{}) {
@@ -974,7 +1750,7 @@ private:
                       this->_connecting = false;
                   }
               }
-          });
+          }));
     }
 
     void _start_resolve() noexcept {
@@ -983,7 +1759,8 @@ private:
         _resolver.async_resolve(
           asio::string_view(host.data(), integer(host.size())),
           {},
-          [this, port{port}](const std::error_code error, auto resolved) {
+          conn_state().on_strand([this, selfref{self_ref()}, port{port}](
+                                   const std::error_code error, auto resolved) {
               if(not error) {
                   this->_start_connect(resolved, port);
               } else {
@@ -991,7 +1768,7 @@ private:
                     .arg("error", error.message());
                   this->_connecting = false;
               }
-          });
+          }));
     }
 };
 //------------------------------------------------------------------------------
@@ -1029,10 +1806,12 @@ public:
             _start_accept();
             something_done();
         }
-        if(this->_asio_state->context.poll()) {
-            something_done();
-        } else {
-            this->_asio_state->context.reset();
+        if(not _asio_state->is_threaded()) {
+            if(this->_asio_state->context.poll()) {
+                something_done();
+            } else {
+                this->_asio_state->context.reset();
+            }
         }
         return something_done;
     }
@@ -1040,6 +1819,7 @@ public:
     auto process_accepted(const accept_handler handler) noexcept
       -> work_done final {
         some_true something_done{};
+        const std::unique_lock lock{_accepted_lock};
         for(auto& socket : _accepted) {
             handler[{
               hold<asio_connection<
@@ -1055,6 +1835,21 @@ public:
         return something_done;
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        const std::unique_lock lock{_accepted_lock};
+        if(_acceptor.is_open() and _accepted.empty()) {
+            if(_asio_state->is_threaded()) {
+                _readiness = readiness;
+            } else {
+                readiness->watch(static_cast<int>(_acceptor.native_handle()));
+            }
+            return true;
+        }
+        return false;
+    }
+
 private:
     const shared_holder<asio_common_state> _asio_state;
     const std::tuple<std::string, ipv4_port> _addr;
@@ -1062,7 +1857,17 @@ private:
     asio::ip::tcp::socket _socket;
     const span_size_t _block_size;
 
+    std::mutex _accepted_lock;
     std::vector<asio::ip::tcp::socket> _accepted;
+    shared_holder<connection_readiness> _readiness;
+
+    void _add_accepted(asio::ip::tcp::socket socket) noexcept {
+        const std::unique_lock lock{_accepted_lock};
+        _accepted.emplace_back(std::move(socket));
+        if(_readiness) {
+            _readiness->notify();
+        }
+    }
 
     auto self_ref() noexcept {
         return this->shared_from_this();
@@ -1080,7 +1885,7 @@ private:
                   log_debug("accepted connection on address ${host}:${port}")
                     .arg("host", "IpV4Host", std::get<0>(_addr))
                     .arg("port", "IpV4Port", std::get<1>(_addr));
-                  this->_accepted.emplace_back(std::move(this->_socket));
+                  this->_add_accepted(std::move(this->_socket));
               } else {
                   log_error(
                     "failed to accept connection on address "
@@ -1171,6 +1976,7 @@ private:
         auto& ep = conn_state().conn_endpoint = *resolved;
         ep.port(port);
         conn_state().socket.open(ep.protocol());
+        conn_state().mark_open();
         this->_establishing = false;
 
         this->log_debug("resolved address ${host}:${port}")
@@ -1230,6 +2036,12 @@ public:
         return _conn.process_accepted(handler);
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        return _conn.conn_state().prepare_wait(readiness);
+    }
+
 private:
     const shared_holder<asio_common_state> _asio_state;
     const std::tuple<std::string, ipv4_port> _addr;
@@ -1285,19 +2097,20 @@ public:
     }
 
     auto update() noexcept -> work_done final {
-        some_true something_done{};
-        if(conn_state().socket.is_open()) [[likely]] {
-            something_done(conn_state().start_receive(*this));
-            something_done(conn_state().start_send(*this));
-        } else if(not _connecting) {
-            if(_should_reconnect) {
-                _should_reconnect.reset();
-                _start_connect();
-                something_done();
+        return conn_state().update(*this, [this]() -> work_done {
+            some_true something_done{};
+            if(conn_state().socket.is_open()) [[likely]] {
+                something_done(conn_state().start_receive(*this));
+                something_done(conn_state().start_send(*this));
+            } else if(not _connecting) {
+                if(_should_reconnect) {
+                    _should_reconnect.reset();
+                    _start_connect();
+                    something_done();
+                }
             }
-        }
-        something_done(conn_state().update());
-        return something_done;
+            return something_done;
+        });
     }
 
 private:
@@ -1316,17 +2129,19 @@ private:
 
         conn_state().socket.async_connect(
           conn_state().conn_endpoint,
-          [this, selfref{self_ref()}](const std::error_code error) mutable {
-              if(not error) {
-                  this->log_debug("connected on address ${address}")
-                    .arg("address", "FsPath", _addr_str);
-                  _connecting = false;
-              } else {
-                  this->log_error("failed to connect: ${error}")
-                    .arg("error", error.message());
-                  _connecting = false;
-              }
-          });
+          conn_state().on_strand(
+            [this, selfref{self_ref()}](const std::error_code error) mutable {
+                if(not error) {
+                    this->log_debug("connected on address ${address}")
+                      .arg("address", "FsPath", _addr_str);
+                    conn_state().mark_open();
+                    _connecting = false;
+                } else {
+                    this->log_error("failed to connect: ${error}")
+                      .arg("error", error.message());
+                    _connecting = false;
+                }
+            }));
     }
 
     static auto _fix_addr(const string_view addr_str) noexcept -> string_view {
@@ -1382,10 +2197,12 @@ public:
             _start_accept();
             something_done();
         }
-        if(this->_asio_state->context.poll()) {
-            something_done();
-        } else {
-            this->_asio_state->context.reset();
+        if(not _asio_state->is_threaded()) {
+            if(this->_asio_state->context.poll()) {
+                something_done();
+            } else {
+                this->_asio_state->context.reset();
+            }
         }
         return something_done;
     }
@@ -1393,6 +2210,7 @@ public:
     auto process_accepted(const accept_handler handler) noexcept
       -> work_done final {
         some_true something_done{};
+        const std::unique_lock lock{_accepted_lock};
         for(auto& socket : _accepted) {
             handler[{
               hold<asio_connection<
@@ -1408,14 +2226,39 @@ public:
         return something_done;
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        const std::unique_lock lock{_accepted_lock};
+        if(_acceptor.is_open() and _accepted.empty()) {
+            if(_asio_state->is_threaded()) {
+                _readiness = readiness;
+            } else {
+                readiness->watch(static_cast<int>(_acceptor.native_handle()));
+            }
+            return true;
+        }
+        return false;
+    }
+
 private:
     const shared_holder<asio_common_state> _asio_state;
     std::string _addr_str;
     asio::local::stream_protocol::acceptor _acceptor;
     const span_size_t _block_size;
-    bool _accepting{false};
+    std::atomic<bool> _accepting{false};
 
+    std::mutex _accepted_lock;
     std::vector<asio::local::stream_protocol::socket> _accepted;
+    shared_holder<connection_readiness> _readiness;
+
+    void _add_accepted(asio::local::stream_protocol::socket socket) noexcept {
+        const std::unique_lock lock{_accepted_lock};
+        _accepted.emplace_back(std::move(socket));
+        if(_readiness) {
+            _readiness->notify();
+        }
+    }
 
     auto self_ref() noexcept {
         return this->shared_from_this();
@@ -1440,7 +2283,7 @@ private:
             } else {
                 this->log_debug("accepted connection on address ${address}")
                   .arg("address", "FsPath", _addr_str);
-                this->_accepted.emplace_back(std::move(socket));
+                this->_add_accepted(std::move(socket));
             }
             _start_accept();
         });
@@ -1486,7 +2329,15 @@ public:
     asio_connection_factory(
       main_ctx_parent parent,
       const span_size_t block_size) noexcept
-      : asio_connection_factory{parent, default_selector, block_size} {}
+      : main_ctx_object{"AsioConnFc", parent}
+      , _asio_state{hold<asio_common_state>, _io_thread_count()}
+      , _block_size{block_size} {
+        if(_asio_state->is_threaded()) {
+            log_info("using ${count} asio I/O threads")
+              .tag("asioIOThrd")
+              .arg("count", _io_thread_count());
+        }
+    }
 
     asio_connection_factory(main_ctx_parent parent) noexcept
       : asio_connection_factory{parent, default_block_size()} {}
@@ -1514,6 +2365,18 @@ public:
 private:
     const shared_holder<asio_common_state> _asio_state;
 
+    auto _io_thread_count() noexcept -> span_size_t {
+        // datagram connections share the per-endpoint queues
+        // with the accepted connections and are always polled
+        if constexpr(Proto == connection_protocol::stream) {
+            return app_config()
+              .get<span_size_t>("msgbus.asio.io_threads")
+              .value_or(0);
+        } else {
+            return 0;
+        }
+    }
+
     template <connection_addr_kind K, connection_protocol P>
     static constexpr auto _default_block_size(
       const connection_addr_kind_tag<K>,
@@ -17,6 +17,7 @@ import eagine.core.memory;
 import eagine.core.identifier;
 import eagine.core.valid_if;
 import eagine.core.utility;
+import eagine.core.container;
 import eagine.core.main_ctx;
 import :types;
 import :message;
@@ -226,14 +227,186 @@ export auto make_target_blob_chunk_io(
   blob_stream_signals& sigs,
   memory::buffer_pool& buffers) -> unique_holder<target_blob_io>;
 //------------------------------------------------------------------------------
+/// @brief Tracks a set of disjoint byte ranges of a BLOB.
+/// @ingroup msgbus
+///
+/// Overlapping and adjacent ranges are coalesced when merged. Merging a range
+/// takes logarithmic time in the number of tracked ranges plus the number of
+/// ranges that it absorbs, and the nodes of absorbed ranges are recycled.
+export class blob_fragment_tracker {
+public:
+    /// @brief Alias for the handler called for the sub-ranges of a merged range.
+    /// @see merge
+    ///
+    /// Called in order with the begin, end offsets and an indication
+    /// whether the sub-range was already present in the tracked set.
+    using merge_handler = callable_ref<
+      bool(const span_size_t, const span_size_t, const bool) noexcept>;
+
+    /// @brief Indicates if there are no tracked ranges.
+    auto empty() const noexcept -> bool {
+        return _ranges.empty();
+    }
+
+    /// @brief Returns the number of disjoint tracked ranges.
+    auto size() const noexcept -> span_size_t {
+        return span_size(_ranges.size());
+    }
+
+    /// @brief Returns the total number of bytes in the tracked ranges.
+    auto covered_size() const noexcept -> span_size_t {
+        return _covered_size;
+    }
+
+    /// @brief Removes all tracked ranges.
+    void clear() noexcept;
+
+    /// @brief Returns the begin and end offset of the first range.
+    /// @pre not empty()
+    auto front() const noexcept -> std::tuple<span_size_t, span_size_t> {
+        assert(not empty());
+        const auto& [bgn, end] = *_ranges.begin();
+        return {bgn, end};
+    }
+
+    /// @brief Returns the begin and end offset of the last range.
+    /// @pre not empty()
+    auto back() const noexcept -> std::tuple<span_size_t, span_size_t> {
+        assert(not empty());
+        const auto& [bgn, end] = *_ranges.rbegin();
+        return {bgn, end};
+    }
+
+    /// @brief Returns the begin offset of the second range if any.
+    auto second_begin() const noexcept -> std::optional<span_size_t> {
+        if(_ranges.size() > 1U) {
+            return {std::next(_ranges.begin())->first};
+        }
+        return {};
+    }
+
+    /// @brief Replaces the tracked ranges with the specified single range.
+    /// The range may be empty, in which case its end can be set later.
+    /// @see set_back_end
+    void assign(const span_size_t bgn, const span_size_t end) noexcept;
+
+    /// @brief Merges the specified range into the tracked set.
+    auto merge(const span_size_t bgn, const span_size_t end) noexcept -> bool;
+
+    /// @brief Merges the specified range calling handler for its sub-ranges.
+    auto merge(
+      const span_size_t bgn,
+      const span_size_t end,
+      const merge_handler handler) noexcept -> bool;
+
+    /// @brief Removes the specified number of bytes from the start of the last range.
+    /// @pre not empty()
+    void consume_back(const span_size_t size) noexcept;
+
+    /// @brief Sets the end offset of the last range.
+    /// @pre not empty()
+    void set_back_end(const span_size_t end) noexcept;
+
+    /// @brief Iteration over the begin/end pairs of the tracked ranges.
+    auto begin() const noexcept {
+        return _ranges.begin();
+    }
+
+    /// @brief Iteration over the begin/end pairs of the tracked ranges.
+    auto end() const noexcept {
+        return _ranges.end();
+    }
+
+private:
+    using _range_map = std::map<span_size_t, span_size_t>;
+
+    void _insert(const span_size_t bgn, const span_size_t end) noexcept;
+
+    _range_map _ranges;
+    std::vector<_range_map::node_type> _spare_nodes;
+    span_size_t _covered_size{0};
+};
+//------------------------------------------------------------------------------
+/// @brief Congestion window and round-trip time estimate for a blob target.
+/// @see blob_option::windowed
+///
+/// The window grows by the acknowledged size (slow start) until it reaches
+/// the threshold and then by about one fragment per round-trip. On loss
+/// both the threshold and the window are halved, at most once per round-trip.
+class blob_flow_control {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    auto window_size() const noexcept -> span_size_t {
+        return _window;
+    }
+
+    auto round_trip_time() const noexcept -> clock_type::duration {
+        return _srtt;
+    }
+
+    auto retransmit_timeout() const noexcept -> clock_type::duration {
+        return _rto;
+    }
+
+    auto can_send(
+      const span_size_t in_flight,
+      const span_size_t fragment_size) noexcept -> bool;
+
+    void handle_acknowledged(const span_size_t acked_size) noexcept;
+    void handle_round_trip(const clock_type::duration sample) noexcept;
+    auto handle_loss(
+      const clock_type::time_point now,
+      const bool timed_out) noexcept -> bool;
+
+    void mark_used() noexcept {
+        _idle_time.reset();
+    }
+
+    auto is_idle() const noexcept -> bool {
+        return _idle_time.is_expired();
+    }
+
+private:
+    span_size_t _fragment_size{0};
+    span_size_t _window{0};
+    span_size_t _threshold{std::numeric_limits<span_size_t>::max()};
+    clock_type::duration _srtt{};
+    clock_type::duration _rttvar{};
+    clock_type::duration _rto{std::chrono::seconds{1}};
+    clock_type::time_point _recovery_end{};
+    timeout _idle_time{std::chrono::minutes{1}};
+    bool _has_round_trip{false};
+};
+//------------------------------------------------------------------------------
+struct blob_sent_fragment {
+    span_size_t end{0};
+    blob_flow_control::clock_type::time_point sent_time{};
+    std::uint64_t sequence{0U};
+    bool retransmitted{false};
+};
+//------------------------------------------------------------------------------
 struct pending_blob {
+    using clock_type = blob_flow_control::clock_type;
+
     message_id msg_id{};
     blob_info info{};
     shared_holder<source_blob_io> source_io{};
     shared_holder<target_blob_io> target_io{};
-    // TODO: recycle the done parts vectors?
-    double_buffer<std::vector<std::tuple<span_size_t, span_size_t>>>
-      fragment_parts{};
+    blob_fragment_tracker done_fragments{};
+    blob_fragment_tracker todo_fragments{};
+    // windowed sending: done_fragments holds the acknowledged ranges,
+    // sent_fragments the ranges sent at least once and in_flight
+    // the sent fragments that were not acknowledged yet
+    blob_fragment_tracker sent_fragments{};
+    std::map<span_size_t, blob_sent_fragment> in_flight{};
+    span_size_t in_flight_size{0};
+    std::uint64_t sent_sequence{0U};
+    std::uint64_t acked_sequence{0U};
+    // retransmit timeouts before the first acknowledgement
+    span_size_t unacked_timeouts{0};
+    // windowed receiving: fragments received since the last acknowledgement
+    blob_fragment_tracker unacked_fragments{};
     std::chrono::steady_clock::time_point latest_update{};
     timeout linger_time{std::chrono::seconds{15}};
     timeout prepare_update_time{std::chrono::seconds{5}};
@@ -247,21 +420,27 @@ struct pending_blob {
     auto target_buffer_io() noexcept -> buffer_blob_io*;
 
     auto done_parts() const noexcept -> const auto& {
-        return fragment_parts.current();
+        return done_fragments;
     }
 
     auto done_parts() noexcept -> auto& {
-        return fragment_parts.current();
+        return done_fragments;
     }
 
     auto todo_parts() const noexcept -> const auto& {
-        return fragment_parts.next();
+        return todo_fragments;
     }
 
     auto todo_parts() noexcept -> auto& {
-        return fragment_parts.next();
+        return todo_fragments;
+    }
+
+    auto is_windowed() const noexcept -> bool {
+        return info.options.has(blob_option::windowed);
     }
 
+    void drop_windowed() noexcept;
+
     auto sent_size() const noexcept -> span_size_t;
     auto received_size() const noexcept -> span_size_t;
     auto total_size() const noexcept -> span_size_t;
@@ -271,6 +450,7 @@ struct pending_blob {
     auto prepare() noexcept -> blob_preparation_result;
     auto sent_everything() const noexcept -> bool;
     auto received_everything() const noexcept -> bool;
+    auto acknowledged_everything() const noexcept -> bool;
 
     auto fetch(const span_size_t offs, memory::block dst) noexcept;
     auto store(const span_size_t offs, const memory::const_block src) noexcept;
@@ -282,6 +462,19 @@ struct pending_blob {
       const span_size_t bgn,
       const memory::const_block) noexcept -> bool;
     void merge_resend_request(const span_size_t bgn, span_size_t end) noexcept;
+    auto merge_acknowledged(
+      const span_size_t bgn,
+      const span_size_t end,
+      const clock_type::time_point now) noexcept
+      -> std::tuple<span_size_t, std::optional<clock_type::duration>>;
+    void add_in_flight(
+      const span_size_t bgn,
+      const span_size_t end,
+      const clock_type::time_point now) noexcept;
+    auto take_lost(
+      const clock_type::time_point now,
+      const clock_type::duration timeout) noexcept
+      -> std::tuple<span_size_t, bool>;
     void handle_target_preparing(float) noexcept;
 };
 //------------------------------------------------------------------------------
@@ -293,6 +486,19 @@ public:
       message_id resend_msg_id,
       message_id prepare_msg_id) noexcept;
 
+    /// @brief Construction with a message id for fragment acknowledgements.
+    /// Blobs with the windowed option are sent in a congestion window and
+    /// acknowledged only by manipulators constructed with this constructor.
+    /// Broadcast blobs and blobs that are not acknowledged within a few
+    /// retransmit timeouts are sent with the fixed scheme instead.
+    /// @see blob_option::windowed
+    blob_manipulator(
+      main_ctx_parent parent,
+      message_id fragment_msg_id,
+      message_id resend_msg_id,
+      message_id prepare_msg_id,
+      message_id ack_msg_id) noexcept;
+
     auto max_blob_size() const noexcept -> valid_if_positive<span_size_t> {
         return {span_size(_max_blob_size)};
     }
@@ -393,9 +599,13 @@ public:
     auto process_incoming(target_io_getter, const message_view& message) noexcept
       -> bool;
     auto process_resend(const message_view& message) noexcept -> bool;
+    auto process_ack(const message_view& message) noexcept -> bool;
     auto process_prepare(const message_view& message) noexcept -> bool;
 
     auto cancel_incoming(const endpoint_id_t target_blob_id) noexcept -> bool;
+    auto cancel_outgoing(
+      const endpoint_id_t target_id,
+      const blob_id_t target_blob_id) noexcept -> bool;
 
     using fetch_handler = callable_ref<
       bool(const message_id, const message_age, const message_view&) noexcept>;
@@ -415,7 +625,7 @@ private:
     auto _cleanup_outgoing() noexcept -> std::size_t;
     auto _cleanup_incoming() noexcept -> std::size_t;
     auto _done_begin_end(
-      const std::vector<std::tuple<span_size_t, span_size_t>>& done,
+      const blob_fragment_tracker& done,
       const span_size_t total_size,
       const span_size_t max_message_size) const noexcept
       -> std::tuple<span_size_t, span_size_t>;
@@ -428,10 +638,21 @@ private:
       const send_handler do_send,
       const span_size_t max_message_size,
       pending_blob& pending) noexcept -> work_done;
+    auto _window_allows(
+      pending_blob& pending,
+      const span_size_t max_message_size) noexcept -> bool;
+    auto _update_windowed_outgoing(
+      const std::chrono::steady_clock::time_point now) noexcept -> work_done;
+    auto _send_acknowledgements(
+      const send_handler do_send,
+      pending_blob& pending) noexcept -> work_done;
+    auto _is_windowed(const pending_blob&) const noexcept -> bool;
+    auto _flow_control(const pending_blob&) noexcept -> blob_flow_control&;
 
     const message_id _fragment_msg_id;
     const message_id _resend_msg_id;
     const message_id _prepare_msg_id;
+    const std::optional<message_id> _ack_msg_id{};
     std::int64_t _max_blob_size{128 * 1024 * 1024};
     blob_id_t _blob_id_sequence{0U};
     memory::buffer _scratch_buffer{};
@@ -439,6 +660,7 @@ private:
     std::size_t _outgoing_index{};
     std::vector<pending_blob> _outgoing{};
     std::vector<pending_blob> _incoming{};
+    std::map<endpoint_id_t, blob_flow_control> _flow_controls{};
 
     auto _message_size(const pending_blob&, const span_size_t max_message_size)
       const noexcept -> span_size_t;
@@ -342,6 +342,169 @@ auto make_target_blob_chunk_io(
     return {hold<blob_chunk_io>, blob_id, chunk_size, sigs, buffers};
 }
 //------------------------------------------------------------------------------
+// blob_fragment_tracker
+//------------------------------------------------------------------------------
+void blob_fragment_tracker::clear() noexcept {
+    while(not _ranges.empty()) {
+        _spare_nodes.push_back(_ranges.extract(_ranges.begin()));
+    }
+    _covered_size = 0;
+}
+//------------------------------------------------------------------------------
+void blob_fragment_tracker::assign(
+  const span_size_t bgn,
+  const span_size_t end) noexcept {
+    clear();
+    _insert(bgn, end);
+}
+//------------------------------------------------------------------------------
+void blob_fragment_tracker::_insert(
+  const span_size_t bgn,
+  const span_size_t end) noexcept {
+    if(_spare_nodes.empty()) {
+        _ranges.emplace(bgn, end);
+    } else {
+        auto node{std::move(_spare_nodes.back())};
+        _spare_nodes.pop_back();
+        node.key() = bgn;
+        node.mapped() = end;
+        _ranges.insert(std::move(node));
+    }
+    _covered_size += end - bgn;
+}
+//------------------------------------------------------------------------------
+auto blob_fragment_tracker::merge(
+  const span_size_t bgn,
+  const span_size_t end,
+  const merge_handler handler) noexcept -> bool {
+    if(bgn >= end) {
+        return true;
+    }
+    // start with the last range beginning before bgn if it reaches bgn
+    auto pos{_ranges.upper_bound(bgn)};
+    if(pos != _ranges.begin()) {
+        if(const auto prev{std::prev(pos)}; prev->second >= bgn) {
+            pos = prev;
+        }
+    }
+
+    bool result{true};
+    span_size_t cur{bgn};
+    span_size_t new_bgn{bgn};
+    span_size_t new_end{end};
+    while((pos != _ranges.end()) and (pos->first <= end)) {
+        const auto [rng_bgn, rng_end] = *pos;
+        if(cur < rng_bgn) {
+            result &= handler(cur, rng_bgn, false);
+        }
+        const auto ovl_bgn{std::max(cur, rng_bgn)};
+        const auto ovl_end{std::min(end, rng_end)};
+        if(ovl_bgn < ovl_end) {
+            result &= handler(ovl_bgn, ovl_end, true);
+        }
+        cur = std::max(cur, rng_end);
+        new_bgn = std::min(new_bgn, rng_bgn);
+        new_end = std::max(new_end, rng_end);
+        _covered_size -= rng_end - rng_bgn;
+        const auto next{std::next(pos)};
+        _spare_nodes.push_back(_ranges.extract(pos));
+        pos = next;
+    }
+    if(cur < end) {
+        result &= handler(cur, end, false);
+    }
+    _insert(new_bgn, new_end);
+    return result;
+}
+//------------------------------------------------------------------------------
+auto blob_fragment_tracker::merge(
+  const span_size_t bgn,
+  const span_size_t end) noexcept -> bool {
+    return merge(
+      bgn,
+      end,
+      {construct_from,
+       [](const span_size_t, const span_size_t, const bool) noexcept {
+           return true;
+       }});
+}
+//------------------------------------------------------------------------------
+void blob_fragment_tracker::consume_back(const span_size_t size) noexcept {
+    assert(not empty());
+    auto node{_ranges.extract(std::prev(_ranges.end()))};
+    const auto consumed{std::min(size, node.mapped() - node.key())};
+    _covered_size -= consumed;
+    node.key() += consumed;
+    if(node.key() < node.mapped()) {
+        _ranges.insert(std::move(node));
+    } else {
+        _spare_nodes.push_back(std::move(node));
+    }
+}
+//------------------------------------------------------------------------------
+void blob_fragment_tracker::set_back_end(const span_size_t end) noexcept {
+    assert(not empty());
+    auto& last{*_ranges.rbegin()};
+    _covered_size += end - last.second;
+    last.second = end;
+}
+//------------------------------------------------------------------------------
+// blob_flow_control
+//------------------------------------------------------------------------------
+auto blob_flow_control::can_send(
+  const span_size_t in_flight,
+  const span_size_t fragment_size) noexcept -> bool {
+    _fragment_size = fragment_size;
+    if(_window == 0) [[unlikely]] {
+        _window = 4 * fragment_size;
+    }
+    return (in_flight == 0) or (in_flight + fragment_size <= _window);
+}
+//------------------------------------------------------------------------------
+void blob_flow_control::handle_acknowledged(
+  const span_size_t acked_size) noexcept {
+    if(_window < _threshold) {
+        _window += acked_size;
+    } else {
+        _window += std::max(
+          _fragment_size * acked_size / std::max(_window, span_size_t(1)),
+          span_size_t(1));
+    }
+    _window = std::min(_window, 1024 * _fragment_size);
+}
+//------------------------------------------------------------------------------
+void blob_flow_control::handle_round_trip(
+  const clock_type::duration sample) noexcept {
+    if(_has_round_trip) {
+        _rttvar = (3 * _rttvar + std::chrono::abs(_srtt - sample)) / 4;
+        _srtt = (7 * _srtt + sample) / 8;
+    } else {
+        _srtt = sample;
+        _rttvar = sample / 2;
+        _has_round_trip = true;
+    }
+    _rto = std::clamp<clock_type::duration>(
+      _srtt + std::max<clock_type::duration>(
+                4 * _rttvar, std::chrono::milliseconds{10}),
+      std::chrono::milliseconds{50},
+      std::chrono::seconds{10});
+}
+//------------------------------------------------------------------------------
+auto blob_flow_control::handle_loss(
+  const clock_type::time_point now,
+  const bool timed_out) noexcept -> bool {
+    if(timed_out) {
+        _rto = std::min<clock_type::duration>(2 * _rto, std::chrono::seconds{10});
+    }
+    if(now < _recovery_end) {
+        return false;
+    }
+    _threshold = std::max(_window / 2, 2 * _fragment_size);
+    _window = _threshold;
+    _recovery_end = now + (_has_round_trip ? _srtt : _rto);
+    return true;
+}
+//------------------------------------------------------------------------------
 // pending blob
 //------------------------------------------------------------------------------
 auto pending_blob::source_buffer_io() noexcept -> buffer_blob_io* {
@@ -352,20 +515,22 @@ auto pending_blob::target_buffer_io() noexcept -> buffer_blob_io* {
     return dynamic_cast<buffer_blob_io*>(target_io.get());
 }
 //------------------------------------------------------------------------------
+void pending_blob::drop_windowed() noexcept {
+    info.options = blob_options{static_cast<blob_options_t>(
+      static_cast<blob_options_t>(info.options) &
+      ~static_cast<blob_options_t>(blob_option::windowed))};
+    // the fragments in flight count as sent, the receiver requests
+    // the missing ones as with the fixed scheme
+    in_flight.clear();
+    in_flight_size = 0;
+}
+//------------------------------------------------------------------------------
 auto pending_blob::sent_size() const noexcept -> span_size_t {
-    span_size_t result = 0;
-    for(const auto& [bgn, end] : todo_parts()) {
-        result += end - bgn;
-    }
-    return info.total_size - result;
+    return info.total_size - todo_parts().covered_size();
 }
 //------------------------------------------------------------------------------
 auto pending_blob::received_size() const noexcept -> span_size_t {
-    span_size_t result = 0;
-    for(const auto& [bgn, end] : done_parts()) {
-        result += end - bgn;
-    }
-    return result;
+    return done_parts().covered_size();
 }
 //------------------------------------------------------------------------------
 auto pending_blob::total_size() const noexcept -> span_size_t {
@@ -381,7 +546,7 @@ void pending_blob::handle_source_preparing(float new_progress) noexcept {
     if(not todo_parts().empty()) {
         linger_time.reset();
         info.total_size = source_io->total_size();
-        std::get<1>(todo_parts().back()) = info.total_size;
+        todo_parts().set_back_end(info.total_size);
     }
     prepare_progress = new_progress;
 }
@@ -409,7 +574,7 @@ auto pending_blob::sent_everything() const noexcept -> bool {
 }
 //------------------------------------------------------------------------------
 auto pending_blob::received_everything() const noexcept -> bool {
-    auto& done = done_parts();
+    const auto& done = done_parts();
     if(done.size() == 1) {
         const auto [bgn, end] = done.front();
         return (bgn == 0) and (info.total_size != 0) and
@@ -418,6 +583,11 @@ auto pending_blob::received_everything() const noexcept -> bool {
     return (info.total_size != 0) and done.empty();
 }
 //------------------------------------------------------------------------------
+auto pending_blob::acknowledged_everything() const noexcept -> bool {
+    return is_windowed() and (info.total_size != 0) and
+           (done_parts().covered_size() >= info.total_size);
+}
+//------------------------------------------------------------------------------
 auto pending_blob::fetch(const span_size_t offs, memory::block dst) noexcept {
     assert(source_io);
     return source_io->fetch_fragment(offs, dst);
@@ -444,65 +614,24 @@ auto pending_blob::age() const noexcept -> message_age {
 auto pending_blob::merge_fragment(
   const span_size_t bgn,
   const memory::const_block fragment) noexcept -> bool {
-    const auto end = bgn + fragment.size();
-    fragment_parts.swap();
-    auto& dst = done_parts();
-    const auto& src = todo_parts();
-    dst.clear();
-
-    bool result = true;
-    bool new_done = false;
-
-    for(const auto [src_bgn, src_end] : src) {
-        if(bgn < src_bgn) {
-            if(end < src_bgn) {
-                if(not new_done) {
-                    dst.emplace_back(bgn, end);
-                    result &= store(bgn, fragment);
-                    new_done = true;
-                }
-                dst.emplace_back(src_bgn, src_end);
-            } else if(end <= src_end) {
-                if(new_done) {
-                    std::get<1>(dst.back()) = src_end;
-                } else {
-                    dst.emplace_back(bgn, src_end);
-                    result &= store(bgn, head(fragment, src_bgn - bgn));
-                    new_done = true;
-                }
-                result &= check(src_bgn, skip(fragment, src_bgn - bgn));
-            } else {
-                if(not new_done) {
-                    dst.emplace_back(bgn, end);
-                    result &= store(bgn, head(fragment, src_bgn - bgn));
-                    result &= store(src_end, skip(fragment, src_end - bgn));
-                    new_done = true;
-                }
-                result &= check(
-                  src_bgn,
-                  head(skip(fragment, src_bgn - bgn), src_end - src_bgn));
-            }
-        } else if(bgn <= src_end) {
-            if(end <= src_end) {
-                dst.emplace_back(src_bgn, src_end);
-                new_done = true;
-                result &= check(bgn, fragment);
-            } else {
-                dst.emplace_back(src_bgn, end);
-                result &= store(src_end, skip(fragment, src_end - bgn));
-                result &= check(bgn, head(fragment, src_end - bgn));
-                new_done = true;
-            }
-        } else {
-            dst.emplace_back(src_bgn, src_end);
-        }
-    }
-    if(not new_done) {
-        dst.emplace_back(bgn, end);
-        result &= store(bgn, fragment);
+    // new sub-ranges of the fragment are stored, the already received
+    // ones are checked against the stored data
+    const auto result{done_parts().merge(
+      bgn,
+      bgn + fragment.size(),
+      {construct_from,
+       [&](
+         const span_size_t sub_bgn,
+         const span_size_t sub_end,
+         const bool existing) noexcept {
+           const auto sub{head(skip(fragment, sub_bgn - bgn), sub_end - sub_bgn)};
+           return existing ? check(sub_bgn, sub) : store(sub_bgn, sub);
+       }})};
+    if(is_windowed()) {
+        // duplicates are acknowledged again, the previous ack may be lost
+        unacked_fragments.merge(bgn, bgn + fragment.size());
     }
     latest_update = std::chrono::steady_clock::now();
-
     return result;
 }
 //------------------------------------------------------------------------------
@@ -512,51 +641,86 @@ void pending_blob::merge_resend_request(
     if(end == 0) {
         end = info.total_size;
     }
-    if(bgn < end) {
-        fragment_parts.swap();
-        auto& dst = todo_parts();
-        const auto& src = done_parts();
-        dst.clear();
-
-        bool new_done = false;
+    todo_parts().merge(bgn, end);
+}
+//------------------------------------------------------------------------------
+void pending_blob::add_in_flight(
+  const span_size_t bgn,
+  const span_size_t end,
+  const clock_type::time_point now) noexcept {
+    // retransmitted fragments do not yield round-trip time samples
+    bool retransmitted{false};
+    sent_fragments.merge(
+      bgn,
+      end,
+      {construct_from,
+       [&](const span_size_t, const span_size_t, const bool existing) noexcept {
+           retransmitted = retransmitted or existing;
+           return true;
+       }});
+    auto& fragment{in_flight[bgn]};
+    if(fragment.end > bgn) {
+        in_flight_size -= fragment.end - bgn;
+    }
+    fragment = {
+      .end = end,
+      .sent_time = now,
+      .sequence = ++sent_sequence,
+      .retransmitted = retransmitted};
+    in_flight_size += end - bgn;
+}
+//------------------------------------------------------------------------------
+auto pending_blob::merge_acknowledged(
+  const span_size_t bgn,
+  const span_size_t end,
+  const clock_type::time_point now) noexcept
+  -> std::tuple<span_size_t, std::optional<clock_type::duration>> {
+    span_size_t acked_size{0};
+    std::optional<clock_type::duration> round_trip;
 
-        for(const auto& [src_bgn, src_end] : src) {
-            if(bgn < src_bgn) {
-                if(end < src_bgn) {
-                    if(not new_done) {
-                        dst.emplace_back(bgn, end);
-                        new_done = true;
-                    }
-                    dst.emplace_back(src_bgn, src_end);
-                } else if(end <= src_end) {
-                    if(new_done) {
-                        std::get<1>(dst.back()) = src_end;
-                    } else {
-                        dst.emplace_back(bgn, src_end);
-                        new_done = true;
-                    }
-                } else {
-                    if(not new_done) {
-                        dst.emplace_back(bgn, end);
-                        new_done = true;
-                    }
-                }
-            } else if(bgn <= src_end) {
-                if(end <= src_end) {
-                    dst.emplace_back(src_bgn, src_end);
-                    new_done = true;
-                } else {
-                    dst.emplace_back(src_bgn, end);
-                    new_done = true;
-                }
-            } else {
-                dst.emplace_back(src_bgn, src_end);
+    done_parts().merge(bgn, end);
+    auto pos{in_flight.lower_bound(bgn)};
+    while((pos != in_flight.end()) and (pos->second.end <= end)) {
+        const auto& fragment{pos->second};
+        acked_size += fragment.end - pos->first;
+        if(not fragment.retransmitted) {
+            // the most recently sent fragment is the least delayed
+            // by the batching of acknowledgements on the receiver
+            const auto sample{now - fragment.sent_time};
+            if(not round_trip or (sample < *round_trip)) {
+                round_trip = sample;
             }
         }
-        if(not new_done) {
-            dst.emplace_back(bgn, end);
+        acked_sequence = std::max(acked_sequence, fragment.sequence);
+        pos = in_flight.erase(pos);
+    }
+    in_flight_size -= acked_size;
+    return {acked_size, round_trip};
+}
+//------------------------------------------------------------------------------
+auto pending_blob::take_lost(
+  const clock_type::time_point now,
+  const clock_type::duration timeout) noexcept
+  -> std::tuple<span_size_t, bool> {
+    // a fragment is lost if it was not acknowledged in time or if
+    // several fragments sent after it were already acknowledged
+    span_size_t lost_size{0};
+    bool timed_out{false};
+    auto pos{in_flight.begin()};
+    while(pos != in_flight.end()) {
+        const auto& fragment{pos->second};
+        const bool expired{fragment.sent_time + timeout < now};
+        if(expired or (fragment.sequence + 3U <= acked_sequence)) {
+            timed_out = timed_out or expired;
+            todo_parts().merge(pos->first, fragment.end);
+            lost_size += fragment.end - pos->first;
+            pos = in_flight.erase(pos);
+        } else {
+            ++pos;
         }
     }
+    in_flight_size -= lost_size;
+    return {lost_size, timed_out};
 }
 //------------------------------------------------------------------------------
 void pending_blob::handle_target_preparing(float new_progress) noexcept {
@@ -580,10 +744,22 @@ blob_manipulator::blob_manipulator(
   , _resend_msg_id{std::move(resend_msg_id)}
   , _prepare_msg_id{std::move(prepare_msg_id)} {}
 //------------------------------------------------------------------------------
+blob_manipulator::blob_manipulator(
+  main_ctx_parent parent,
+  message_id fragment_msg_id,
+  message_id resend_msg_id,
+  message_id prepare_msg_id,
+  message_id ack_msg_id) noexcept
+  : main_ctx_object{"BlobManipl", parent}
+  , _fragment_msg_id{std::move(fragment_msg_id)}
+  , _resend_msg_id{std::move(resend_msg_id)}
+  , _prepare_msg_id{std::move(prepare_msg_id)}
+  , _ack_msg_id{std::move(ack_msg_id)} {}
+//------------------------------------------------------------------------------
 auto blob_manipulator::_cleanup_outgoing() noexcept -> std::size_t {
     return std::erase_if(_outgoing, [this](auto& pending) {
         if(
-          pending.max_time.is_expired() or
+          pending.max_time.is_expired() or pending.acknowledged_everything() or
           (pending.sent_everything() and pending.linger_time.is_expired())) {
             if(auto buf_io{pending.source_buffer_io()}) {
                 _buffers.eat(buf_io->release_buffer());
@@ -608,25 +784,17 @@ auto blob_manipulator::_cleanup_incoming() noexcept -> std::size_t {
 }
 //------------------------------------------------------------------------------
 auto blob_manipulator::_done_begin_end(
-  const std::vector<std::tuple<span_size_t, span_size_t>>& done,
+  const blob_fragment_tracker& done,
   const span_size_t total_size,
   const span_size_t max_message_size) const noexcept
   -> std::tuple<span_size_t, span_size_t> {
     const auto max{2 * max_message_size / 3};
-    if(std::get<0>(done[0]) > 0) {
-        return {0, std::min(std::get<0>(done[0]), max)};
+    const auto [first_bgn, first_end] = done.front();
+    if(first_bgn > 0) {
+        return {0, std::min(first_bgn, max)};
     } else {
-        if(done.size() == 1) {
-            return {
-              std::get<1>(done[0]),
-              std::get<1>(done[0]) +
-                std::min(total_size - std::get<1>(done[0]), max)};
-        } else {
-            return {
-              std::get<1>(done[0]),
-              std::get<1>(done[0]) +
-                std::min(std::get<0>(done[1]) - std::get<1>(done[0]), max)};
-        }
+        const auto gap_end{done.second_begin().value_or(total_size)};
+        return {first_end, first_end + std::min(gap_end - first_end, max)};
     }
 }
 //------------------------------------------------------------------------------
@@ -654,7 +822,18 @@ auto blob_manipulator::update(
         something_done();
     }
 
+    if(std::erase_if(_flow_controls, [](const auto& entry) {
+           return std::get<1>(entry).is_idle();
+       }) > 0) {
+        something_done();
+    }
+
+    something_done(_update_windowed_outgoing(now));
+
     for(auto& pending : _incoming) {
+        if(not pending.unacked_fragments.empty()) {
+            something_done(_send_acknowledgements(do_send, pending));
+        }
         auto& done = pending.done_parts();
         if(not done.empty()) {
             if(now - pending.latest_update > std::chrono::milliseconds{250}) {
@@ -677,6 +856,89 @@ auto blob_manipulator::update(
     return something_done;
 }
 //------------------------------------------------------------------------------
+auto blob_manipulator::_is_windowed(const pending_blob& pending) const noexcept
+  -> bool {
+    return _ack_msg_id and pending.is_windowed();
+}
+//------------------------------------------------------------------------------
+auto blob_manipulator::_flow_control(const pending_blob& pending) noexcept
+  -> blob_flow_control& {
+    auto& flow{
+      _flow_controls.try_emplace(pending.info.target_id).first->second};
+    flow.mark_used();
+    return flow;
+}
+//------------------------------------------------------------------------------
+auto blob_manipulator::_window_allows(
+  pending_blob& pending,
+  const span_size_t max_message_size) noexcept -> bool {
+    if(_is_windowed(pending)) {
+        return _flow_control(pending).can_send(
+          pending.in_flight_size, _message_size(pending, max_message_size));
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+auto blob_manipulator::_update_windowed_outgoing(
+  const std::chrono::steady_clock::time_point now) noexcept -> work_done {
+    some_true something_done{};
+    for(auto& pending : _outgoing) {
+        if(_is_windowed(pending) and not pending.in_flight.empty()) {
+            auto& flow{_flow_control(pending)};
+            const auto [lost_size, timed_out] =
+              pending.take_lost(now, flow.retransmit_timeout());
+            if(timed_out and (pending.acked_sequence == 0U)) {
+                // the target does not acknowledge the fragments,
+                // for example it does not support the windowed scheme
+                if(++pending.unacked_timeouts >= 3) {
+                    log_info("blob target does not acknowledge fragments")
+                      .tag("blobNoAck")
+                      .arg("target", pending.info.target_id)
+                      .arg("srcBlobId", pending.source_blob_id);
+                    pending.drop_windowed();
+                    something_done();
+                    continue;
+                }
+            }
+            if(lost_size > 0) {
+                if(flow.handle_loss(now, timed_out)) {
+                    log_debug("reduced blob congestion window")
+                      .tag("blobWndwDn")
+                      .arg("target", pending.info.target_id)
+                      .arg("srcBlobId", pending.source_blob_id)
+                      .arg("lost", "ByteSize", lost_size)
+                      .arg("window", "ByteSize", flow.window_size())
+                      .arg("roundTrip", flow.round_trip_time())
+                      .arg("timedOut", yes_no_maybe(timed_out));
+                }
+                something_done();
+            }
+        }
+    }
+    return something_done;
+}
+//------------------------------------------------------------------------------
+auto blob_manipulator::_send_acknowledgements(
+  const send_handler do_send,
+  pending_blob& pending) noexcept -> work_done {
+    some_true something_done{};
+    if(_ack_msg_id) {
+        for(const auto& [bgn, end] : pending.unacked_fragments) {
+            const std::tuple<identifier_t, std::uint64_t, std::uint64_t> params{
+              pending.source_blob_id, bgn, end};
+            auto buffer{default_serialize_buffer_for(params)};
+            const auto serialized{default_serialize(params, cover(buffer))};
+            assert(serialized);
+            message_view ack{*serialized};
+            ack.set_target_id(pending.info.source_id);
+            ack.set_priority(pending.info.priority);
+            something_done(do_send(*_ack_msg_id, ack));
+        }
+    }
+    pending.unacked_fragments.clear();
+    return something_done;
+}
+//------------------------------------------------------------------------------
 auto blob_manipulator::make_target_io(const span_size_t total_size) noexcept
   -> unique_holder<target_blob_io> {
     if(total_size < _max_blob_size) {
@@ -927,6 +1189,32 @@ auto blob_manipulator::process_resend(const message_view& message) noexcept
     return true;
 }
 //------------------------------------------------------------------------------
+auto blob_manipulator::process_ack(const message_view& message) noexcept
+  -> bool {
+    std::tuple<identifier_t, std::uint64_t, std::uint64_t> params{};
+    if(default_deserialize(params, message.content())) {
+        const auto source_blob_id{std::get<0>(params)};
+        const auto pos{std::find_if(
+          _outgoing.begin(), _outgoing.end(), [source_blob_id](auto& pending) {
+              return pending.source_blob_id == source_blob_id;
+          })};
+        if((pos != _outgoing.end()) and _is_windowed(*pos)) {
+            const auto [acked_size, round_trip] = pos->merge_acknowledged(
+              limit_cast<span_size_t>(std::get<1>(params)),
+              limit_cast<span_size_t>(std::get<2>(params)),
+              std::chrono::steady_clock::now());
+            auto& flow{_flow_control(*pos)};
+            if(round_trip) {
+                flow.handle_round_trip(*round_trip);
+            }
+            if(acked_size > 0) {
+                flow.handle_acknowledged(acked_size);
+            }
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
 auto blob_manipulator::process_prepare(const message_view& message) noexcept
   -> bool {
     std::tuple<identifier_t, float> params{};
@@ -961,6 +1249,26 @@ auto blob_manipulator::cancel_incoming(
     return false;
 }
 //------------------------------------------------------------------------------
+auto blob_manipulator::cancel_outgoing(
+  const endpoint_id_t target_id,
+  const blob_id_t target_blob_id) noexcept -> bool {
+    const auto pos{std::find_if(
+      _outgoing.begin(),
+      _outgoing.end(),
+      [target_id, target_blob_id](auto& pending) {
+          return (pending.info.target_id == target_id) and
+                 (pending.target_blob_id == target_blob_id);
+      })};
+    if(pos != _outgoing.end()) {
+        if(auto buf_io{pos->source_buffer_io()}) {
+            _buffers.eat(buf_io->release_buffer());
+        }
+        _outgoing.erase(pos);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
 auto blob_manipulator::_message_size(
   const pending_blob& pending,
   const span_size_t max_message_size) const noexcept -> span_size_t {
@@ -1011,11 +1319,19 @@ auto blob_manipulator::push_outgoing(
         pending.info.priority = priority;
         pending.info.options = options;
         pending.source_blob_id = _next_blob_id();
+        if(pending.is_windowed() and not is_valid_id(target_id)) {
+            // the acknowledgements of one receiver must not release
+            // the blob for the others
+            log_warning("windowed scheme is not used for broadcast blobs")
+              .tag("blobWndwBc")
+              .arg("srcBlobId", pending.source_blob_id);
+            pending.drop_windowed();
+        }
         pending.target_blob_id = target_blob_id;
         pending.source_io = std::move(io);
         pending.linger_time.reset();
         pending.max_time = timeout{max_time};
-        pending.todo_parts().emplace_back(0, pending.info.total_size);
+        pending.todo_parts().assign(0, pending.info.total_size);
         return pending.source_blob_id;
     }
     return 0;
@@ -1073,7 +1389,7 @@ auto blob_manipulator::_process_finished_outgoing(
   const span_size_t max_message_size,
   pending_blob& pending) noexcept -> work_done {
     some_true something_done{};
-    auto& [bgn, end] = pending.todo_parts().back();
+    const auto [bgn, end] = pending.todo_parts().back();
     assert(end != 0);
 
     const auto header{std::make_tuple(
@@ -1094,9 +1410,12 @@ auto blob_manipulator::_process_finished_outgoing(
         if(auto written_size{pending.fetch(offset, sink.free())}) {
 
             sink.mark_used(written_size);
-            bgn += written_size;
-            if(bgn >= end) {
-                pending.todo_parts().pop_back();
+            pending.todo_parts().consume_back(written_size);
+            if(_is_windowed(pending)) {
+                pending.add_in_flight(
+                  offset,
+                  offset + written_size,
+                  std::chrono::steady_clock::now());
             }
             message_view message(sink.done());
             message.set_source_id(pending.info.source_id);
@@ -1142,8 +1461,10 @@ auto blob_manipulator::process_outgoing(
         auto& pending{_outgoing[_outgoing_index++ % _outgoing.size()]};
         const auto preparation{pending.prepare()};
         if(preparation.has_finished() and not pending.sent_everything()) {
-            something_done(
-              _process_finished_outgoing(do_send, max_message_size, pending));
+            if(_window_allows(pending, max_message_size)) {
+                something_done(
+                  _process_finished_outgoing(do_send, max_message_size, pending));
+            }
         } else if(preparation.is_working()) {
             something_done(
               _process_preparing_outgoing(do_send, max_message_size, pending));
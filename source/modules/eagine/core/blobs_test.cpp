@@ -1027,10 +1027,344 @@ void blobs_roundtrip_resend_2(auto& s) {
     }
 }
 //------------------------------------------------------------------------------
+// fragment tracker
+//------------------------------------------------------------------------------
+void blobs_fragment_tracker_random(unsigned, auto& s) {
+    eagitest::case_ test{s, 10, "fragment tracker random"};
+    auto& rg{test.random()};
+
+    using eagine::span_size_t;
+    const auto total{rg.get_between<span_size_t>(1, 64 * 1024)};
+    std::vector<bool> received(eagine::std_size(total), false);
+    eagine::msgbus::blob_fragment_tracker tracker;
+
+    for(unsigned r = 0; r < test.repeats(1000); ++r) {
+        const auto bgn{rg.get_between<span_size_t>(0, total - 1)};
+        const auto end{
+          std::min(bgn + rg.get_between<span_size_t>(0, 2048), total)};
+        tracker.merge(
+          bgn,
+          end,
+          {eagine::construct_from,
+           [&](
+             const span_size_t sub_bgn,
+             const span_size_t sub_end,
+             const bool existing) noexcept {
+               for(auto i = sub_bgn; i < sub_end; ++i) {
+                   test.check_equal(
+                     bool(received[eagine::std_size(i)]), existing, "existing");
+                   received[eagine::std_size(i)] = true;
+               }
+               return true;
+           }});
+
+        span_size_t covered{0};
+        span_size_t prev_end{-1};
+        for(const auto& [rng_bgn, rng_end] : tracker) {
+            test.check(prev_end < rng_bgn, "disjoint");
+            test.check(rng_bgn < rng_end, "not empty");
+            covered += rng_end - rng_bgn;
+            prev_end = rng_end;
+        }
+        test.check_equal(
+          covered,
+          span_size_t(std::count(received.begin(), received.end(), true)),
+          "covered");
+        test.check_equal(covered, tracker.covered_size(), "covered size");
+    }
+}
+//------------------------------------------------------------------------------
+void blobs_fragment_tracker_shuffled(unsigned, auto& s) {
+    eagitest::case_ test{s, 11, "fragment tracker shuffled"};
+    auto& rg{test.random()};
+
+    using eagine::span_size_t;
+    const auto total{rg.get_between<span_size_t>(1, 16 * 1024 * 1024)};
+    const auto fragment_size{rg.get_between<span_size_t>(256, 4096)};
+
+    std::vector<span_size_t> offsets;
+    for(span_size_t offs = 0; offs < total; offs += fragment_size) {
+        offsets.push_back(offs);
+    }
+    std::shuffle(
+      offsets.begin(),
+      offsets.end(),
+      std::mt19937{rg.get_between<std::uint32_t>(0U, 1000000U)});
+
+    eagine::msgbus::blob_fragment_tracker tracker;
+    span_size_t stored{0};
+    for(const auto offs : offsets) {
+        tracker.merge(
+          offs,
+          std::min(offs + fragment_size, total),
+          {eagine::construct_from,
+           [&](
+             const span_size_t sub_bgn,
+             const span_size_t sub_end,
+             const bool existing) noexcept {
+               test.check(not existing, "not existing");
+               stored += sub_end - sub_bgn;
+               return true;
+           }});
+    }
+    test.check_equal(stored, total, "stored size");
+    test.check_equal(tracker.size(), span_size_t(1), "single range");
+    test.check_equal(tracker.covered_size(), total, "covered size");
+    test.check_equal(std::get<0>(tracker.front()), span_size_t(0), "begin");
+    test.check_equal(std::get<1>(tracker.front()), total, "end");
+}
+//------------------------------------------------------------------------------
+// round-trip shuffled
+//------------------------------------------------------------------------------
+void blobs_roundtrip_shuffled(auto& s) {
+    eagitest::case_ test{s, 12, "round-trip shuffled"};
+    eagitest::track trck{test, 1, 4};
+    auto& rg{test.random()};
+    std::mt19937 shuffle_rg{rg.get_between<std::uint32_t>(0U, 1000000U)};
+
+    const eagine::message_id test_msg_id{eagine::random_identifier(), "test"};
+    const eagine::message_id send_msg_id{"check", "send"};
+    const eagine::message_id resend_msg_id{"check", "resend"};
+    const eagine::message_id prepare_msg_id{"test", "prepare"};
+    eagine::msgbus::blob_manipulator sender{
+      s.context(), send_msg_id, resend_msg_id, prepare_msg_id};
+    eagine::msgbus::blob_manipulator receiver{
+      s.context(), send_msg_id, resend_msg_id, prepare_msg_id};
+
+    // fragments are held back and delivered in random order,
+    // some of them more than once
+    std::vector<eagine::msgbus::stored_message> in_flight;
+    auto send_s2r{
+      [&](
+        const eagine::message_id msg_id,
+        const eagine::msgbus::message_view& message) -> bool {
+          test.check(msg_id == send_msg_id, "message id");
+          in_flight.emplace_back(message, eagine::memory::buffer{});
+          if(rg.one_of(10)) {
+              in_flight.emplace_back(message, eagine::memory::buffer{});
+          }
+          return true;
+      }};
+    const eagine::msgbus::blob_manipulator::send_handler handler_s2r{
+      eagine::construct_from, send_s2r};
+
+    auto send_r2s{
+      [&](
+        const eagine::message_id msg_id,
+        const eagine::msgbus::message_view& message) -> bool {
+          if(msg_id == resend_msg_id) {
+              sender.process_resend(message);
+          }
+          return true;
+      }};
+    const eagine::msgbus::blob_manipulator::send_handler handler_r2s{
+      eagine::construct_from, send_r2s};
+
+    const eagine::span_size_t blob_size{rg.get_between(256, 1024) * 1024};
+    sender.push_outgoing(
+      test_msg_id,
+      1,
+      0,
+      eagine::msgbus::blob_id_t(0),
+      {eagine::hold<bfs_source_blob_io>, blob_size},
+      std::chrono::hours{1},
+      eagine::msgbus::message_priority::normal);
+
+    bool done{false};
+
+    receiver.expect_incoming(
+      test_msg_id,
+      1,
+      eagine::msgbus::blob_id_t(0),
+      {eagine::hold<bfs_target_blob_io>, test, trck, blob_size, done},
+      std::chrono::hours{1});
+
+    const eagine::span_size_t max_message_size{1024};
+    while(not done) {
+        sender.update(handler_s2r, max_message_size);
+        sender.process_outgoing(handler_s2r, max_message_size, 64);
+        std::shuffle(in_flight.begin(), in_flight.end(), shuffle_rg);
+        for(const auto& message : in_flight) {
+            receiver.process_incoming(message);
+            trck.checkpoint(1);
+        }
+        in_flight.clear();
+        receiver.update(handler_r2s, max_message_size);
+        receiver.handle_complete();
+    }
+}
+//------------------------------------------------------------------------------
+// round-trip windowed
+//------------------------------------------------------------------------------
+void blobs_roundtrip_windowed(auto& s) {
+    eagitest::case_ test{s, 13, "round-trip windowed"};
+    eagitest::track trck{test, 1, 5};
+    auto& rg{test.random()};
+
+    const eagine::message_id test_msg_id{eagine::random_identifier(), "test"};
+    const eagine::message_id send_msg_id{"check", "send"};
+    const eagine::message_id resend_msg_id{"check", "resend"};
+    const eagine::message_id prepare_msg_id{"test", "prepare"};
+    const eagine::message_id ack_msg_id{"check", "ack"};
+    eagine::msgbus::blob_manipulator sender{
+      s.context(), send_msg_id, resend_msg_id, prepare_msg_id, ack_msg_id};
+    eagine::msgbus::blob_manipulator receiver{
+      s.context(), send_msg_id, resend_msg_id, prepare_msg_id, ack_msg_id};
+
+    auto send_s2r{
+      [&](
+        const eagine::message_id msg_id,
+        const eagine::msgbus::message_view& message) -> bool {
+          test.check(msg_id == send_msg_id, "message id");
+
+          if(not rg.one_of(5)) {
+              receiver.process_incoming(message);
+              trck.checkpoint(1);
+              if(rg.one_of(13)) {
+                  receiver.process_incoming(message);
+              }
+          }
+          return true;
+      }};
+    const eagine::msgbus::blob_manipulator::send_handler handler_s2r{
+      eagine::construct_from, send_s2r};
+
+    auto send_r2s{
+      [&](
+        const eagine::message_id msg_id,
+        const eagine::msgbus::message_view& message) -> bool {
+          if(not rg.one_of(7)) {
+              if(msg_id == resend_msg_id) {
+                  sender.process_resend(message);
+              } else if(msg_id == ack_msg_id) {
+                  sender.process_ack(message);
+                  trck.checkpoint(5);
+              }
+          }
+          return true;
+      }};
+    const eagine::msgbus::blob_manipulator::send_handler handler_r2s{
+      eagine::construct_from, send_r2s};
+
+    for(unsigned r = 0; r < test.repeats(3); ++r) {
+        const eagine::span_size_t blob_size{rg.get_between(64, 256) * 1024};
+        sender.push_outgoing(
+          test_msg_id,
+          1,
+          2,
+          eagine::msgbus::blob_id_t(r),
+          {eagine::hold<bfs_source_blob_io>, blob_size},
+          std::chrono::hours{1},
+          eagine::msgbus::blob_options{eagine::msgbus::blob_option::windowed},
+          eagine::msgbus::message_priority::normal);
+
+        bool done{false};
+
+        receiver.expect_incoming(
+          test_msg_id,
+          1,
+          eagine::msgbus::blob_id_t(r),
+          {eagine::hold<bfs_target_blob_io>, test, trck, blob_size, done},
+          std::chrono::hours{1});
+
+        // the sender drops the blob once all fragments are acknowledged
+        const eagine::span_size_t max_message_size{2048};
+        eagine::timeout acknowledged{std::chrono::seconds{30}};
+        while(not done or sender.has_outgoing()) {
+            sender.update(handler_s2r, max_message_size);
+            sender.process_outgoing(handler_s2r, max_message_size, 7);
+            receiver.update(handler_r2s, max_message_size);
+            receiver.handle_complete();
+            if(acknowledged.is_expired()) {
+                test.fail("blob not acknowledged");
+                break;
+            }
+        }
+    }
+}
+//------------------------------------------------------------------------------
+// windowed without acknowledgements
+//------------------------------------------------------------------------------
+void blobs_windowed_not_acknowledged(auto& s) {
+    eagitest::case_ test{s, 14, "windowed without acknowledgements"};
+    eagitest::track trck{test, 1, 3};
+
+    const eagine::message_id test_msg_id{eagine::random_identifier(), "test"};
+    const eagine::message_id send_msg_id{"check", "send"};
+    const eagine::message_id resend_msg_id{"check", "resend"};
+    const eagine::message_id prepare_msg_id{"test", "prepare"};
+    const eagine::message_id ack_msg_id{"check", "ack"};
+    eagine::msgbus::blob_manipulator sender{
+      s.context(), send_msg_id, resend_msg_id, prepare_msg_id, ack_msg_id};
+    // the receiver does not support the windowed scheme
+    eagine::msgbus::blob_manipulator receiver{
+      s.context(), send_msg_id, resend_msg_id, prepare_msg_id};
+
+    auto send_s2r{
+      [&](
+        const eagine::message_id msg_id,
+        const eagine::msgbus::message_view& message) -> bool {
+          test.check(msg_id == send_msg_id, "message id");
+          receiver.process_incoming(message);
+          trck.checkpoint(1);
+          return true;
+      }};
+    const eagine::msgbus::blob_manipulator::send_handler handler_s2r{
+      eagine::construct_from, send_s2r};
+
+    auto send_r2s{
+      [&](
+        const eagine::message_id msg_id,
+        const eagine::msgbus::message_view& message) -> bool {
+          test.check(msg_id != ack_msg_id, "not acknowledged");
+          if(msg_id == resend_msg_id) {
+              sender.process_resend(message);
+          }
+          return true;
+      }};
+    const eagine::msgbus::blob_manipulator::send_handler handler_r2s{
+      eagine::construct_from, send_r2s};
+
+    const eagine::span_size_t blob_size{256 * 1024};
+    sender.push_outgoing(
+      test_msg_id,
+      1,
+      2,
+      eagine::msgbus::blob_id_t(0),
+      {eagine::hold<bfs_source_blob_io>, blob_size},
+      std::chrono::hours{1},
+      eagine::msgbus::blob_options{eagine::msgbus::blob_option::windowed},
+      eagine::msgbus::message_priority::normal);
+
+    bool done{false};
+
+    receiver.expect_incoming(
+      test_msg_id,
+      1,
+      eagine::msgbus::blob_id_t(0),
+      {eagine::hold<bfs_target_blob_io>, test, trck, blob_size, done},
+      std::chrono::hours{1});
+
+    // the sender falls back to the fixed scheme after a few retransmit
+    // timeouts and drops the blob after it lingers
+    const eagine::span_size_t max_message_size{2048};
+    eagine::timeout finished{std::chrono::seconds{60}};
+    while(not done or sender.has_outgoing()) {
+        sender.update(handler_s2r, max_message_size);
+        sender.process_outgoing(handler_s2r, max_message_size, 7);
+        receiver.update(handler_r2s, max_message_size);
+        receiver.handle_complete();
+        if(finished.is_expired()) {
+            test.fail("blob not finished");
+            break;
+        }
+    }
+}
+//------------------------------------------------------------------------------
 // main
 //------------------------------------------------------------------------------
 auto test_main(eagine::test_ctx& ctx) -> int {
-    eagitest::ctx_suite test{ctx, "blobs", 9};
+    eagitest::ctx_suite test{ctx, "blobs", 14};
     test.once(blobs_roundtrip_zeroes_single_big);
     test.repeat(5, blobs_roundtrip_zeroes_single);
     test.once(blobs_roundtrip_bfs_single);
@@ -1040,6 +1374,11 @@ auto test_main(eagine::test_ctx& ctx) -> int {
     test.once(blobs_roundtrip_chunk_signals_failed);
     test.once(blobs_roundtrip_resend_1);
     test.once(blobs_roundtrip_resend_2);
+    test.repeat(10, blobs_fragment_tracker_random);
+    test.repeat(10, blobs_fragment_tracker_shuffled);
+    test.once(blobs_roundtrip_shuffled);
+    test.once(blobs_roundtrip_windowed);
+    test.once(blobs_windowed_not_acknowledged);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------
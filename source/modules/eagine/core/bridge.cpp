@@ -21,6 +21,50 @@ import :context;
 
 namespace eagine::msgbus {
 //------------------------------------------------------------------------------
+/// @brief Appends the unpadded base64 encoding of a block to a byte vector.
+/// @ingroup msgbus
+/// @see bridge_base64_decode
+export void bridge_base64_encode(
+  const memory::const_block blk,
+  std::vector<byte>& dst) noexcept;
+
+/// @brief Decodes unpadded base64 characters into a block, returns the size.
+/// @ingroup msgbus
+/// @see bridge_base64_encode
+/// @pre dst.size() >= (blk.size() * 3) / 4 + 32
+///
+/// The returned value is not valid if the input contains invalid characters.
+export auto bridge_base64_decode(
+  const memory::const_block blk,
+  memory::block dst) noexcept -> valid_if_nonnegative<span_size_t>;
+
+/// @brief Appends a size-prefixed compact message frame to a byte vector.
+/// @ingroup msgbus
+/// @see bridge_frame_size
+/// @see bridge_read_frame
+export auto bridge_write_frame(
+  const message_id msg_id,
+  const message_view& message,
+  memory::buffer& scratch,
+  std::vector<byte>& dst) noexcept -> bool;
+
+/// @brief Returns the size of the whole frame starting with the given prefix.
+/// @ingroup msgbus
+/// @see bridge_write_frame
+///
+/// Returns zero if the prefix is not complete yet.
+export auto bridge_frame_size(const memory::const_block prefix) noexcept
+  -> span_size_t;
+
+/// @brief Reads a message from a complete frame.
+/// @ingroup msgbus
+/// @see bridge_write_frame
+/// @see bridge_frame_size
+export auto bridge_read_frame(
+  const memory::const_block frame,
+  message_id& msg_id,
+  stored_message& dest) noexcept -> bool;
+//------------------------------------------------------------------------------
 export class bridge_state;
 export class bridge
   : public main_ctx_object
@@ -113,6 +157,9 @@ private:
     std::int64_t _dropped_messages_c2o{0};
     bridge_statistics _stats{};
 
+    // both ends of the pipe must use the same framing
+    const bool _binary_framing{
+      cfg_init("msgbus.bridge.binary_framing", false)};
     shared_holder<bridge_state> _state{};
     timeout _no_connection_timeout{adjusted_duration(std::chrono::seconds{30})};
     shared_holder<connection> _connection{};
@@ -8,6 +8,21 @@
 module;
 
 #include <cassert>
+#if (defined(__x86_64__) || defined(__i386__)) && \
+  (defined(__GNUC__) || defined(__clang__)) && __has_include(<immintrin.h>)
+#include <immintrin.h>
+#define EAGINE_MSGBUS_BRIDGE_USE_X86_SIMD 1
+#else
+#define EAGINE_MSGBUS_BRIDGE_USE_X86_SIMD 0
+#endif
+#if __has_include(<poll.h>) && __has_include(<unistd.h>)
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#define EAGINE_MSGBUS_BRIDGE_USE_POLL 1
+#else
+#define EAGINE_MSGBUS_BRIDGE_USE_POLL 0
+#endif
 
 module eagine.msgbus.core;
 
@@ -25,12 +40,422 @@ import eagine.core.main_ctx;
 
 namespace eagine::msgbus {
 //------------------------------------------------------------------------------
+// base64 block codec
+//------------------------------------------------------------------------------
+// Produces the same unpadded output as the bit-by-bit base64 transforms,
+// but processes whole blocks of three bytes / four characters at a time
+// and uses SSSE3 or AVX2 lanes for the bulk of the data when the CPU
+// supports them. The vector code is compiled with per-function targets
+// and selected at run-time, so it does not depend on the build flags.
+static constexpr const std::string_view base64_chars{
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+
+static constexpr const auto base64_values{[] {
+    std::array<std::int8_t, 256> result{};
+    result.fill(-1);
+    for(std::size_t i = 0; i < base64_chars.size(); ++i) {
+        result[static_cast<std::uint8_t>(base64_chars[i])] = std::int8_t(i);
+    }
+    return result;
+}()};
+//------------------------------------------------------------------------------
+#if EAGINE_MSGBUS_BRIDGE_USE_X86_SIMD
+static auto base64_has_ssse3() noexcept -> bool {
+    static const bool result{__builtin_cpu_supports("ssse3") != 0};
+    return result;
+}
+//------------------------------------------------------------------------------
+static auto base64_has_avx2() noexcept -> bool {
+    static const bool result{__builtin_cpu_supports("avx2") != 0};
+    return result;
+}
+//------------------------------------------------------------------------------
+// encodes the first 12 bytes of the register into 16 characters
+[[gnu::target("ssse3")]] static auto base64_encode_lanes(__m128i in) noexcept
+  -> __m128i {
+    in = _mm_shuffle_epi8(
+      in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    const auto hi{_mm_mulhi_epu16(
+      _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+      _mm_set1_epi32(0x04000040))};
+    const auto lo{_mm_mullo_epi16(
+      _mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+      _mm_set1_epi32(0x01000010))};
+    const auto indices{_mm_or_si128(hi, lo)};
+    auto offsets{_mm_subs_epu8(indices, _mm_set1_epi8(51))};
+    offsets = _mm_or_si128(
+      offsets,
+      _mm_and_si128(
+        _mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+    const auto shifts{_mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0)};
+    return _mm_add_epi8(_mm_shuffle_epi8(shifts, offsets), indices);
+}
+//------------------------------------------------------------------------------
+// decodes 16 characters into the first 12 bytes, fails on invalid characters
+[[gnu::target("ssse3")]] static auto base64_decode_lanes(
+  __m128i in,
+  __m128i& out) noexcept -> bool {
+    const auto nibble_mask{_mm_set1_epi8(0x0f)};
+    const auto hi_nibbles{_mm_and_si128(_mm_srli_epi32(in, 4), nibble_mask)};
+    const auto lo_nibbles{_mm_and_si128(in, nibble_mask)};
+    const auto lo_bits{_mm_shuffle_epi8(
+      _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A),
+      lo_nibbles)};
+    const auto hi_bits{_mm_shuffle_epi8(
+      _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10),
+      hi_nibbles)};
+    if(_mm_movemask_epi8(_mm_cmpeq_epi8(
+         _mm_and_si128(lo_bits, hi_bits), _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    const auto shifts{_mm_shuffle_epi8(
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+      _mm_add_epi8(_mm_cmpeq_epi8(in, _mm_set1_epi8('/')), hi_nibbles))};
+    const auto values{_mm_add_epi8(in, shifts)};
+    const auto pairs{_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140))};
+    const auto triples{_mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000))};
+    out = _mm_shuffle_epi8(
+      triples,
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+}
+//------------------------------------------------------------------------------
+// same as above, on the 12 leading bytes of each 128-bit lane
+[[gnu::target("avx2")]] static auto base64_encode_lanes(__m256i in) noexcept
+  -> __m256i {
+    in = _mm256_shuffle_epi8(
+      in,
+      _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    const auto hi{_mm256_mulhi_epu16(
+      _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+      _mm256_set1_epi32(0x04000040))};
+    const auto lo{_mm256_mullo_epi16(
+      _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+      _mm256_set1_epi32(0x01000010))};
+    const auto indices{_mm256_or_si256(hi, lo)};
+    auto offsets{_mm256_subs_epu8(indices, _mm256_set1_epi8(51))};
+    offsets = _mm256_or_si256(
+      offsets,
+      _mm256_and_si256(
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices),
+        _mm256_set1_epi8(13)));
+    const auto shifts{_mm256_broadcastsi128_si256(_mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0))};
+    return _mm256_add_epi8(_mm256_shuffle_epi8(shifts, offsets), indices);
+}
+//------------------------------------------------------------------------------
+// decodes 32 characters into the first 24 bytes
+[[gnu::target("avx2")]] static auto base64_decode_lanes(
+  __m256i in,
+  __m256i& out) noexcept -> bool {
+    const auto nibble_mask{_mm256_set1_epi8(0x0f)};
+    const auto hi_nibbles{
+      _mm256_and_si256(_mm256_srli_epi32(in, 4), nibble_mask)};
+    const auto lo_nibbles{_mm256_and_si256(in, nibble_mask)};
+    const auto lo_bits{_mm256_shuffle_epi8(
+      _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A)),
+      lo_nibbles)};
+    const auto hi_bits{_mm256_shuffle_epi8(
+      _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10)),
+      hi_nibbles)};
+    if(not _mm256_testz_si256(lo_bits, hi_bits)) {
+        return false;
+    }
+    const auto shifts{_mm256_shuffle_epi8(
+      _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0)),
+      _mm256_add_epi8(
+        _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')), hi_nibbles))};
+    const auto values{_mm256_add_epi8(in, shifts)};
+    const auto pairs{
+      _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140))};
+    const auto triples{
+      _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000))};
+    out = _mm256_permutevar8x32_epi32(
+      _mm256_shuffle_epi8(
+        triples,
+        _mm256_setr_epi8(
+          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)),
+      _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1));
+    return true;
+}
+//------------------------------------------------------------------------------
+// the loops below advance the pointers and the remaining size
+// past the part of the input that they have processed
+[[gnu::target("avx2")]] static void base64_encode_avx2(
+  const byte*& src,
+  span_size_t& size,
+  byte*& out) noexcept {
+    for(; size >= 28; size -= 24, src += 24, out += 32) {
+        _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(out),
+          base64_encode_lanes(_mm256_loadu2_m128i(
+            reinterpret_cast<const __m128i*>(src + 12),
+            reinterpret_cast<const __m128i*>(src))));
+    }
+}
+//------------------------------------------------------------------------------
+[[gnu::target("ssse3")]] static void base64_encode_ssse3(
+  const byte*& src,
+  span_size_t& size,
+  byte*& out) noexcept {
+    for(; size >= 16; size -= 12, src += 12, out += 16) {
+        _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(out),
+          base64_encode_lanes(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+    }
+}
+//------------------------------------------------------------------------------
+[[gnu::target("avx2")]] static auto base64_decode_avx2(
+  const byte*& src,
+  span_size_t& size,
+  byte*& out) noexcept -> bool {
+    for(; size >= 32; size -= 32, src += 32, out += 24) {
+        __m256i decoded;
+        if(not base64_decode_lanes(
+             _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)),
+             decoded)) [[unlikely]] {
+            return false;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), decoded);
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+[[gnu::target("ssse3")]] static auto base64_decode_ssse3(
+  const byte*& src,
+  span_size_t& size,
+  byte*& out) noexcept -> bool {
+    for(; size >= 16; size -= 16, src += 16, out += 12) {
+        __m128i decoded;
+        if(not base64_decode_lanes(
+             _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), decoded))
+          [[unlikely]] {
+            return false;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), decoded);
+    }
+    return true;
+}
+#endif
+//------------------------------------------------------------------------------
+static auto base64_char(const std::uint32_t bits, const unsigned shift) noexcept
+  -> byte {
+    return byte(base64_chars[(bits >> shift) & 0x3FU]);
+}
+//------------------------------------------------------------------------------
+void bridge_base64_encode(
+  const memory::const_block blk,
+  std::vector<byte>& dst) noexcept {
+    const auto start{dst.size()};
+    const auto encoded_size{std_size((blk.size() * 4 + 2) / 3)};
+    // the vector loops store whole registers past the encoded end
+    dst.resize(start + encoded_size + 32U);
+    const byte* src{blk.data()};
+    span_size_t size{blk.size()};
+    byte* out{dst.data() + start};
+#if EAGINE_MSGBUS_BRIDGE_USE_X86_SIMD
+    if(base64_has_avx2()) {
+        base64_encode_avx2(src, size, out);
+    }
+    if(base64_has_ssse3()) {
+        base64_encode_ssse3(src, size, out);
+    }
+#endif
+    for(; size >= 3; size -= 3, src += 3, out += 4) {
+        const auto bits{
+          (std::uint32_t(src[0]) << 16U) | (std::uint32_t(src[1]) << 8U) |
+          std::uint32_t(src[2])};
+        out[0] = base64_char(bits, 18U);
+        out[1] = base64_char(bits, 12U);
+        out[2] = base64_char(bits, 6U);
+        out[3] = base64_char(bits, 0U);
+    }
+    if(size > 0) {
+        const auto bits{
+          (std::uint32_t(src[0]) << 16U) |
+          (size > 1 ? std::uint32_t(src[1]) << 8U : 0U)};
+        out[0] = base64_char(bits, 18U);
+        out[1] = base64_char(bits, 12U);
+        if(size > 1) {
+            out[2] = base64_char(bits, 6U);
+        }
+    }
+    dst.resize(start + encoded_size);
+}
+//------------------------------------------------------------------------------
+auto bridge_base64_decode(
+  const memory::const_block blk,
+  memory::block dst) noexcept -> valid_if_nonnegative<span_size_t> {
+    // the vector loops store whole registers past the decoded end
+    assert(dst.size() >= (blk.size() * 3) / 4 + 32);
+    const byte* src{blk.data()};
+    span_size_t size{blk.size()};
+    byte* out{dst.data()};
+#if EAGINE_MSGBUS_BRIDGE_USE_X86_SIMD
+    if(base64_has_avx2()) {
+        if(not base64_decode_avx2(src, size, out)) [[unlikely]] {
+            return {-1};
+        }
+    }
+    if(base64_has_ssse3()) {
+        if(not base64_decode_ssse3(src, size, out)) [[unlikely]] {
+            return {-1};
+        }
+    }
+#endif
+    std::uint32_t bits{0U};
+    span_size_t count{0};
+    for(; size > 0; --size, ++src) {
+        const auto value{base64_values[*src]};
+        if(value < 0) [[unlikely]] {
+            return {-1};
+        }
+        bits = (bits << 6U) | std::uint32_t(value);
+        if(++count == 4) {
+            out[0] = byte((bits >> 16U) & 0xFFU);
+            out[1] = byte((bits >> 8U) & 0xFFU);
+            out[2] = byte(bits & 0xFFU);
+            out += 3;
+            bits = 0U;
+            count = 0;
+        }
+    }
+    if(count > 1) {
+        bits <<= 6U * std::uint32_t(4 - count);
+        out[0] = byte((bits >> 16U) & 0xFFU);
+        if(count > 2) {
+            out[1] = byte((bits >> 8U) & 0xFFU);
+        }
+        out += count - 1;
+    }
+    return {span_size_t(out - dst.data())};
+}
+//------------------------------------------------------------------------------
+// binary framing
+//------------------------------------------------------------------------------
+auto bridge_write_frame(
+  const message_id msg_id,
+  const message_view& message,
+  memory::buffer& scratch,
+  std::vector<byte>& dst) noexcept -> bool {
+    scratch.ensure(compact_message_header::size() + message.data().size());
+    if(const auto serialized{
+         serialize_compact_message(msg_id, message, cover(scratch))})
+      [[likely]] {
+        const auto start{dst.size()};
+        // room for the variable-length size prefix
+        dst.resize(start + std_size(serialized.size() + 8));
+        if(const auto stored{store_data_with_size(
+             serialized, skip(cover(dst), span_size(start)))}) [[likely]] {
+            dst.resize(start + std_size(stored.size()));
+            return true;
+        }
+        dst.resize(start);
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto bridge_frame_size(const memory::const_block prefix) noexcept
+  -> span_size_t {
+    // the size prefix takes at most 8 bytes and every frame is longer
+    return std::max(skip_data_with_size(head(prefix, 8)), span_size_t(0));
+}
+//------------------------------------------------------------------------------
+auto bridge_read_frame(
+  const memory::const_block frame,
+  message_id& msg_id,
+  stored_message& dest) noexcept -> bool {
+    dest.clear_data();
+    return deserialize_compact_message(msg_id, dest, get_data_with_size(frame));
+}
+//------------------------------------------------------------------------------
+// bridge_input_buffer
+//------------------------------------------------------------------------------
+// Holds the bytes read from the input stream but not yet consumed.
+// Data is read in large chunks into the free space after the unread part,
+// the unread part is moved back to the start only when it runs out of room,
+// so the parsed messages are always contiguous.
+class bridge_input_buffer {
+public:
+    auto size() const noexcept -> span_size_t {
+        return _end - _begin;
+    }
+
+    auto top(const span_size_t count) const noexcept -> memory::const_block {
+        return head(skip(view(_storage), _begin), std::min(count, size()));
+    }
+
+    auto scan_for(const byte what) const noexcept
+      -> std::optional<span_size_t> {
+        const auto unread{top(size())};
+        const auto pos{std::find(unread.begin(), unread.end(), what)};
+        if(pos != unread.end()) {
+            return {span_size_t(pos - unread.begin())};
+        }
+        return {};
+    }
+
+    void pop(const span_size_t count) noexcept {
+        _begin = std::min(_begin + count, _end);
+        if(_begin == _end) {
+            _begin = _end = 0;
+        }
+    }
+
+    void clear() noexcept {
+        _begin = _end = 0;
+    }
+
+    auto free_space(const span_size_t min_size) noexcept -> memory::block {
+        if(span_size(_storage.size()) - _end < min_size) {
+            if(_begin > 0) {
+                std::memmove(
+                  _storage.data(), _storage.data() + _begin, std_size(size()));
+                _end -= _begin;
+                _begin = 0;
+            }
+            if(span_size(_storage.size()) - _end < min_size) {
+                _storage.resize(std_size(_end + min_size));
+            }
+        }
+        return skip(cover(_storage), _end);
+    }
+
+    void commit(const span_size_t count) noexcept {
+        _end += count;
+    }
+
+private:
+    std::vector<byte> _storage{};
+    span_size_t _begin{0};
+    span_size_t _end{0};
+};
+//------------------------------------------------------------------------------
 // bridge_state
 //------------------------------------------------------------------------------
 class bridge_state : public std::enable_shared_from_this<bridge_state> {
 public:
-    bridge_state(const valid_if_positive<span_size_t>& max_data_size) noexcept
-      : _max_read{max_data_size.value_or(2048) * 2} {}
+    bridge_state(
+      const valid_if_positive<span_size_t>& max_data_size,
+      const bool binary_framing) noexcept
+      : _max_read{max_data_size.value_or(2048) * 2}
+      , _binary_framing{binary_framing} {}
     bridge_state(bridge_state&&) = delete;
     bridge_state(const bridge_state&) = delete;
     auto operator=(bridge_state&&) = delete;
@@ -46,7 +471,9 @@ public:
     auto make_input_main() noexcept {
         return [selfref{weak_ref()}]() {
             while(auto self{selfref.lock()}) {
-                self->recv_input();
+                if(not self->recv_input()) {
+                    break;
+                }
             }
         };
     }
@@ -81,6 +508,7 @@ public:
     void push(const message_id msg_id, const message_view& message) noexcept {
         const std::unique_lock lock{_output_mutex};
         _outgoing.next().push(msg_id, message);
+        _output_pending = true;
     }
 
     void notify_output_ready() noexcept {
@@ -112,27 +540,42 @@ public:
         return queue.fetch_all(handler);
     }
 
-    void recv_input() noexcept;
+    auto recv_input() noexcept -> bool;
 
 private:
+    auto _write_text(
+      const message_id msg_id,
+      const message_view& message) noexcept -> bool;
+    auto _write_binary(
+      const message_id msg_id,
+      const message_view& message) noexcept -> bool;
     auto _make_send_handler() noexcept;
+    void _flush_output() noexcept;
 
     void _do_recv_input(const span_size_t pos) noexcept;
+    auto _do_recv_line() noexcept -> bool;
+    auto _do_recv_frame() noexcept -> bool;
+    auto _fill_input() noexcept -> bool;
+    auto _mark_input_done() noexcept -> bool;
 
     const span_size_t _max_read;
+    const bool _binary_framing;
+    bool _skip_line{false};
 
     std::mutex _input_mutex{};
     std::mutex _output_mutex{};
 
     std::condition_variable _output_ready{};
+    bool _output_pending{false};
 
     std::istream& _input{std::cin};
     std::ostream& _output{std::cout};
 
-    istream_data_source _source{_input};
-    ostream_data_sink _sink{_output};
+    bridge_input_buffer _source{};
 
     memory::buffer _buffer{};
+    memory::buffer _send_buffer{};
+    std::vector<byte> _pending_output{};
     double_buffer<message_storage> _outgoing{};
     double_buffer<message_storage> _incoming{};
     stored_message _recv_dest{};
@@ -141,28 +584,38 @@ private:
     span_size_t _decode_errors{0};
 };
 //------------------------------------------------------------------------------
+auto bridge_state::_write_text(
+  const message_id msg_id,
+  const message_view& message) noexcept -> bool {
+    _send_buffer.ensure(512);
+    block_data_sink sink{cover(_send_buffer)};
+    default_serializer_backend backend{sink};
+    if(serialize_message_header(msg_id, message, backend)) [[likely]] {
+        const auto header{sink.done()};
+        _pending_output.insert(
+          _pending_output.end(), header.begin(), header.end());
+        bridge_base64_encode(message.data(), _pending_output);
+        _pending_output.push_back(byte('\n'));
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto bridge_state::_write_binary(
+  const message_id msg_id,
+  const message_view& message) noexcept -> bool {
+    return bridge_write_frame(msg_id, message, _send_buffer, _pending_output);
+}
+//------------------------------------------------------------------------------
 auto bridge_state::_make_send_handler() noexcept {
     return [this](
              const message_id msg_id,
              const message_age msg_age,
              message_view message) {
         if(not message.add_age(msg_age).too_old()) [[likely]] {
-            default_serializer_backend backend(_sink);
-            if(serialize_message_header(msg_id, message, backend)) [[likely]] {
-                span_size_t i{0};
-                do_dissolve_bits(
-                  make_span_getter(i, message.data()),
-                  [this](byte b) {
-                      const auto encode{make_base64_encode_transform()};
-                      if(auto opt_c{encode(b)}) [[likely]] {
-                          this->_output << *opt_c;
-                          return true;
-                      }
-                      return false;
-                  },
-                  6);
-
-                _output << '\n' << std::flush;
+            if(
+              _binary_framing ? _write_binary(msg_id, message)
+                              : _write_text(msg_id, message)) [[likely]] {
                 ++_forwarded_messages;
             } else {
                 ++_dropped_messages;
@@ -174,15 +627,54 @@ auto bridge_state::_make_send_handler() noexcept {
     };
 }
 //------------------------------------------------------------------------------
+#if EAGINE_MSGBUS_BRIDGE_USE_POLL
+void bridge_state::_flush_output() noexcept {
+    // the whole batch goes to the output descriptor directly,
+    // bypassing the iostream buffers
+    auto pending{view(_pending_output)};
+    while(not pending.empty()) {
+        const auto written{
+          ::write(STDOUT_FILENO, pending.data(), std_size(pending.size()))};
+        if(written < 0) [[unlikely]] {
+            if(errno == EINTR or errno == EAGAIN) {
+                continue;
+            }
+            const std::unique_lock lock{_output_mutex};
+            _output.setstate(std::ios_base::badbit);
+            break;
+        }
+        pending = skip(pending, span_size(written));
+    }
+    _pending_output.clear();
+}
+#else
+void bridge_state::_flush_output() noexcept {
+    if(not _pending_output.empty()) {
+        _output.write(
+          reinterpret_cast<const char*>(_pending_output.data()),
+          static_cast<std::streamsize>(_pending_output.size()));
+        _output.flush();
+        _pending_output.clear();
+    }
+}
+#endif
+//------------------------------------------------------------------------------
 void bridge_state::send_output() noexcept {
     const auto handler{_make_send_handler()};
     auto& queue{[this]() -> message_storage& {
         std::unique_lock lock{_output_mutex};
-        _output_ready.wait(lock);
+        // the timeout only lets the thread notice that the state was released
+        _output_ready.wait_for(
+          lock, std::chrono::milliseconds(100), [this] {
+              return _output_pending;
+          });
+        _output_pending = false;
         _outgoing.swap();
         return _outgoing.current();
     }()};
+    // the whole batch from one bridge update is written and flushed at once
     queue.fetch_all({construct_from, handler});
+    _flush_output();
 }
 //------------------------------------------------------------------------------
 void bridge_state::_do_recv_input(const span_size_t pos) noexcept {
@@ -194,15 +686,11 @@ void bridge_state::_do_recv_input(const span_size_t pos) noexcept {
 
     if(deserialize_message_header(class_id, method_id, _recv_dest, backend))
       [[likely]] {
-        _buffer.ensure(source.remaining().size());
-        span_size_t i{0};
-        span_size_t o{0};
-        if(do_concentrate_bits(
-             make_span_getter(
-               i, source.remaining(), make_base64_decode_transform()),
-             make_span_putter(o, cover(_buffer)),
-             6)) {
-            _recv_dest.store_content(head(view(_buffer), o));
+        const auto encoded{source.remaining()};
+        _buffer.ensure((encoded.size() * 3) / 4 + 32);
+        if(const auto decoded{bridge_base64_decode(encoded, cover(_buffer))})
+          [[likely]] {
+            _recv_dest.store_content(head(view(_buffer), *decoded));
         }
 
         const std::unique_lock lock{_input_mutex};
@@ -213,12 +701,100 @@ void bridge_state::_do_recv_input(const span_size_t pos) noexcept {
     _source.pop(pos + 1);
 }
 //------------------------------------------------------------------------------
-void bridge_state::recv_input() noexcept {
-    if(const auto pos{_source.scan_for('\n', _max_read)}) {
-        _do_recv_input(*pos);
+auto bridge_state::_do_recv_line() noexcept -> bool {
+    if(const auto pos{_source.scan_for(byte('\n'))}) {
+        if(_skip_line) [[unlikely]] {
+            // the tail of an overlong line
+            _skip_line = false;
+            _source.pop(*pos + 1);
+        } else {
+            _do_recv_input(*pos);
+        }
+        return true;
+    }
+    if(_skip_line) [[unlikely]] {
+        _source.clear();
+    } else if(_source.size() > _max_read) [[unlikely]] {
+        // overlong line, the rest of it is dropped up to the next newline
+        ++_decode_errors;
+        _skip_line = true;
+        _source.clear();
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto bridge_state::_do_recv_frame() noexcept -> bool {
+    const auto frame_size{bridge_frame_size(_source.top(8))};
+    if(frame_size <= 0) {
+        return false;
+    }
+    if(frame_size > _max_read) [[unlikely]] {
+        // a corrupted size prefix, there is no way to find the next frame
+        ++_decode_errors;
+        _source.clear();
+        return _mark_input_done();
+    }
+    const auto frame{_source.top(frame_size)};
+    if(frame.size() < frame_size) {
+        return false;
+    }
+    message_id msg_id{};
+    if(bridge_read_frame(frame, msg_id, _recv_dest)) [[likely]] {
+        const std::unique_lock lock{_input_mutex};
+        _incoming.next().push(msg_id, _recv_dest);
     } else {
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ++_decode_errors;
     }
+    _source.pop(frame_size);
+    return true;
+}
+//------------------------------------------------------------------------------
+auto bridge_state::_mark_input_done() noexcept -> bool {
+    const std::unique_lock lock{_input_mutex};
+    _input.setstate(std::ios_base::eofbit);
+    return false;
+}
+//------------------------------------------------------------------------------
+#if EAGINE_MSGBUS_BRIDGE_USE_POLL
+auto bridge_state::_fill_input() noexcept -> bool {
+    ::pollfd pfd{.fd = STDIN_FILENO, .events = POLLIN, .revents = 0};
+    // the timeout only lets the thread notice that the state was released
+    if(::poll(&pfd, 1, 100) <= 0) {
+        return true;
+    }
+    const auto dst{_source.free_space(std::max(_max_read, span_size(65536)))};
+    const auto done{::read(STDIN_FILENO, dst.data(), std_size(dst.size()))};
+    if(done > 0) [[likely]] {
+        _source.commit(span_size(done));
+    } else if(done == 0 or (errno != EINTR and errno != EAGAIN)) {
+        return _mark_input_done();
+    }
+    return true;
+}
+#else
+auto bridge_state::_fill_input() noexcept -> bool {
+    const auto dst{_source.free_space(std::max(_max_read, span_size(65536)))};
+    auto* ptr{reinterpret_cast<char*>(dst.data())};
+    // block for the first byte, then take whatever else is buffered
+    if(_input.read(ptr, 1)) {
+        _source.commit(
+          1 + span_size(_input.readsome(
+                ptr + 1, static_cast<std::streamsize>(dst.size() - 1))));
+        return true;
+    }
+    return _mark_input_done();
+}
+#endif
+//------------------------------------------------------------------------------
+auto bridge_state::recv_input() noexcept -> bool {
+    bool received{false};
+    while(_binary_framing ? _do_recv_frame() : _do_recv_line()) {
+        received = true;
+    }
+    if(not received) {
+        return input_usable() and _fill_input();
+    }
+    return true;
 }
 //------------------------------------------------------------------------------
 // bridge
@@ -571,7 +1147,7 @@ auto bridge::_check_state() noexcept -> work_done {
         if(_recoverable_state() and _connection) {
             if(const auto max_data_size{_connection->max_data_size()}) {
                 ++_state_count;
-                _state.emplace(*max_data_size);
+                _state.emplace(*max_data_size, _binary_framing);
                 _state->start();
                 something_done();
             }
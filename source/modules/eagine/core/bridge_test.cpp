@@ -0,0 +1,178 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin_ctx.hpp>
+import std;
+import eagine.core;
+import eagine.msgbus.core;
+//------------------------------------------------------------------------------
+// base64
+//------------------------------------------------------------------------------
+void bridge_base64_check_roundtrip(
+  eagitest::case_& test,
+  const std::vector<eagine::byte>& content) {
+    // the bit-by-bit encoding used by the bridge originally
+    std::vector<eagine::byte> expected;
+    eagine::span_size_t i{0};
+    eagine::do_dissolve_bits(
+      eagine::make_span_getter(i, eagine::view(content)),
+      [&](eagine::byte b) {
+          const auto encode{eagine::make_base64_encode_transform()};
+          if(const auto opt_c{encode(b)}) {
+              expected.push_back(eagine::byte(*opt_c));
+              return true;
+          }
+          return false;
+      },
+      6);
+
+    std::vector<eagine::byte> encoded{eagine::byte('#')};
+    eagine::msgbus::bridge_base64_encode(eagine::view(content), encoded);
+    test.ensure(not encoded.empty(), "prefix kept");
+    test.check(encoded.front() == eagine::byte('#'), "prefix ok");
+    const auto chars{eagine::skip(eagine::view(encoded), 1)};
+    test.check(eagine::are_equal(chars, eagine::view(expected)), "encoded ok");
+
+    std::vector<eagine::byte> decoded;
+    decoded.resize((encoded.size() * 3U) / 4U + 32U);
+    const auto size{
+      eagine::msgbus::bridge_base64_decode(chars, eagine::cover(decoded))};
+    test.ensure(bool(size), "decoded");
+    test.check(
+      eagine::are_equal(
+        eagine::head(eagine::view(decoded), *size), eagine::view(content)),
+      "content ok");
+}
+//------------------------------------------------------------------------------
+void bridge_base64_small_sizes(auto& s) {
+    eagitest::case_ test{s, 1, "base64 small sizes"};
+    auto& rg{test.random()};
+
+    std::vector<eagine::byte> content;
+    for(std::size_t size = 0; size <= 128U; ++size) {
+        content.resize(size);
+        rg.fill(content);
+        bridge_base64_check_roundtrip(test, content);
+    }
+}
+//------------------------------------------------------------------------------
+void bridge_base64_random_sizes(unsigned, auto& s) {
+    eagitest::case_ test{s, 2, "base64 random sizes"};
+    auto& rg{test.random()};
+
+    std::vector<eagine::byte> content;
+    content.resize(rg.get_between<std::size_t>(0, 16384));
+    rg.fill(content);
+    bridge_base64_check_roundtrip(test, content);
+}
+//------------------------------------------------------------------------------
+void bridge_base64_invalid(unsigned, auto& s) {
+    eagitest::case_ test{s, 3, "base64 invalid characters"};
+    auto& rg{test.random()};
+
+    std::vector<eagine::byte> content;
+    content.resize(rg.get_between<std::size_t>(1, 1024));
+    rg.fill(content);
+    std::vector<eagine::byte> encoded;
+    eagine::msgbus::bridge_base64_encode(eagine::view(content), encoded);
+
+    const auto pos{rg.get_between<std::size_t>(0, encoded.size() - 1U)};
+    encoded[pos] = eagine::byte(rg.get_between(0, 1) ? '=' : '\n');
+
+    std::vector<eagine::byte> decoded;
+    decoded.resize((encoded.size() * 3U) / 4U + 32U);
+    test.check(
+      not eagine::msgbus::bridge_base64_decode(
+        eagine::view(encoded), eagine::cover(decoded)),
+      "rejected");
+}
+//------------------------------------------------------------------------------
+// binary framing
+//------------------------------------------------------------------------------
+void bridge_binary_framing_roundtrip(unsigned, auto& s) {
+    eagitest::case_ test{s, 4, "binary framing round-trip"};
+    auto& rg{test.random()};
+
+    struct sent_message {
+        eagine::message_id msg_id;
+        eagine::endpoint_id_t source_id;
+        eagine::msgbus::message_sequence_t sequence_no;
+        std::vector<eagine::byte> content;
+    };
+    std::vector<sent_message> sent;
+    std::vector<eagine::byte> stream;
+    eagine::memory::buffer scratch;
+
+    const auto count{rg.get_between<std::size_t>(1, 50)};
+    for(std::size_t i = 0; i < count; ++i) {
+        auto& msg{sent.emplace_back()};
+        msg.msg_id = {eagine::random_identifier(), eagine::random_identifier()};
+        msg.source_id =
+          eagine::endpoint_id_t{eagine::random_identifier().value()};
+        msg.sequence_no =
+          rg.get_between<eagine::msgbus::message_sequence_t>(0U, 1000000U);
+        msg.content.resize(rg.get_between<std::size_t>(0, 4096));
+        rg.fill(msg.content);
+
+        eagine::msgbus::message_view message{eagine::view(msg.content)};
+        message.set_source_id(msg.source_id);
+        message.set_sequence_no(msg.sequence_no);
+        test.ensure(
+          eagine::msgbus::bridge_write_frame(
+            msg.msg_id, message, scratch, stream),
+          "written");
+    }
+
+    eagine::memory::const_block unread{eagine::view(stream)};
+    eagine::msgbus::stored_message dest;
+    for(const auto& msg : sent) {
+        const auto frame_size{eagine::msgbus::bridge_frame_size(unread)};
+        test.ensure(frame_size > 0, "frame size");
+        test.ensure(frame_size <= unread.size(), "frame complete");
+        // a partially received frame reports the same size
+        test.check_equal(
+          eagine::msgbus::bridge_frame_size(eagine::head(unread, 8)),
+          frame_size,
+          "size from prefix");
+
+        eagine::message_id msg_id{};
+        test.ensure(
+          eagine::msgbus::bridge_read_frame(
+            eagine::head(unread, frame_size), msg_id, dest),
+          "read");
+        test.check(msg_id == msg.msg_id, "message id ok");
+        test.check(dest.source_id == msg.source_id, "source ok");
+        test.check(dest.sequence_no == msg.sequence_no, "sequence ok");
+        test.check(
+          eagine::are_equal(eagine::view(msg.content), dest.const_content()),
+          "content ok");
+        unread = eagine::skip(unread, frame_size);
+    }
+    test.check(unread.empty(), "all read");
+    test.check_equal(
+      eagine::msgbus::bridge_frame_size(unread),
+      eagine::span_size_t(0),
+      "no frame");
+}
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+auto test_main(eagine::test_ctx& ctx) -> int {
+    eagitest::ctx_suite test{ctx, "bridge", 4};
+    test.once(bridge_base64_small_sizes);
+    test.repeat(100, bridge_base64_random_sizes);
+    test.repeat(100, bridge_base64_invalid);
+    test.repeat(20, bridge_binary_framing_roundtrip);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    return eagine::test_main_impl(argc, argv, test_main);
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end_ctx.hpp>
@@ -259,6 +259,9 @@ void connection_setup_configure(
     if(config.is_set("msgbus.posix_mqueue")) {
         setup.add_factory(make_posix_mqueue_connection_factory(setup));
     }
+    if(config.is_set("msgbus.posix_shmem")) {
+        setup.add_factory(make_posix_shmem_connection_factory(setup));
+    }
     if(config.is_set("msgbus.direct")) {
         setup.add_factory(make_direct_connection_factory(setup));
     }
@@ -24,9 +24,16 @@ struct context_remote_node {
     memory::buffer cert_pem;
     sslplus::owned_x509 cert{};
     sslplus::owned_pkey pubkey{};
+    memory::buffer session_key;
     bool verified_key{false};
 };
 //------------------------------------------------------------------------------
+struct context_session_key {
+    memory::buffer key;
+    message_mac confirmation{};
+    bool acknowledged{false};
+};
+//------------------------------------------------------------------------------
 /// @brief Class holding common message bus utility objects.
 /// @ingroup msgbus
 export class context : main_ctx_object {
@@ -137,6 +144,55 @@ public:
     /// @brief Indicates if the private key of a remote node was verified.
     auto verified_remote_key(const endpoint_id_t) const noexcept -> bool;
 
+    /// @brief Derives the session key for messages to a remote node.
+    /// @see get_own_session_key
+    /// @see add_remote_session_salt
+    /// @see confirm_own_session_key
+    ///
+    /// The key is bound to the nonce sent by the remote node in the
+    /// certificate exchange. Returns our salt signed with the private key,
+    /// that should be sent to the remote node. Empty if no shared session
+    /// password is configured or if the salt cannot be signed.
+    /// The key is not used until the remote node acknowledges it.
+    auto make_own_session_key(
+      const endpoint_id_t node_id,
+      const memory::const_block nonce) noexcept -> memory::const_block;
+
+    /// @brief Marks the session key for a remote node as acknowledged.
+    /// @see make_own_session_key
+    /// @see add_remote_session_salt
+    ///
+    /// The acknowledgement is the authentication code of the salt and
+    /// nonce computed by the remote node with the key it derived.
+    auto confirm_own_session_key(
+      const endpoint_id_t node_id,
+      const memory::const_block acknowledgement) noexcept -> bool;
+
+    /// @brief Returns the key used to sign messages to a remote node with a MAC.
+    /// @see make_own_session_key
+    /// @see confirm_own_session_key
+    /// Empty if there is no acknowledged session key for the specified node.
+    auto get_own_session_key(const endpoint_id_t node_id) const noexcept
+      -> memory::const_block;
+
+    /// @brief Verifies the signed salt from a remote node and derives its key.
+    /// @see make_own_session_key
+    /// @see confirm_own_session_key
+    /// @see verify_remote_mac
+    ///
+    /// Returns the acknowledgement that should be sent back to the remote
+    /// node, if the key was derived.
+    auto add_remote_session_salt(
+      const endpoint_id_t node_id,
+      const memory::const_block signed_salt) noexcept
+      -> std::optional<message_mac>;
+
+    /// @brief Computes the HMAC-SHA256 authentication code of the data.
+    /// @see verify_remote_mac
+    auto compute_message_mac(
+      const memory::const_block key,
+      const memory::const_block data) noexcept -> std::optional<message_mac>;
+
     /// @brief Returns the default message digest type.
     auto default_message_digest() noexcept
       -> decltype(ssl().message_digest_sha256());
@@ -167,7 +223,23 @@ public:
       const memory::const_block sig,
       const endpoint_id_t) noexcept -> bool;
 
+    /// @brief Verifies the authentication code of a message from a remote node.
+    /// @see add_remote_session_salt
+    ///
+    /// Only the message content is reported as verified, the session key
+    /// is derived from a password shared by the bus nodes and does not prove
+    /// the identity of the node the way a signature does.
+    auto verify_remote_mac(
+      const memory::const_block data,
+      const memory::const_block mac,
+      const endpoint_id_t) noexcept -> verification_bits;
+
 private:
+    auto _derive_session_key(
+      const memory::const_block salt,
+      const memory::const_block nonce,
+      memory::buffer& key) noexcept -> bool;
+
     //
     std::mt19937_64 _rand_engine{std::random_device{}()};
     flat_map<message_id, message_sequence_t> _msg_id_seq{};
@@ -175,6 +247,10 @@ private:
     memory::buffer _scratch_space{};
     memory::buffer _own_cert_pem{};
     memory::buffer _ca_cert_pem{};
+    std::array<byte, 32> _own_session_salt{};
+    memory::buffer _own_session_salt_msg{};
+    memory::buffer _session_key_input{};
+    flat_map<endpoint_id_t, context_session_key> _own_session_keys{};
     //
     sslplus::ssl_api _ssl{*this};
     sslplus::owned_engine _ssl_engine{};
@@ -28,6 +28,24 @@ context::context(main_ctx_parent parent) noexcept
         log_error("failed to create certificate store: ${reason}")
           .arg("reason", (not make_result).message());
     }
+    fill_with_random_bytes(cover(_own_session_salt), _rand_engine);
+}
+//------------------------------------------------------------------------------
+auto context::_derive_session_key(
+  const memory::const_block salt,
+  const memory::const_block nonce,
+  memory::buffer& key) noexcept -> bool {
+    // the key depends on the salt of the sending node and the nonce
+    // that the receiving node generated for the sender
+    _session_key_input.resize(salt.size() + nonce.size());
+    memory::copy(salt, cover(_session_key_input));
+    memory::copy(nonce, skip(cover(_session_key_input), salt.size()));
+    if(main_context().encrypt_shared_password(
+         view(_session_key_input), "msgbus.session.password", key)) {
+        return true;
+    }
+    key.clear();
+    return false;
 }
 //------------------------------------------------------------------------------
 context::~context() noexcept {
@@ -209,6 +227,119 @@ auto context::verified_remote_key(const endpoint_id_t node_id) const noexcept
       .or_false();
 }
 //------------------------------------------------------------------------------
+auto context::make_own_session_key(
+  const endpoint_id_t node_id,
+  const memory::const_block nonce) noexcept -> memory::const_block {
+    if(not nonce) {
+        return {};
+    }
+    // a new nonce exchange replaces the previous key, the messages
+    // are signed with the private key until the new one is acknowledged
+    auto& session{_own_session_keys[node_id]};
+    session.acknowledged = false;
+    if(not _derive_session_key(view(_own_session_salt), nonce, session.key)) {
+        _own_session_keys.erase(node_id);
+        return {};
+    }
+    if(const auto confirmation{
+         compute_message_mac(view(session.key), view(_session_key_input))}) {
+        session.confirmation = *confirmation;
+    } else {
+        _own_session_keys.erase(node_id);
+        return {};
+    }
+    // the signature binds the salt to the nonce of the remote node
+    // and proves that it comes from the owner of our certificate
+    if(const auto signature{get_own_signature(view(_session_key_input))}) {
+        const auto salt{view(_own_session_salt)};
+        _own_session_salt_msg.resize(salt.size() + signature.size());
+        memory::copy(salt, cover(_own_session_salt_msg));
+        memory::copy(
+          signature, skip(cover(_own_session_salt_msg), salt.size()));
+        return view(_own_session_salt_msg);
+    }
+    _own_session_keys.erase(node_id);
+    return {};
+}
+//------------------------------------------------------------------------------
+static auto equal_message_macs(
+  const message_mac& expected,
+  const memory::const_block mac) noexcept -> bool {
+    if(mac.size() != message_mac_size) {
+        return false;
+    }
+    // compared in constant time
+    std::uint8_t diff{0U};
+    for(span_size_t i = 0; i < message_mac_size; ++i) {
+        diff |= std::uint8_t(expected[std_size(i)] ^ mac[i]);
+    }
+    return diff == 0U;
+}
+//------------------------------------------------------------------------------
+auto context::confirm_own_session_key(
+  const endpoint_id_t node_id,
+  const memory::const_block acknowledgement) noexcept -> bool {
+    if(const auto session{find(_own_session_keys, node_id)}) {
+        if(equal_message_macs(session->confirmation, acknowledgement)) {
+            session->acknowledged = true;
+            log_debug("using session key for messages to ${nodeId}")
+              .arg("nodeId", node_id);
+            return true;
+        }
+        log_warning("invalid session key acknowledgement from ${nodeId}")
+          .arg("nodeId", node_id);
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto context::get_own_session_key(const endpoint_id_t node_id) const noexcept
+  -> memory::const_block {
+    if(const auto session{find(_own_session_keys, node_id)}) {
+        if(session->acknowledged) {
+            return view(session->key);
+        }
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+auto context::add_remote_session_salt(
+  const endpoint_id_t node_id,
+  const memory::const_block signed_salt) noexcept
+  -> std::optional<message_mac> {
+    const auto salt_size{span_size(_own_session_salt.size())};
+    // only nodes with a verified certificate get a session key
+    if(const auto info{find(_remotes, node_id)};
+       info and (signed_salt.size() > salt_size)) {
+        if(info->pubkey) {
+            memory::buffer key;
+            const bool derived{_derive_session_key(
+              head(signed_salt, salt_size), view(info->nonce), key)};
+            const auto verified{verify_remote_signature(
+              view(_session_key_input),
+              skip(signed_salt, salt_size),
+              node_id,
+              false)};
+            if(verified.has(verification_bit::message_content)) {
+                if(derived) {
+                    // proves to the remote node that we derived the same key
+                    auto acknowledgement{
+                      compute_message_mac(view(key), view(_session_key_input))};
+                    if(acknowledgement) {
+                        info->session_key = std::move(key);
+                    }
+                    return acknowledgement;
+                }
+                log_debug("failed to derive remote node session key")
+                  .arg("nodeId", node_id);
+            } else {
+                log_warning("invalid signature of remote node session salt")
+                  .arg("nodeId", node_id);
+            }
+        }
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
 auto context::default_message_digest() noexcept
   -> decltype(_ssl.message_digest_sha256()) {
     return _ssl.message_digest_sha256();
@@ -339,6 +470,87 @@ auto context::verify_remote_signature(
     return false;
 }
 //------------------------------------------------------------------------------
+auto context::compute_message_mac(
+  const memory::const_block key,
+  const memory::const_block data) noexcept -> std::optional<message_mac> {
+    // HMAC (RFC 2104) over the SHA-256 digest of the ssl engine
+    constexpr const std::size_t block_size{64U};
+    if(ok md_type{default_message_digest()}) {
+        if(ok md_ctx{_ssl.new_message_digest()}) {
+            auto cleanup{_ssl.delete_message_digest.raii(md_ctx)};
+
+            std::array<byte, block_size> key_block{};
+            if(key.size() > span_size(block_size)) {
+                if(not(_ssl.message_digest_init(md_ctx, md_type) and
+                       _ssl.message_digest_update(md_ctx, key) and
+                       _ssl.message_digest_final(md_ctx, cover(key_block))))
+                  [[unlikely]] {
+                    return {};
+                }
+            } else {
+                std::copy(key.begin(), key.end(), key_block.begin());
+            }
+
+            auto pad_key{[&](const byte pad) {
+                auto padded{key_block};
+                for(auto& b : padded) {
+                    b ^= pad;
+                }
+                return padded;
+            }};
+
+            message_mac inner{};
+            message_mac outer{};
+            if(
+              _ssl.message_digest_init(md_ctx, md_type) and
+              _ssl.message_digest_update(md_ctx, view(pad_key(byte(0x36U)))) and
+              _ssl.message_digest_update(md_ctx, data) and
+              _ssl.message_digest_final(md_ctx, cover(inner)) and
+              _ssl.message_digest_init(md_ctx, md_type) and
+              _ssl.message_digest_update(md_ctx, view(pad_key(byte(0x5cU)))) and
+              _ssl.message_digest_update(md_ctx, view(inner)) and
+              _ssl.message_digest_final(md_ctx, cover(outer))) [[likely]] {
+                return outer;
+            }
+            log_debug("failed to compute message authentication code");
+        } else {
+            log_debug("failed to create ssl message digest")
+              .arg("reason", (not md_ctx).message());
+        }
+    } else {
+        log_debug("failed to get ssl message digest type")
+          .arg("reason", (not md_type).message());
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+auto context::verify_remote_mac(
+  const memory::const_block content,
+  const memory::const_block mac,
+  const endpoint_id_t node_id) noexcept -> verification_bits {
+    verification_bits result{};
+
+    if(content and mac.size() == message_mac_size) {
+        if(const auto info{find(_remotes, node_id)}) {
+            if(not info->session_key.empty()) {
+                if(const auto expected{
+                     compute_message_mac(view(info->session_key), content)}) {
+                    if(equal_message_macs(*expected, mac)) {
+                        result |= verification_bit::message_content;
+                    } else {
+                        log_debug("message authentication code mismatch")
+                          .arg("nodeId", node_id);
+                    }
+                }
+            } else {
+                log_debug("no session key for remote node ${endpoint}")
+                  .arg("endpoint", node_id);
+            }
+        }
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
 auto make_context(main_ctx_parent parent) -> shared_holder<context> {
     return {default_selector, parent};
 }
@@ -23,6 +23,7 @@ export import :invoker;
 export import :skeleton;
 export import :subscriber;
 export import :actor;
+export import :routing_table;
 export import :router;
 export import :bridge;
 export import :mqtt_bridge;
@@ -62,6 +62,9 @@ public:
       const message_view& message) noexcept {
         const std::unique_lock lock{_client_to_server_lock};
         _client_to_server.next().push(msg_id, message);
+        if(_server_readiness) {
+            _server_readiness->notify();
+        }
     }
 
     /// @brief Sends a message to the client counterpart.
@@ -71,11 +74,30 @@ public:
         if(_client_connected) [[likely]] {
             const std::unique_lock lock{_server_to_client_lock};
             _server_to_client.next().push(msg_id, message);
+            if(_client_readiness) {
+                _client_readiness->notify();
+            }
             return true;
         }
         return false;
     }
 
+    /// @brief Sets the readiness notified when the client sends a message.
+    auto server_prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept -> bool {
+        const std::unique_lock lock{_client_to_server_lock};
+        _server_readiness = readiness;
+        return _client_to_server.next().empty();
+    }
+
+    /// @brief Sets the readiness notified when the server sends a message.
+    auto client_prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept -> bool {
+        const std::unique_lock lock{_server_to_client_lock};
+        _client_readiness = readiness;
+        return _server_to_client.next().empty();
+    }
+
     /// @brief Fetches received messages from the client counterpart.
     auto fetch_from_client(const connection::fetch_handler handler) noexcept
       -> std::tuple<bool, bool> {
@@ -103,6 +125,246 @@ private:
     Lockable _client_to_server_lock;
     double_buffer<message_storage> _server_to_client;
     double_buffer<message_storage> _client_to_server;
+    shared_holder<connection_readiness> _server_readiness;
+    shared_holder<connection_readiness> _client_readiness;
+    std::atomic<bool> _server_connected{true};
+    std::atomic<bool> _client_connected{false};
+};
+//------------------------------------------------------------------------------
+/// @brief Tag type selecting the lock-free implementation of direct connections.
+/// @ingroup msgbus
+/// @see make_direct_lock_free_acceptor
+/// @see make_direct_lock_free_connection_factory
+export struct direct_lock_free {};
+//------------------------------------------------------------------------------
+/// @brief Single-producer, single-consumer queue of messages in one direction.
+/// @ingroup msgbus
+/// @note Implementation detail. Do not use directly.
+///
+/// The messages are copied into a fixed ring of slots which keep their content
+/// buffers between uses and the consumer gets views of the messages in place.
+/// Pushing into and fetching from the ring is wait-free. If the ring is full
+/// the messages go through a locked overflow storage until the consumer
+/// catches up, so no messages are lost and their order is kept.
+class direct_message_ring {
+public:
+    direct_message_ring(const span_size_t capacity) noexcept
+      : _slots(std::bit_ceil(std_size(std::max(capacity, span_size_t(2)))))
+      , _mask{_slots.size() - 1U} {}
+
+    /// @brief Copies a message into the queue.
+    /// @note Must be called by one producer at a time.
+    void push(const message_id msg_id, const message_view& message) noexcept {
+        if(_overflowed.load(std::memory_order_acquire)) [[unlikely]] {
+            const std::unique_lock lock{_overflow_lock};
+            if(_overflowed.load(std::memory_order_relaxed)) {
+                _overflow.push(msg_id, message);
+                _notify();
+                return;
+            }
+        }
+        if(not _try_push(msg_id, message)) [[unlikely]] {
+            const std::unique_lock lock{_overflow_lock};
+            _overflow.push(msg_id, message);
+            _overflowed.store(true, std::memory_order_release);
+        }
+        _notify();
+    }
+
+    /// @brief Sets the readiness notified when a message is pushed.
+    /// Returns true if there are no messages to be fetched.
+    /// @note Must be called by the consumer.
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept -> bool {
+        if(readiness.get() != _readiness_ptr.load(std::memory_order_relaxed))
+          [[unlikely]] {
+            // the producer may still be notifying the previous readiness
+            if(_readiness) {
+                _retired_readiness.push_back(std::move(_readiness));
+            }
+            _readiness = readiness;
+            _readiness_ptr.store(_readiness.get(), std::memory_order_seq_cst);
+        }
+        if(not _retired_readiness.empty()) [[unlikely]] {
+            // a notification started after the readiness pointer was replaced
+            // uses the current one, so if there is no notification in progress
+            // the producer cannot observe the retired ones any more
+            if(not _notifying.load(std::memory_order_seq_cst)) {
+                _retired_readiness.clear();
+            }
+        }
+        return _ring_empty() and not _overflowed.load(std::memory_order_acquire);
+    }
+
+    /// @brief Calls the handler on the queued messages in the order of pushing.
+    /// @note Must be called by one consumer at a time.
+    auto fetch_all(const connection::fetch_handler handler) noexcept -> bool {
+        some_true something_done{_deferred.fetch_all(handler)};
+        something_done(_fetch_ring(handler));
+        if(_overflowed.load(std::memory_order_acquire)) [[unlikely]] {
+            // the producer does not push into the ring any more,
+            // so what is left there is older than the overflown messages
+            something_done(_fetch_ring(handler));
+            const std::unique_lock lock{_overflow_lock};
+            something_done(_overflow.fetch_all(handler));
+            if(_overflow.empty()) {
+                _overflowed.store(false, std::memory_order_release);
+            }
+        }
+        return something_done;
+    }
+
+private:
+    struct _slot {
+        message_id msg_id;
+        stored_message message;
+        message_timestamp insert_time;
+    };
+
+    auto _ring_empty() const noexcept -> bool {
+        return _head.load(std::memory_order_acquire) ==
+               _tail.load(std::memory_order_acquire);
+    }
+
+    auto _try_push(const message_id msg_id, const message_view& message) noexcept
+      -> bool {
+        const auto tail{_tail.load(std::memory_order_relaxed)};
+        if(tail - _head.load(std::memory_order_acquire) > _mask) {
+            return false;
+        }
+        auto& slot{_slots[tail & _mask]};
+        slot.msg_id = msg_id;
+        slot.message = stored_message{message, slot.message.release_buffer()};
+        slot.insert_time = message_timestamp_now();
+        _tail.store(tail + 1U, std::memory_order_release);
+        return true;
+    }
+
+    auto _fetch_ring(const connection::fetch_handler handler) noexcept -> bool {
+        bool fetched_some{false};
+        auto head{_head.load(std::memory_order_relaxed)};
+        const auto tail{_tail.load(std::memory_order_acquire)};
+        const auto now{message_timestamp_now()};
+        while(head != tail) {
+            auto& slot{_slots[head & _mask]};
+            const auto msg_age{message_age_since(slot.insert_time, now)};
+            if(handler(slot.msg_id, msg_age, slot.message)) [[likely]] {
+                fetched_some = true;
+            } else {
+                _deferred.push(slot.msg_id, slot.message);
+            }
+            // the slot can be reused by the producer from now on
+            _head.store(++head, std::memory_order_release);
+        }
+        return fetched_some;
+    }
+
+    void _notify() noexcept {
+        _notifying.store(true, std::memory_order_seq_cst);
+        if(const auto readiness{_readiness_ptr.load(std::memory_order_seq_cst)})
+          [[likely]] {
+            readiness->notify();
+        }
+        _notifying.store(false, std::memory_order_release);
+    }
+
+    std::vector<_slot> _slots;
+    const std::size_t _mask;
+    alignas(64) std::atomic<std::size_t> _head{0U};
+    alignas(64) std::atomic<std::size_t> _tail{0U};
+    alignas(64) std::atomic<bool> _overflowed{false};
+    std::atomic<connection_readiness*> _readiness_ptr{nullptr};
+    std::atomic<bool> _notifying{false};
+    spinlock _overflow_lock;
+    message_storage _overflow;
+    message_storage _deferred;
+    shared_holder<connection_readiness> _readiness;
+    std::vector<shared_holder<connection_readiness>> _retired_readiness;
+};
+//------------------------------------------------------------------------------
+/// @brief Common shared state for a lock-free direct connection.
+/// @ingroup msgbus
+/// @note Implementation detail. Do not use directly.
+///
+/// Each direction uses a single-producer, single-consumer message ring.
+/// The router and the endpoints serialize sending and fetching on a single
+/// connection, which is what this implementation requires.
+template <>
+class direct_connection_state<direct_lock_free> final : public main_ctx_object {
+public:
+    /// @brief Construction from a parent main context object.
+    direct_connection_state(main_ctx_parent parent) noexcept
+      : main_ctx_object{"DrctConnSt", parent}
+      , _server_to_client{_ring_size}
+      , _client_to_server{_ring_size} {}
+
+    /// @brief Says that the server has disconnected.
+    auto server_disconnect() noexcept {
+        _server_connected = false;
+    }
+
+    /// @brief Says that the client has connected.
+    auto client_connect() noexcept {
+        _client_connected = true;
+    }
+
+    /// @brief Says that the client has disconnected.
+    auto client_disconnect() noexcept {
+        _client_connected = false;
+    }
+
+    /// @brief Indicates if the connection state is usable.
+    auto is_usable() const noexcept -> bool {
+        return _server_connected;
+    }
+
+    /// @brief Sends a message to the server counterpart.
+    void send_to_server(
+      const message_id msg_id,
+      const message_view& message) noexcept {
+        _client_to_server.push(msg_id, message);
+    }
+
+    /// @brief Sends a message to the client counterpart.
+    auto send_to_client(
+      const message_id msg_id,
+      const message_view& message) noexcept -> bool {
+        if(_client_connected) [[likely]] {
+            _server_to_client.push(msg_id, message);
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Sets the readiness notified when the client sends a message.
+    auto server_prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept -> bool {
+        return _client_to_server.prepare_wait(readiness);
+    }
+
+    /// @brief Sets the readiness notified when the server sends a message.
+    auto client_prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept -> bool {
+        return _server_to_client.prepare_wait(readiness);
+    }
+
+    /// @brief Fetches received messages from the client counterpart.
+    auto fetch_from_client(const connection::fetch_handler handler) noexcept
+      -> std::tuple<bool, bool> {
+        return {_client_to_server.fetch_all(handler), _client_connected};
+    }
+
+    /// @brief Fetches received messages from the service counterpart.
+    auto fetch_from_server(const connection::fetch_handler handler) noexcept
+      -> bool {
+        return _server_to_client.fetch_all(handler);
+    }
+
+private:
+    const span_size_t _ring_size{
+      cfg_init("msgbus.direct.ring_size", span_size_t(1024))};
+    direct_message_ring _server_to_client;
+    direct_message_ring _client_to_server;
     std::atomic<bool> _server_connected{true};
     std::atomic<bool> _client_connected{false};
 };
@@ -132,24 +394,42 @@ public:
     /// @see process_all
     auto connect() noexcept -> shared_state {
         shared_state state{default_selector, *this};
+        const std::unique_lock lock{_pending_lock};
         _pending.push_back(state);
+        if(_readiness) {
+            _readiness->notify();
+        }
         return state;
     }
 
+    /// @brief Sets the readiness notified when a client connects.
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept -> bool {
+        const std::unique_lock lock{_pending_lock};
+        _readiness = readiness;
+        return _pending.empty();
+    }
+
     /// @brief Handles the pending server counterparts for created client connections.
     /// @see connect
     auto process_all(const process_handler handler) noexcept -> work_done {
         some_true something_done{};
-        for(auto& state : _pending) {
+        small_vector<shared_state, 4> pending;
+        {
+            const std::unique_lock lock{_pending_lock};
+            std::swap(pending, _pending);
+        }
+        for(auto& state : pending) {
             handler(state);
             something_done();
         }
-        _pending.clear();
         return something_done;
     }
 
 private:
+    std::mutex _pending_lock;
     small_vector<shared_state, 4> _pending;
+    shared_holder<connection_readiness> _readiness;
 };
 //------------------------------------------------------------------------------
 /// @brief Implementation of the connection_info interface for direct connections.
@@ -236,6 +516,15 @@ public:
         return 0.5F;
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        if(_state) [[likely]] {
+            return _state->client_prepare_wait(readiness);
+        }
+        return false;
+    }
+
     void cleanup() noexcept final {}
 
 private:
@@ -313,6 +602,15 @@ public:
         return 0.5F;
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        if(_state) [[likely]] {
+            return _state->server_prepare_wait(readiness);
+        }
+        return false;
+    }
+
 private:
     shared_holder<direct_connection_state<Lockable>> _state;
     bool _is_usable{true};
@@ -358,6 +656,15 @@ public:
         return something_done;
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        if(_address) {
+            return _address->prepare_wait(readiness);
+        }
+        return false;
+    }
+
     /// @brief Makes a new client-side direct connection.
     auto make_connection() noexcept -> shared_holder<connection> final {
         if(_address) {
@@ -435,5 +742,19 @@ export auto make_direct_connection_factory(main_ctx_parent parent)
     return {default_selector, parent};
 }
 //------------------------------------------------------------------------------
+/// @brief Makes an acceptor for lock-free direct connections.
+/// @see direct_lock_free
+export auto make_direct_lock_free_acceptor(main_ctx_parent parent)
+  -> unique_holder<direct_acceptor_intf> {
+    return {hold<direct_acceptor<direct_lock_free>>, parent};
+}
+//------------------------------------------------------------------------------
+/// @brief Makes a connection factory for lock-free direct connections.
+/// @see direct_lock_free
+export auto make_direct_lock_free_connection_factory(main_ctx_parent parent)
+  -> unique_holder<direct_connection_factory<direct_lock_free>> {
+    return {default_selector, parent};
+}
+//------------------------------------------------------------------------------
 } // namespace eagine::msgbus
 
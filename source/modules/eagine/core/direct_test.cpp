@@ -187,14 +187,80 @@ void direct_roundtrip_thread(auto& s) {
     test.check(hashes.empty(), "all hashes checked");
 }
 //------------------------------------------------------------------------------
+void direct_lock_free_order_thread(auto& s) {
+    eagitest::case_ test{s, 5, "lock-free order thread"};
+    eagitest::track trck{test, 0, 1};
+    auto& rg{test.random()};
+
+    auto fact{
+      eagine::msgbus::make_direct_lock_free_connection_factory(s.context())};
+    test.ensure(bool(fact), "has factory");
+    auto cacc{
+      fact->make_acceptor(eagine::identifier{"test"})
+        .as(std::type_identity<eagine::msgbus::direct_acceptor_intf>{})};
+    test.ensure(bool(cacc), "has acceptor");
+    auto read_conn{cacc->make_connection()};
+    test.ensure(bool(read_conn), "has read connection");
+
+    eagine::shared_holder<eagine::msgbus::connection> write_conn;
+    cacc->process_accepted(
+      {eagine::construct_from,
+       [&](eagine::shared_holder<eagine::msgbus::connection> conn) {
+           write_conn = std::move(conn);
+       }});
+    test.ensure(bool(write_conn), "has write connection");
+
+    const eagine::message_id test_msg_id{"test", "method"};
+    const auto count{
+      rg.get_between<eagine::msgbus::message_sequence_t>(1000, 50000)};
+
+    std::thread reader{[&] {
+        eagine::msgbus::message_sequence_t expected{0};
+        while(expected < count) {
+            read_conn->fetch_messages(
+              {eagine::construct_from,
+               [&](
+                 const eagine::message_id msg_id,
+                 const eagine::msgbus::message_age,
+                 const eagine::msgbus::message_view& msg) -> bool {
+                   test.check(msg_id == test_msg_id, "message id");
+                   // messages arrive in the order they were sent
+                   test.check_equal(msg.sequence_no, expected, "in order");
+                   test.check_equal(
+                     msg.content().size(),
+                     eagine::span_size(expected % 1024U),
+                     "content size");
+                   expected = msg.sequence_no + 1U;
+                   trck.checkpoint(1);
+                   return true;
+               }});
+            // let the ring overflow now and then
+            if(expected % 7U == 0U) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        }
+    }};
+
+    std::vector<eagine::byte> src;
+    for(eagine::msgbus::message_sequence_t seq = 0; seq < count; ++seq) {
+        src.resize(seq % 1024U);
+        rg.fill(src);
+        eagine::msgbus::message_view message{eagine::view(src)};
+        message.set_sequence_no(seq);
+        test.check(write_conn->send(test_msg_id, message), "sent");
+    }
+    reader.join();
+}
+//------------------------------------------------------------------------------
 // main
 //------------------------------------------------------------------------------
 auto test_main(eagine::test_ctx& ctx) -> int {
-    eagitest::ctx_suite test{ctx, "direct connection", 4};
+    eagitest::ctx_suite test{ctx, "direct connection", 5};
     test.once(direct_type_id);
     test.once(direct_addr_kind);
     test.once(direct_roundtrip);
     test.once(direct_roundtrip_thread);
+    test.once(direct_lock_free_order_thread);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------
@@ -152,6 +152,12 @@ public:
     /// @brief Updates the internal state, sends and receives pending messages.
     auto update() noexcept -> work_done;
 
+    /// @brief Waits until there is incoming work or the timeout expires.
+    /// @see connection_readiness
+    /// If the connection cannot signal incoming data, this just sleeps.
+    auto wait_for_work(const std::chrono::microseconds timeout) noexcept
+      -> bool;
+
     /// @brief Says to the message bus that this endpoint is disconnecting.
     void finish() noexcept {
         say_bye();
@@ -189,10 +195,25 @@ public:
 
     /// @brief Signs and enqueues a message with the specified id/type for sending.
     /// @see post
+    /// @see post_authenticated
     /// @see post_value
+    ///
+    /// The message is signed with the private key of this endpoint.
     auto post_signed(const message_id, const message_view message) noexcept
       -> bool;
 
+    /// @brief Authenticates and enqueues a message with the specified id/type.
+    /// @see post_signed
+    ///
+    /// If the target acknowledged a session key, the message is signed with
+    /// a cheaper MAC instead of the private key. The receiver verifies only
+    /// the message_content bit of such messages, so this should not be used
+    /// for messages that require the source_certificate or
+    /// source_private_key verification bits.
+    auto post_authenticated(
+      const message_id,
+      const message_view message) noexcept -> bool;
+
     /// @brief Serializes the specified value and enqueues it for sending in message.
     /// @see post
     /// @see post_signed
@@ -432,6 +453,17 @@ public:
         return _ensure_incoming(msg_id).queue;
     }
 
+    /// @brief Alias for received message queue visitor callable reference.
+    /// @see visit_dirty_queues
+    using queue_visitor = callable_ref<void(message_priority_queue&) noexcept>;
+
+    /// @brief Calls the visitor on the queues that received messages.
+    /// @see ensure_queue
+    ///
+    /// Queues that are still not empty after the visit are visited again
+    /// on the next call, the others only after they receive new messages.
+    void visit_dirty_queues(const queue_visitor visitor) noexcept;
+
     /// @brief Returns the average message age in the connected router.
     /// @see flow_congestion
     auto flow_average_message_age() const noexcept {
@@ -484,16 +516,30 @@ private:
       nothing};
 
     shared_holder<connection> _connection{};
+    shared_holder<connection_readiness> _readiness{default_selector};
     bool _had_working_connection{false};
 
     message_storage _outgoing{};
 
     struct incoming_state {
         span_size_t subscription_count{0};
+        bool is_dirty{false};
         message_priority_queue queue{};
     };
 
     flat_map<message_id, unique_holder<incoming_state>> _incoming{};
+    // open-addressing index of _incoming rebuilt when the states change
+    std::vector<std::tuple<message_id, incoming_state*>> _incoming_index{};
+    // states whose queues received messages since they were last visited
+    std::vector<incoming_state*> _dirty_incoming{};
+
+    static auto _incoming_hash(const message_id msg_id) noexcept
+      -> std::size_t;
+    void _rebuild_incoming_index() noexcept;
+    void _push_incoming(
+      incoming_state&,
+      const message_view&,
+      const message_age) noexcept;
 
     auto _declare_states() noexcept;
 
@@ -509,7 +555,8 @@ private:
       *this,
       msgbus_id{"blobFrgmnt"},
       msgbus_id{"blobResend"},
-      msgbus_id{"blobPrpare"}};
+      msgbus_id{"blobPrpare"},
+      msgbus_id{"blobFrgAck"}};
 
     auto _process_blobs() noexcept -> work_done;
 
@@ -542,6 +589,8 @@ private:
       -> message_handling_result;
     auto _handle_blob_prepare(const message_view&) noexcept
       -> message_handling_result;
+    auto _handle_blob_ack(const message_view&) noexcept
+      -> message_handling_result;
     auto _handle_flow_info(const message_view&) noexcept
       -> message_handling_result;
     auto _handle_certificate_query(const message_view&) noexcept
@@ -554,6 +603,10 @@ private:
       -> message_handling_result;
     auto _handle_signed_nonce(const message_view&) noexcept
       -> message_handling_result;
+    auto _handle_session_salt(const message_view&) noexcept
+      -> message_handling_result;
+    auto _handle_session_ack(const message_view&) noexcept
+      -> message_handling_result;
     auto _handle_topology_query(const message_view&) noexcept
       -> message_handling_result;
     auto _handle_stats_query(const message_view&) noexcept
@@ -586,6 +639,8 @@ private:
       , _connection{std::move(temp._connection)}
       , _outgoing{std::move(temp._outgoing)}
       , _incoming{std::move(temp._incoming)}
+      , _incoming_index{std::move(temp._incoming_index)}
+      , _dirty_incoming{std::move(temp._dirty_incoming)}
       , _blobs{std::move(temp._blobs)} {}
 
     endpoint(endpoint&& temp, fetch_handler store_message) noexcept
@@ -596,6 +651,8 @@ private:
       , _connection{std::move(temp._connection)}
       , _outgoing{std::move(temp._outgoing)}
       , _incoming{std::move(temp._incoming)}
+      , _incoming_index{std::move(temp._incoming_index)}
+      , _dirty_incoming{std::move(temp._dirty_incoming)}
       , _blobs{std::move(temp._blobs)}
       , _store_handler{std::move(store_message)} {}
 
@@ -37,21 +37,67 @@ auto endpoint::_declare_states() noexcept {
     declare_state("msgCongest", "msgAgeHigh", "msgAgeNorm");
 }
 //------------------------------------------------------------------------------
+auto endpoint::_incoming_hash(const message_id msg_id) noexcept
+  -> std::size_t {
+    const auto h{
+      (msg_id.class_().value() * 0x9E3779B97F4A7C15U) ^
+      msg_id.method().value()};
+    return std::size_t(h ^ (h >> 29U));
+}
+//------------------------------------------------------------------------------
+void endpoint::_rebuild_incoming_index() noexcept {
+    const auto size{
+      std::bit_ceil(std::max(_incoming.size() * 2U, std::size_t(8U)))};
+    const auto mask{size - 1U};
+    _incoming_index.assign(size, {message_id{}, nullptr});
+    for(auto& [msg_id, state] : _incoming) {
+        auto pos{_incoming_hash(msg_id)};
+        while(std::get<1>(_incoming_index[pos & mask])) {
+            ++pos;
+        }
+        _incoming_index[pos & mask] = {msg_id, &*state};
+    }
+}
+//------------------------------------------------------------------------------
+void endpoint::_push_incoming(
+  incoming_state& state,
+  const message_view& message,
+  const message_age msg_age) noexcept {
+    state.queue.push(message).add_age(msg_age);
+    // queues of message types nobody subscribes to are not visited
+    if(not state.is_dirty and (state.subscription_count > 0)) {
+        state.is_dirty = true;
+        _dirty_incoming.push_back(&state);
+    }
+}
+//------------------------------------------------------------------------------
 auto endpoint::_ensure_incoming(const message_id msg_id) noexcept
   -> incoming_state& {
+    if(const auto found{_find_incoming(msg_id)}) [[likely]] {
+        return *found;
+    }
     auto incoming{find(_incoming, msg_id)};
     if(not incoming) {
         incoming.emplace(msg_id, default_selector);
     }
+    _rebuild_incoming_index();
     assert(incoming and *incoming);
     return **incoming;
 }
 //------------------------------------------------------------------------------
 auto endpoint::_find_incoming(const message_id msg_id) const noexcept
   -> optional_reference<incoming_state> {
-    if(const auto incoming{find(_incoming, msg_id)}) {
-        assert(*incoming);
-        return incoming->ref();
+    if(not _incoming_index.empty()) [[likely]] {
+        const auto mask{_incoming_index.size() - 1U};
+        for(auto pos{_incoming_hash(msg_id)};; ++pos) {
+            const auto& [entry_id, state] = _incoming_index[pos & mask];
+            if(not state) {
+                break;
+            }
+            if(entry_id == msg_id) [[likely]] {
+                return {*state};
+            }
+        }
     }
     return {};
 }
@@ -192,6 +238,12 @@ auto endpoint::_handle_blob_prepare(const message_view& message) noexcept
     return was_handled;
 }
 //------------------------------------------------------------------------------
+auto endpoint::_handle_blob_ack(const message_view& message) noexcept
+  -> message_handling_result {
+    _blobs.process_ack(message);
+    return was_handled;
+}
+//------------------------------------------------------------------------------
 auto endpoint::_handle_flow_info(const message_view& message) noexcept
   -> message_handling_result {
     message_flow_info flow_info{};
@@ -280,6 +332,20 @@ auto endpoint::_handle_sign_nonce_request(const message_view& message) noexcept
           .arg("endpoint", _endpoint_id)
           .arg("target", message.source_id);
     }
+    // the session key is bound to the nonce of the requesting node
+    if(const auto signed_salt{_context->make_own_session_key(
+         message.source_id, message.content())}) {
+        post_blob(
+          msgbus_id{"eptSessSlt"},
+          message.source_id,
+          message.sequence_no,
+          signed_salt,
+          std::chrono::seconds(30),
+          message_priority::normal);
+        log_debug("sending session key salt")
+          .arg("endpoint", _endpoint_id)
+          .arg("target", message.source_id);
+    }
     return was_handled;
 }
 //------------------------------------------------------------------------------
@@ -294,6 +360,31 @@ auto endpoint::_handle_signed_nonce(const message_view& message) noexcept
     return was_handled;
 }
 //------------------------------------------------------------------------------
+auto endpoint::_handle_session_salt(const message_view& message) noexcept
+  -> message_handling_result {
+    if(const auto acknowledgement{_context->add_remote_session_salt(
+         message.source_id, message.content())}) {
+        message_view response{view(*acknowledgement)};
+        response.set_target_id(message.source_id);
+        post(msgbus_id{"eptSessAck"}, response);
+        log_debug("derived remote session key")
+          .arg("endpoint", _endpoint_id)
+          .arg("source", message.source_id);
+    }
+    return was_handled;
+}
+//------------------------------------------------------------------------------
+auto endpoint::_handle_session_ack(const message_view& message) noexcept
+  -> message_handling_result {
+    if(_context->confirm_own_session_key(
+         message.source_id, message.content())) {
+        log_debug("remote node acknowledged session key")
+          .arg("endpoint", _endpoint_id)
+          .arg("target", message.source_id);
+    }
+    return was_handled;
+}
+//------------------------------------------------------------------------------
 auto endpoint::_handle_topology_query(const message_view& message) noexcept
   -> message_handling_result {
     endpoint_topology_info info{};
@@ -352,6 +443,8 @@ auto endpoint::_handle_special(
                 return _handle_blob_resend(message);
             case id_v("blobPrpare"):
                 return _handle_blob_prepare(message);
+            case id_v("blobFrgAck"):
+                return _handle_blob_ack(message);
             case id_v("assignId"):
                 return _handle_assign_id(message);
             case id_v("confirmId"):
@@ -366,6 +459,10 @@ auto endpoint::_handle_special(
                 return _handle_sign_nonce_request(message);
             case id_v("eptNnceSig"):
                 return _handle_signed_nonce(message);
+            case id_v("eptSessSlt"):
+                return _handle_session_salt(message);
+            case id_v("eptSessAck"):
+                return _handle_session_ack(message);
             case id_v("rtrCertPem"):
                 return _handle_router_certificate(message);
             case id_v("topoQuery"):
@@ -416,13 +513,13 @@ auto endpoint::_store_message(
           not is_valid_id(message.target_id)) [[likely]] {
             if(auto found{_find_incoming(msg_id)}) [[likely]] {
                 log_trace("stored message ${message}").arg("message", msg_id);
-                found->queue.push(message).add_age(msg_age);
+                _push_incoming(*found, message, msg_age);
             } else {
                 auto& state = _ensure_incoming(msg_id);
                 assert(state.subscription_count == 0);
                 log_debug("storing new type of message ${message}")
                   .arg("message", msg_id);
-                state.queue.push(message).add_age(msg_age);
+                _push_incoming(state, message, msg_age);
             }
         } else {
             ++_stats.dropped_messages;
@@ -447,7 +544,7 @@ auto endpoint::_accept_message(
           (message.target_id == _endpoint_id) or
           not is_valid_id(message.target_id)) {
             log_trace("accepted message ${message}").arg("message", msg_id);
-            found->queue.push(message);
+            _push_incoming(*found, message, message_age{});
         }
         return true;
     }
@@ -553,6 +650,29 @@ auto endpoint::post_signed(
     return false;
 }
 //------------------------------------------------------------------------------
+auto endpoint::post_authenticated(
+  const message_id msg_id,
+  const message_view msg_view) noexcept -> bool {
+    if(const auto opt_size = max_data_size()) {
+        const auto max_size = *opt_size;
+        return _outgoing.push_if(
+          [this, msg_id, &msg_view, max_size](
+            message_id& dst_msg_id,
+            message_timestamp&,
+            stored_message& message) {
+              message.assign(msg_view);
+              if(message.store_and_authenticate(
+                   msg_view.content(), max_size, ctx(), *this)) {
+                  dst_msg_id = msg_id;
+                  return true;
+              }
+              return false;
+          },
+          max_size);
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
 auto endpoint::_update_no_connection() noexcept -> work_done {
     some_true something_done{};
     log_warning(_log_no_connection, "endpoint has no connection")
@@ -611,9 +731,21 @@ auto endpoint::_update_send_outbox() noexcept -> work_done {
       make_callable_ref<&endpoint::_handle_send>(this));
 }
 //------------------------------------------------------------------------------
+auto endpoint::wait_for_work(const std::chrono::microseconds timeout) noexcept
+  -> bool {
+    if(_outgoing.empty() and not _blobs.has_outgoing()) {
+        if(_connection and _connection->prepare_wait(_readiness)) {
+            return _readiness->wait_for(timeout);
+        }
+    }
+    std::this_thread::sleep_for(timeout);
+    return false;
+}
+//------------------------------------------------------------------------------
 auto endpoint::update() noexcept -> work_done {
     static const auto exec_time_id{register_time_interval("busUpdate")};
     const auto exec_time{measure_time_interval(exec_time_id)};
+    const message_tick tick{};
     some_true something_done{};
 
     something_done(_process_blobs());
@@ -665,6 +797,11 @@ void endpoint::subscribe(const message_id msg_id) noexcept {
         log_debug("subscribing to message ${message}").arg("message", msg_id);
     }
     ++state.subscription_count;
+    // messages stored before the subscription are visited too
+    if(not state.is_dirty and not state.queue.empty()) {
+        state.is_dirty = true;
+        _dirty_incoming.push_back(&state);
+    }
 }
 //------------------------------------------------------------------------------
 void endpoint::unsubscribe(const message_id msg_id) noexcept {
@@ -672,7 +809,11 @@ void endpoint::unsubscribe(const message_id msg_id) noexcept {
         assert(*found);
         auto& state = **found;
         if(--state.subscription_count <= 0) {
+            if(state.is_dirty) {
+                std::erase(_dirty_incoming, &state);
+            }
             _incoming.erase(found.position());
+            _rebuild_incoming_index();
             log_debug("unsubscribing from message ${message}")
               .arg("message", msg_id);
         }
@@ -853,6 +994,20 @@ auto endpoint::process_all(
     return 0;
 }
 //------------------------------------------------------------------------------
+void endpoint::visit_dirty_queues(const queue_visitor visitor) noexcept {
+    std::size_t kept{0U};
+    for(std::size_t i = 0; i < _dirty_incoming.size(); ++i) {
+        auto* state{_dirty_incoming[i]};
+        visitor(state->queue);
+        if(state->queue.empty()) {
+            state->is_dirty = false;
+        } else {
+            _dirty_incoming[kept++] = state;
+        }
+    }
+    _dirty_incoming.resize(kept);
+}
+//------------------------------------------------------------------------------
 auto endpoint::process_everything(const method_handler handler) noexcept
   -> span_size_t {
     span_size_t result = 0;
@@ -300,18 +300,188 @@ void endpoint_id_assigned(unsigned, auto& s) {
     }
 }
 //------------------------------------------------------------------------------
+// message priority queue
+//------------------------------------------------------------------------------
+void endpoint_message_priority_queue(unsigned, auto& s) {
+    eagitest::case_ test{s, 6, "message priority queue"};
+    auto& rg{test.random()};
+    auto& ctx{s.context()};
+
+    eagine::msgbus::endpoint bus{"Endpoint", ctx};
+    const eagine::msgbus::message_context msg_ctx{
+      bus, eagine::message_id{"Test", "PrioQueue"}};
+    eagine::msgbus::message_priority_queue queue;
+    test.check(queue.empty(), "is empty");
+
+    const auto count{rg.get_between<eagine::span_size_t>(1, 5000)};
+    for(eagine::span_size_t i = 0; i < count; ++i) {
+        eagine::msgbus::message_view message{};
+        message.set_sequence_no(eagine::msgbus::message_sequence_t(i));
+        message.set_priority(static_cast<eagine::msgbus::message_priority>(
+          rg.get_between<std::uint8_t>(0U, 4U)));
+        queue.push(message);
+    }
+    test.check_equal(queue.size(), count, "size");
+
+    // higher priority first, FIFO within the same priority
+    auto prev_priority{eagine::msgbus::message_priority::critical};
+    eagine::msgbus::message_sequence_t prev_seq{0U};
+    bool first{true};
+    eagine::span_size_t odd{0};
+    const auto handled{queue.process_all(
+      msg_ctx,
+      {eagine::construct_from,
+       [&](
+         const eagine::msgbus::message_context&,
+         const eagine::msgbus::stored_message& message) -> bool {
+           test.check(message.priority <= prev_priority, "priority order");
+           if(message.priority == prev_priority and not first) {
+               test.check(message.sequence_no > prev_seq, "fifo order");
+           }
+           prev_priority = message.priority;
+           prev_seq = message.sequence_no;
+           first = false;
+           if(message.sequence_no % 2U == 0U) {
+               return true;
+           }
+           ++odd;
+           return false;
+       }})};
+    test.check_equal(handled + odd, count, "handled count");
+    test.check_equal(queue.size(), odd, "unhandled left");
+
+    // the unhandled messages keep their order
+    first = true;
+    prev_priority = eagine::msgbus::message_priority::critical;
+    for(auto& message : queue.give_messages()) {
+        test.check(message.sequence_no % 2U == 1U, "unhandled");
+        test.check(message.priority <= prev_priority, "priority order");
+        if(message.priority == prev_priority and not first) {
+            test.check(message.sequence_no > prev_seq, "fifo order");
+        }
+        prev_priority = message.priority;
+        prev_seq = message.sequence_no;
+        first = false;
+    }
+    test.check(queue.empty(), "is empty");
+}
+//------------------------------------------------------------------------------
+// two subscribers dirty queues
+//------------------------------------------------------------------------------
+template <
+  eagine::identifier_value MethodId,
+  typename Base = eagine::msgbus::subscriber>
+class test_sink : public Base {
+public:
+    auto received() const noexcept -> int {
+        return _rcvd;
+    }
+
+protected:
+    using Base::Base;
+
+    void add_methods() noexcept {
+        Base::add_methods();
+        Base::add_method(
+          this,
+          eagine::msgbus::
+            message_map<"eagiTest", MethodId, &test_sink::_handle>{});
+    }
+
+private:
+    auto _handle(
+      const eagine::msgbus::message_context&,
+      const eagine::msgbus::stored_message&) noexcept -> bool {
+        ++_rcvd;
+        return true;
+    }
+
+    int _rcvd{0};
+};
+//------------------------------------------------------------------------------
+void endpoint_two_subscribers_dirty_queues(auto& s) {
+    eagitest::case_ test{s, 7, "two subscribers dirty queues"};
+    auto& rg{test.random()};
+    auto& ctx{s.context()};
+
+    eagine::msgbus::endpoint endpoint_a{"EndpointA", ctx};
+    eagine::msgbus::endpoint endpoint_b{"EndpointB", ctx};
+
+    auto acceptor = eagine::msgbus::make_direct_acceptor(ctx);
+    endpoint_a.add_connection(acceptor->make_connection());
+    endpoint_b.add_connection(acceptor->make_connection());
+
+    eagine::msgbus::router router(ctx);
+    router.add_acceptor(std::move(acceptor));
+
+    eagine::msgbus::service_composition<test_sink<"dirtyX">> sink_x{
+      endpoint_a};
+    eagine::msgbus::service_composition<test_sink<"dirtyY">> sink_y{
+      endpoint_a};
+
+    eagine::timeout get_id_time{std::chrono::seconds{5}};
+    while(not(endpoint_a.has_id() and endpoint_b.has_id())) {
+        if(get_id_time.is_expired()) {
+            test.fail("failed to get id");
+            return;
+        }
+        router.update();
+        endpoint_b.update();
+        sink_x.update_and_process_all();
+        sink_y.update_and_process_all();
+    }
+
+    // each subscriber handles one type, the third type has no subscriber
+    const std::array<eagine::message_id, 3> msg_ids{
+      {{"eagiTest", "dirtyX"}, {"eagiTest", "dirtyY"}, {"eagiTest", "dirtyZ"}}};
+    std::array<int, 3> sent{};
+    const auto count{rg.get_between(100, 1000)};
+    for(int i = 0; i < count; ++i) {
+        const auto t{rg.get_between<std::size_t>(0U, 2U)};
+        eagine::msgbus::message_view message{};
+        message.set_target_id(endpoint_a.get_id());
+        endpoint_b.post(msg_ids[t], message);
+        ++sent[t];
+    }
+
+    eagine::timeout process_time{std::chrono::seconds{10}};
+    while((sink_x.received() < sent[0]) or (sink_y.received() < sent[1])) {
+        if(process_time.is_expired()) {
+            test.fail("failed to receive messages");
+            break;
+        }
+        router.update();
+        endpoint_b.update();
+        sink_x.update_and_process_all();
+        sink_y.update_and_process_all();
+    }
+    test.check_equal(sink_x.received(), sent[0], "received x");
+    test.check_equal(sink_y.received(), sent[1], "received y");
+
+    // the queue of the unsubscribed messages is not visited
+    int visited{0};
+    endpoint_a.visit_dirty_queues(
+      {eagine::construct_from,
+       [&](eagine::msgbus::message_priority_queue&) noexcept {
+           ++visited;
+       }});
+    test.check_equal(visited, 0, "no dirty queues left");
+}
+//------------------------------------------------------------------------------
 // main
 //------------------------------------------------------------------------------
 auto test_main(eagine::test_ctx& ctx) -> int {
     enable_message_bus(ctx);
     ctx.preinitialize();
 
-    eagitest::ctx_suite test{ctx, "endpoint", 5};
+    eagitest::ctx_suite test{ctx, "endpoint", 7};
     test.repeat(5, endpoint_connection_established);
     test.repeat(5, endpoint_connection_lost);
     test.repeat(5, endpoint_preconfigure_id);
     test.repeat(5, endpoint_get_id);
     test.repeat(5, endpoint_id_assigned);
+    test.repeat(5, endpoint_message_priority_queue);
+    test.once(endpoint_two_subscribers_dirty_queues);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------
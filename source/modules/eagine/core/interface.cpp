@@ -33,6 +33,53 @@ export struct connection_info : interface<connection_info> {
     virtual auto type_id() -> identifier = 0;
 };
 //------------------------------------------------------------------------------
+/// @brief Signal through which message bus connections indicate pending work.
+/// @ingroup msgbus
+/// @see connection::prepare_wait
+/// @see acceptor::prepare_wait
+///
+/// Connections either watch a native readable handle (socket, message queue)
+/// or notify the readiness from the thread producing the work.
+export class connection_readiness {
+public:
+    connection_readiness() noexcept;
+    connection_readiness(connection_readiness&&) = delete;
+    connection_readiness(const connection_readiness&) = delete;
+    auto operator=(connection_readiness&&) = delete;
+    auto operator=(const connection_readiness&) = delete;
+    ~connection_readiness() noexcept;
+
+    /// @brief Wakes up the thread waiting on this readiness (thread-safe).
+    /// @note Cheap if nobody waits, the wake-up is signalled only if a waiter
+    ///       is armed in wait_for.
+    void notify() noexcept;
+
+    /// @brief Adds a native handle that is readable when there is pending work.
+    /// @see wait_for
+    void watch(const int handle) noexcept {
+        _handles.push_back(handle);
+    }
+
+    /// @brief Waits until notified, a watched handle is readable, or timeout.
+    /// @see notify
+    /// @see watch
+    /// The watched handles are removed after the wait.
+    auto wait_for(const std::chrono::microseconds timeout) noexcept -> bool;
+
+private:
+    void _signal() noexcept;
+    auto _arm() noexcept -> bool;
+    void _disarm() noexcept;
+
+    std::vector<int> _handles;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::atomic<bool> _armed{false};
+    std::atomic<bool> _pending{false};
+    bool _notified{false};
+    int _event_handle{-1};
+};
+//------------------------------------------------------------------------------
 /// @brief Interface for message bus connections.
 /// @ingroup msgbus
 /// @see connection_user
@@ -75,9 +122,54 @@ export struct connection : connection_info {
     virtual auto fetch_messages(const fetch_handler handler) noexcept
       -> work_done = 0;
 
+    /// @brief Alias for serialized message fetch handler callable reference type.
+    /// The last argument is the received message with compact header
+    /// or an empty block if the message was deserialized.
+    using fetch_serialized_handler = callable_ref<bool(
+      const message_id,
+      const message_age,
+      const message_view&,
+      const memory::const_block) noexcept>;
+
+    /// @brief Fetch received messages together with their serialized form.
+    /// @see fetch_messages
+    /// @see send_serialized
+    /// The serialized form is passed only if the message was received with
+    /// the compact header and can be forwarded without re-serialization.
+    virtual auto fetch_serialized(const fetch_serialized_handler handler) noexcept
+      -> work_done {
+        return fetch_messages(
+          {construct_from,
+           [handler](
+             const message_id msg_id,
+             const message_age msg_age,
+             const message_view& message) -> bool {
+               return handler(msg_id, msg_age, message, {});
+           }});
+    }
+
+    /// @brief Sends a message already serialized with the compact header.
+    /// @see fetch_serialized
+    /// @see send
+    /// The default implementation serializes the message again.
+    virtual auto send_serialized(
+      const message_id msg_id,
+      const message_view& message,
+      const shared_serialized_message&) noexcept -> bool {
+        return send(msg_id, message);
+    }
+
     /// @brief Fill in the available statistics information for this connection.
     virtual auto query_statistics(connection_statistics&) noexcept -> bool = 0;
 
+    /// @brief Lets this connection signal incoming data through the readiness.
+    /// @see connection_readiness
+    /// Returns false if the connection cannot signal and has to be polled.
+    virtual auto prepare_wait(
+      const shared_holder<connection_readiness>&) noexcept -> bool {
+        return false;
+    }
+
     virtual auto routing_weight() noexcept -> float = 0;
 };
 //------------------------------------------------------------------------------
@@ -110,6 +202,14 @@ export struct acceptor : connection_info {
     /// @brief Lets the handler process the pending accepted connections.
     virtual auto process_accepted(const accept_handler handler) noexcept
       -> work_done = 0;
+
+    /// @brief Lets this acceptor signal new connections through the readiness.
+    /// @see connection_readiness
+    /// Returns false if the acceptor cannot signal and has to be polled.
+    virtual auto prepare_wait(
+      const shared_holder<connection_readiness>&) noexcept -> bool {
+        return false;
+    }
 };
 //------------------------------------------------------------------------------
 /// @brief Interface for classes that can use message bus connection acceptors.
@@ -0,0 +1,148 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module;
+
+#if __has_include(<poll.h>) && __has_include(<sys/eventfd.h>) && \
+  __has_include(<unistd.h>)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#define EAGINE_MSGBUS_USE_EVENTFD 1
+#else
+#define EAGINE_MSGBUS_USE_EVENTFD 0
+#endif
+
+module eagine.msgbus.core;
+
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import eagine.core.utility;
+
+namespace eagine::msgbus {
+//------------------------------------------------------------------------------
+// connection_readiness
+//------------------------------------------------------------------------------
+// The notifier always records the pending work and signals the waiter only
+// if it is armed. The waiter arms itself and then checks the pending flag,
+// so either the waiter sees the work or the notifier sees the armed waiter.
+void connection_readiness::notify() noexcept {
+    _pending.store(true);
+    if(_armed.load() and _armed.exchange(false)) {
+        _signal();
+    }
+}
+//------------------------------------------------------------------------------
+auto connection_readiness::_arm() noexcept -> bool {
+    _armed.store(true);
+    if(_pending.exchange(false)) {
+        _armed.store(false);
+        return false;
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
+void connection_readiness::_disarm() noexcept {
+    _armed.store(false);
+    _pending.store(false);
+}
+//------------------------------------------------------------------------------
+#if EAGINE_MSGBUS_USE_EVENTFD
+connection_readiness::connection_readiness() noexcept
+  : _event_handle{::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC)} {}
+//------------------------------------------------------------------------------
+connection_readiness::~connection_readiness() noexcept {
+    if(_event_handle >= 0) {
+        ::close(_event_handle);
+    }
+}
+//------------------------------------------------------------------------------
+void connection_readiness::_signal() noexcept {
+    if(_event_handle >= 0) [[likely]] {
+        const std::uint64_t one{1U};
+        [[maybe_unused]] const auto written{
+          ::write(_event_handle, &one, sizeof(one))};
+    } else {
+        const std::unique_lock lock{_mutex};
+        _notified = true;
+        _cond.notify_one();
+    }
+}
+//------------------------------------------------------------------------------
+auto connection_readiness::wait_for(
+  const std::chrono::microseconds timeout) noexcept -> bool {
+    if(_event_handle < 0) [[unlikely]] {
+        _handles.clear();
+        if(not _arm()) {
+            return true;
+        }
+        std::unique_lock lock{_mutex};
+        const bool result{
+          _cond.wait_for(lock, timeout, [this] { return _notified; })};
+        _notified = false;
+        _disarm();
+        return result;
+    }
+
+    const bool armed{_arm()};
+    std::vector<::pollfd> fds;
+    fds.reserve(_handles.size() + 1U);
+    fds.push_back(
+      {.fd = armed ? _event_handle : -1, .events = POLLIN, .revents = 0});
+    for(const auto handle : _handles) {
+        fds.push_back({.fd = handle, .events = POLLIN, .revents = 0});
+    }
+    _handles.clear();
+
+    const auto secs{std::chrono::duration_cast<std::chrono::seconds>(timeout)};
+    const ::timespec ts{
+      .tv_sec = secs.count(),
+      .tv_nsec =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - secs)
+          .count()};
+    // with pending work the watched handles are only polled, not waited on
+    const ::timespec no_wait{.tv_sec = 0, .tv_nsec = 0};
+    const auto ready{
+      ::ppoll(fds.data(), fds.size(), armed ? &ts : &no_wait, nullptr)};
+    if(fds.front().revents & POLLIN) {
+        std::uint64_t count{0U};
+        [[maybe_unused]] const auto consumed{
+          ::read(_event_handle, &count, sizeof(count))};
+    }
+    _disarm();
+    return not armed or (ready > 0);
+}
+//------------------------------------------------------------------------------
+#else
+connection_readiness::connection_readiness() noexcept = default;
+//------------------------------------------------------------------------------
+connection_readiness::~connection_readiness() noexcept = default;
+//------------------------------------------------------------------------------
+void connection_readiness::_signal() noexcept {
+    const std::unique_lock lock{_mutex};
+    _notified = true;
+    _cond.notify_one();
+}
+//------------------------------------------------------------------------------
+auto connection_readiness::wait_for(
+  const std::chrono::microseconds timeout) noexcept -> bool {
+    // native handles cannot be waited on here, the timeout bounds the wait
+    _handles.clear();
+    if(not _arm()) {
+        return true;
+    }
+    std::unique_lock lock{_mutex};
+    const bool result{
+      _cond.wait_for(lock, timeout, [this] { return _notified; })};
+    _notified = false;
+    _disarm();
+    return result;
+}
+#endif
+//------------------------------------------------------------------------------
+} // namespace eagine::msgbus
@@ -83,6 +83,49 @@ export using message_timestamp = std::chrono::steady_clock::time_point;
 export using message_age =
   std::chrono::duration<std::int16_t, std::ratio<1, 100>>;
 //------------------------------------------------------------------------------
+/// @brief Returns the timestamp for messages being stored or fetched.
+/// @ingroup msgbus
+/// @see message_tick
+///
+/// Inside the scope of a message_tick returns the time point captured
+/// when the outermost tick on the calling thread started, otherwise
+/// returns the current time.
+export [[nodiscard]] auto message_timestamp_now() noexcept -> message_timestamp;
+
+/// @brief Returns the age of a message stored at the specified time point.
+/// @ingroup msgbus
+/// @see message_timestamp_now
+///
+/// Messages stored by another thread after the current tick started
+/// are considered to have zero age.
+export [[nodiscard]] constexpr auto message_age_since(
+  const message_timestamp stored_at,
+  const message_timestamp now) noexcept -> message_age {
+    return std::chrono::duration_cast<message_age>(
+      std::max(now - stored_at, message_timestamp::duration::zero()));
+}
+//------------------------------------------------------------------------------
+/// @brief Captures one timestamp shared by the messages handled in an update cycle.
+/// @ingroup msgbus
+/// @see message_timestamp_now
+export class message_tick {
+public:
+    message_tick() noexcept;
+    message_tick(message_tick&&) = delete;
+    message_tick(const message_tick&) = delete;
+    auto operator=(message_tick&&) = delete;
+    auto operator=(const message_tick&) = delete;
+    ~message_tick() noexcept;
+
+    /// @brief Returns the timestamp of the current tick.
+    [[nodiscard]] auto now() const noexcept -> message_timestamp {
+        return message_timestamp_now();
+    }
+
+private:
+    bool _is_outermost{false};
+};
+//------------------------------------------------------------------------------
 /// @brief Structure storing information about a sigle message bus message
 /// @ingroup msgbus
 /// @see message_view
@@ -348,6 +391,99 @@ export template <typename Backend>
     return serialized;
 }
 //------------------------------------------------------------------------------
+/// @brief Fixed-layout, little-endian bus message header.
+/// @ingroup msgbus
+/// @see serialize_compact_message
+/// @see deserialize_compact_message
+/// @see message_header_format
+///
+/// All fields are stored at fixed, naturally aligned offsets, so the header
+/// can be read with a few loads and the fields that change on every hop
+/// can be patched in place without deserializing the whole message.
+export class compact_message_header {
+public:
+    /// @brief Returns the size of the header in bytes.
+    static constexpr auto size() noexcept -> span_size_t {
+        return 48;
+    }
+
+    /// @brief The first byte of every compact header.
+    /// The portable serializer backend writes only printable characters
+    /// so this byte cannot start a message with the portable header.
+    static constexpr const byte marker{0xEBU};
+
+    /// @brief Indicates if the specified block starts with a compact header.
+    [[nodiscard]] static auto is_compact(const memory::const_block blk) noexcept
+      -> bool {
+        return (blk.size() >= size()) and (blk[0] == marker);
+    }
+
+    /// @brief Writes the header of the specified message into a block.
+    /// @see load
+    [[nodiscard]] static auto store(
+      const message_id msg_id,
+      const message_info& info,
+      memory::block dest) noexcept -> bool;
+
+    /// @brief Reads the message id and header fields from a block.
+    /// @see store
+    [[nodiscard]] static auto load(
+      const memory::const_block src,
+      identifier& class_id,
+      identifier& method_id,
+      message_info& info) noexcept -> bool;
+
+    /// @brief Overwrites the fields modified by routers in a stored header.
+    /// Updates the source, target, hop count and age of the message.
+    static void patch_routing(
+      memory::block dest,
+      const message_info& info) noexcept;
+
+private:
+    static constexpr const span_size_t _flags_offset{1};
+    static constexpr const span_size_t _hop_count_offset{2};
+    static constexpr const span_size_t _age_offset{3};
+    static constexpr const span_size_t _sequence_offset{4};
+    static constexpr const span_size_t _class_offset{8};
+    static constexpr const span_size_t _method_offset{16};
+    static constexpr const span_size_t _source_offset{24};
+    static constexpr const span_size_t _target_offset{32};
+    static constexpr const span_size_t _serializer_offset{40};
+
+    template <typename T>
+    static auto _load(
+      const memory::const_block src,
+      const span_size_t offset) noexcept -> T {
+        T result{0U};
+        for(span_size_t i = span_size(sizeof(T)) - 1; i >= 0; --i) {
+            result = T(result << 8U) | T(src[offset + i]);
+        }
+        return result;
+    }
+
+    template <typename T>
+    static void _store(
+      memory::block dest,
+      const span_size_t offset,
+      T value) noexcept {
+        for(span_size_t i = 0; i < span_size(sizeof(T)); ++i) {
+            dest[offset + i] = byte(value & 0xFFU);
+            value = T(value >> 8U);
+        }
+    }
+};
+//------------------------------------------------------------------------------
+/// @brief Serializes a bus message with the compact header into a block.
+/// @ingroup msgbus
+/// @see compact_message_header
+/// @see deserialize_compact_message
+/// @see serialize_message
+/// Returns an empty block if the message does not fit.
+export [[nodiscard]] auto serialize_compact_message(
+  const message_id msg_id,
+  const message_view& msg,
+  memory::block dest) noexcept -> memory::const_block;
+//------------------------------------------------------------------------------
 /// @brief Uses the default backend to serialize a value into a memory block.
 /// @see default_serializer_backend
 /// @see default_serialize_packed
@@ -392,6 +528,16 @@ export [[nodiscard]] auto default_serialize_message_type(
     return default_serialize(value, blk);
 }
 //------------------------------------------------------------------------------
+/// @brief Size of the authentication code of symmetrically signed messages.
+/// @ingroup msgbus
+/// @see message_mac
+export constexpr const span_size_t message_mac_size{32};
+
+/// @brief Alias for the authentication code of symmetrically signed messages.
+/// @ingroup msgbus
+/// @see message_crypto_flag
+export using message_mac = std::array<byte, 32U>;
+//------------------------------------------------------------------------------
 export class context;
 /// @brief Combines message information and an owned message content buffer.
 /// @ingroup msgbus
@@ -525,18 +671,36 @@ public:
         return std::move(_buffer);
     }
 
-    /// @brief Stores the specified data and signs it.
+    /// @brief Stores the specified data and signs it with the private key.
+    /// @see store_and_authenticate
     [[nodiscard]] auto store_and_sign(
       const memory::const_block data,
       const span_size_t max_size,
       context&,
       main_ctx_object&) noexcept -> bool;
 
+    /// @brief Stores the specified data and signs it with a MAC if possible.
+    /// @see store_and_sign
+    ///
+    /// Uses the session key acknowledged by the target node, falls back
+    /// to store_and_sign if there is none.
+    [[nodiscard]] auto store_and_authenticate(
+      const memory::const_block data,
+      const span_size_t max_size,
+      context&,
+      main_ctx_object&) noexcept -> bool;
+
     /// @brief Verifies the signatures of this message.
     [[nodiscard]] auto verify_bits(context&, main_ctx_object&) const noexcept
       -> verification_bits;
 
 private:
+    auto _store_and_mac(
+      const memory::const_block data,
+      const memory::const_block key,
+      const span_size_t max_size,
+      context&) noexcept -> bool;
+
     memory::buffer _buffer{};
 };
 //------------------------------------------------------------------------------
@@ -568,6 +732,16 @@ export template <typename Backend>
       message_id{class_id, method_id}, deserialize(message_params, backend));
 }
 //------------------------------------------------------------------------------
+/// @brief Deserializes a bus message with the compact header from a block.
+/// @ingroup msgbus
+/// @see compact_message_header
+/// @see serialize_compact_message
+/// @see deserialize_message
+export [[nodiscard]] auto deserialize_compact_message(
+  message_id& msg_id,
+  stored_message& msg,
+  const memory::const_block src) noexcept -> bool;
+//------------------------------------------------------------------------------
 /// @brief Deserializes a bus message with the specified deserializer backend.
 /// @ingroup msgbus
 /// @see deserialize_message_header
@@ -764,20 +938,21 @@ public:
 
     /// @brief Indicates if the storage is empty.
     [[nodiscard]] auto empty() const noexcept -> bool {
-        return _messages.empty();
+        return _count == 0U;
     }
 
     /// @brief Returns the coung of messages in the storage.
     [[nodiscard]] auto count() const noexcept -> span_size_t {
-        return span_size(_messages.size());
+        return span_size(_count);
     }
 
     /// @brief Pushes a message into this storage.
     void push(const message_id msg_id, const message_view& message) noexcept {
-        _messages.emplace_back(
-          msg_id,
-          stored_message{message, _buffers.get(message.data().size())},
-          _clock_t::now());
+        auto& [entry_id, entry_msg, insert_time] =
+          _next_entry(message.data().size());
+        entry_id = msg_id;
+        entry_msg = stored_message{message, entry_msg.release_buffer()};
+        insert_time = message_timestamp_now();
     }
 
     /// @brief Pushes a new message and lets a function to fill it.
@@ -786,11 +961,10 @@ public:
     template <typename Function>
     auto push_if(Function function, const span_size_t req_size = 0) noexcept
       -> bool {
-        _messages.emplace_back(
-          message_id{},
-          stored_message{{}, _buffers.get(req_size)},
-          _clock_t::now());
-        auto& [msg_id, message, insert_time] = _messages.back();
+        auto& [msg_id, message, insert_time] = _next_entry(req_size);
+        msg_id = {};
+        message = stored_message{{}, message.release_buffer()};
+        insert_time = message_timestamp_now();
         bool rollback = false;
         try {
             if(not function(msg_id, insert_time, message)) [[unlikely]] {
@@ -800,8 +974,8 @@ public:
             rollback = true;
         }
         if(rollback) [[unlikely]] {
-            _buffers.eat(message.release_buffer());
-            _messages.pop_back();
+            _recycle(message);
+            --_count;
             return false;
         }
         return true;
@@ -830,10 +1004,21 @@ public:
     void log_stats(main_ctx_object&);
 
 private:
-    using _clock_t = std::chrono::steady_clock;
+    using _entry_t = std::tuple<message_id, stored_message, message_timestamp>;
+
+    auto _next_entry(const span_size_t req_size) noexcept -> _entry_t&;
+    void _recycle(stored_message&) noexcept;
+    void _compact() noexcept;
+
+    // buffers up to this size stay with their recycled slot,
+    // larger ones are returned to the pool
+    static constexpr const span_size_t _max_slot_buffer_size{256};
+
     memory::buffer_pool _buffers{};
-    std::vector<std::tuple<message_id, stored_message, message_timestamp>>
-      _messages;
+    // the first _count entries are in use, the rest are recycled slots
+    std::vector<_entry_t> _messages;
+    std::size_t _count{0U};
+    std::size_t _slot_reuses{0U};
 };
 //------------------------------------------------------------------------------
 export class message_pack_info {
@@ -901,6 +1086,56 @@ private:
     message_priority _max_priority{message_priority::idle};
 };
 //------------------------------------------------------------------------------
+/// @brief Reference-counted, size-prefixed message with compact header.
+/// @ingroup msgbus
+/// @see compact_message_header
+/// @see serialized_message_storage::push_shared
+///
+/// Lets a router make a single patched copy of a received message and hand
+/// it to all outgoing connections, without re-serializing it for each one.
+/// A deferred message makes the copy only when it is first shared, so that
+/// nothing is copied if no outgoing connection uses it.
+export class shared_serialized_message {
+public:
+    /// @brief Default constructor, constructs an empty message.
+    shared_serialized_message() noexcept = default;
+
+    /// @brief Copies a message with compact header and patches the routing fields.
+    /// @see compact_message_header::patch_routing
+    shared_serialized_message(
+      const memory::const_block serialized,
+      const message_info& info) noexcept;
+
+    /// @brief Refers to a message with compact header, copied on the first share.
+    /// @see share
+    /// The serialized data must outlive the returned object.
+    [[nodiscard]] static auto deferred(
+      const memory::const_block serialized,
+      const message_info& info) noexcept -> shared_serialized_message;
+
+    /// @brief Indicates if this object holds or refers to a message.
+    [[nodiscard]] explicit operator bool() const noexcept {
+        return bool(_buffer) or not _source.empty();
+    }
+
+    /// @brief Returns an object holding the copy of the message.
+    /// Makes the copy if this is a deferred message that was not shared yet.
+    [[nodiscard]] auto share() const noexcept -> shared_serialized_message;
+
+    /// @brief Returns the serialized message prefixed by its size.
+    [[nodiscard]] auto sized_data() const noexcept -> memory::const_block {
+        if(_buffer) [[likely]] {
+            return view(*_buffer);
+        }
+        return {};
+    }
+
+private:
+    mutable shared_holder<memory::buffer> _buffer;
+    memory::const_block _source;
+    message_info _info;
+};
+//------------------------------------------------------------------------------
 export class serialized_message_storage {
 public:
     /// The return value indicates if the message is considered handled
@@ -926,20 +1161,57 @@ public:
       const memory::const_block message,
       const message_priority priority) noexcept;
 
+    /// @brief Stores the message already prefixed with its size.
+    /// @see pack_sized_into
+    /// @see gather_sized
+    void push_with_size(
+      const memory::const_block message,
+      const message_priority priority) noexcept;
+
+    /// @brief Stores a reference to a message shared with other storages.
+    /// @see push_with_size
+    void push_shared(
+      const shared_serialized_message& message,
+      const message_priority priority) noexcept;
+
     auto fetch_all(const fetch_handler handler) noexcept -> bool;
 
     [[nodiscard]] auto pack_into(memory::block dest) noexcept
       -> message_pack_info;
 
+    /// @brief Packs messages stored with push_with_size into dest.
+    [[nodiscard]] auto pack_sized_into(memory::block dest) noexcept
+      -> message_pack_info;
+
+    /// @brief Collects views of messages stored with push_with_size.
+    /// @note The views are valid until the next call to cleanup.
+    [[nodiscard]] auto gather_sized(
+      const span_size_t max_size,
+      std::vector<memory::const_block>& dest) noexcept -> message_pack_info;
+
     void cleanup(const message_pack_info& to_be_removed) noexcept;
 
     void log_stats(main_ctx_object&);
 
 private:
-    using _clock_t = std::chrono::steady_clock;
+    using _entry_t = std::tuple<
+      memory::buffer,
+      message_timestamp,
+      message_priority,
+      shared_serialized_message>;
+
+    static auto _data_of(const _entry_t& entry) noexcept
+      -> memory::const_block {
+        const auto& shared{std::get<3>(entry)};
+        return shared ? shared.sized_data() : view(std::get<0>(entry));
+    }
+
+    static auto _is_removed(const _entry_t& entry) noexcept -> bool {
+        return std::get<0>(entry).empty() and not std::get<3>(entry);
+    }
+
     memory::buffer_pool _buffers{};
-    std::vector<std::tuple<memory::buffer, message_timestamp, message_priority>>
-      _messages;
+    std::vector<_entry_t> _messages;
 };
 //------------------------------------------------------------------------------
 export class endpoint;
@@ -1013,37 +1285,35 @@ public:
     using handler_type =
       callable_ref<bool(const message_context&, const stored_message&) noexcept>;
 
-    message_priority_queue() noexcept {
-        _messages.reserve(128);
-    }
-
     [[nodiscard]] auto empty() const noexcept -> bool {
-        return _messages.empty();
+        return std::all_of(
+          _fifos.begin(), _fifos.end(), [](const auto& f) { return f.empty(); });
     }
 
     [[nodiscard]] auto size() const noexcept -> span_size_t {
-        return _messages.size();
+        span_size_t result{0};
+        for(const auto& fifo : _fifos) {
+            result += fifo.size();
+        }
+        return result;
     }
 
     auto push(const message_view& message) noexcept -> stored_message& {
-        const auto pos = std::lower_bound(
-          _messages.begin(),
-          _messages.end(),
-          message.priority,
-          [](auto& msg, auto pri) { return msg.priority < pri; });
-
-        return *_messages.emplace(
-          pos, message, _buffers.get(message.data().size()));
+        return _fifo_of(message.priority)
+          .push({message, _buffers.get(message.data().size())});
     }
 
     auto process_one(
       const message_context& msg_ctx,
       const handler_type handler) noexcept -> bool {
-        if(not _messages.empty()) {
-            if(handler(msg_ctx, _messages.back())) {
-                _buffers.eat(_messages.back().release_buffer());
-                _messages.pop_back();
-                return true;
+        for(auto pos{_fifos.rbegin()}; pos != _fifos.rend(); ++pos) {
+            if(not pos->empty()) {
+                if(handler(msg_ctx, pos->front())) {
+                    _buffers.eat(pos->front().release_buffer());
+                    pos->pop();
+                    return true;
+                }
+                return false;
             }
         }
         return false;
@@ -1052,8 +1322,10 @@ public:
     void just_process_all(
       const message_context& msg_ctx,
       const handler_type handler) noexcept {
-        for(auto& message : _messages) {
-            handler(msg_ctx, message);
+        for(auto pos{_fifos.rbegin()}; pos != _fifos.rend(); ++pos) {
+            for(span_size_t i = 0; i < pos->size(); ++i) {
+                handler(msg_ctx, pos->at(i));
+            }
         }
     }
 
@@ -1062,17 +1334,67 @@ public:
       const handler_type handler) noexcept -> span_size_t;
 
     [[nodiscard]] auto give_messages() noexcept
-      -> pointee_generator<std::vector<stored_message>::iterator> {
-        for(auto pos{_messages.begin()}; pos != _messages.end(); ++pos) {
-            co_yield pos;
-            _buffers.eat(pos->release_buffer());
+      -> pointee_generator<stored_message*> {
+        for(auto pos{_fifos.rbegin()}; pos != _fifos.rend(); ++pos) {
+            while(not pos->empty()) {
+                co_yield &pos->front();
+                _buffers.eat(pos->front().release_buffer());
+                pos->pop();
+            }
         }
-        _messages.clear();
     }
 
 private:
+    // FIFO ring buffer of messages with the same priority.
+    class _fifo {
+    public:
+        [[nodiscard]] auto empty() const noexcept -> bool {
+            return _count == 0U;
+        }
+
+        [[nodiscard]] auto size() const noexcept -> span_size_t {
+            return span_size(_count);
+        }
+
+        [[nodiscard]] auto at(span_size_t index) noexcept -> stored_message& {
+            return _slots[_wrap(_head + std_size(index))];
+        }
+
+        [[nodiscard]] auto front() noexcept -> stored_message& {
+            return _slots[_head];
+        }
+
+        auto push(stored_message message) noexcept -> stored_message&;
+
+        void pop() noexcept {
+            _head = _wrap(_head + 1U);
+            --_count;
+        }
+
+        // moves the front message to the back of the ring
+        void rotate() noexcept;
+
+    private:
+        [[nodiscard]] auto _wrap(std::size_t index) const noexcept
+          -> std::size_t {
+            return index & (_slots.size() - 1U);
+        }
+
+        void _grow() noexcept;
+
+        // the size is always zero or a power of two
+        std::vector<stored_message> _slots;
+        std::size_t _head{0U};
+        std::size_t _count{0U};
+    };
+
+    auto _fifo_of(message_priority priority) noexcept -> _fifo& {
+        return _fifos[std::to_underlying(priority)];
+    }
+
     memory::buffer_pool _buffers{};
-    std::vector<stored_message> _messages;
+    std::array<_fifo, std::to_underlying(message_priority::critical) + 1U>
+      _fifos{};
 };
 //------------------------------------------------------------------------------
 export class connection_outgoing_messages {
@@ -1085,15 +1407,32 @@ public:
         return _serialized.count();
     }
 
+    /// @brief Serializes and enqueues a message in the specified header format.
     [[nodiscard]] auto enqueue(
       main_ctx_object& user,
       const message_id,
       const message_view&,
-      memory::block) noexcept -> bool;
+      memory::block,
+      const message_header_format = message_header_format::portable) noexcept
+      -> bool;
+
+    /// @brief Enqueues a message serialized and shared by a router.
+    /// @see connection::send_serialized
+    void enqueue_shared(
+      const shared_serialized_message& message,
+      const message_priority priority) noexcept {
+        _serialized.push_shared(message, priority);
+    }
 
     [[nodiscard]] auto pack_into(memory::block dest) noexcept
       -> message_pack_info {
-        return _serialized.pack_into(dest);
+        return _serialized.pack_sized_into(dest);
+    }
+
+    [[nodiscard]] auto gather_into(
+      const span_size_t max_size,
+      std::vector<memory::const_block>& dest) noexcept -> message_pack_info {
+        return _serialized.gather_sized(max_size, dest);
     }
 
     void cleanup(const message_pack_info& packed) noexcept {
@@ -1113,6 +1452,14 @@ public:
     using fetch_handler = callable_ref<
       bool(const message_id, const message_age, const message_view&) noexcept>;
 
+    /// The last argument is the received message with compact header
+    /// or an empty block if the message was deserialized.
+    using fetch_serialized_handler = callable_ref<bool(
+      const message_id,
+      const message_age,
+      const message_view&,
+      const memory::const_block) noexcept>;
+
     [[nodiscard]] auto empty() const noexcept -> bool {
         return _packed.empty();
     }
@@ -1129,12 +1476,23 @@ public:
       main_ctx_object& user,
       const fetch_handler handler) noexcept -> bool;
 
+    /// @brief Fetches messages, passing those with compact header without copying.
+    /// @see compact_message_header
+    auto fetch_serialized(
+      main_ctx_object& user,
+      const fetch_serialized_handler handler) noexcept -> bool;
+
     void log_stats(main_ctx_object& user) {
         _packed.log_stats(user);
         _unpacked.log_stats(user);
     }
 
 private:
+    void _unpack(
+      main_ctx_object& user,
+      const message_timestamp data_ts,
+      const memory::const_block blk) noexcept;
+
     serialized_message_storage _packed{};
     message_storage _unpacked{};
 };
@@ -1170,7 +1528,7 @@ public:
 
     /// @brief Returns a view of messages in the message queue and later removes them.
     [[nodiscard]] auto give_messages() const noexcept
-      -> pointee_generator<std::vector<stored_message>::iterator> {
+      -> pointee_generator<stored_message*> {
         return _queue.give_messages();
     }
 
@@ -55,12 +55,52 @@ auto message_info::add_age(const message_age age) noexcept -> message_info& {
 //------------------------------------------------------------------------------
 // stored message
 //------------------------------------------------------------------------------
+auto stored_message::_store_and_mac(
+  const memory::const_block data,
+  const memory::const_block key,
+  const span_size_t max_size,
+  context& ctx) noexcept -> bool {
+    _buffer.resize(max_size);
+    if(const auto used{store_data_with_size(data, storage())}) [[likely]] {
+        auto free{skip(storage(), used.size())};
+        if(free.size() < message_mac_size) [[unlikely]] {
+            return false;
+        }
+        if(const auto mac{ctx.compute_message_mac(key, data)}) [[likely]] {
+            std::copy(mac->begin(), mac->end(), free.begin());
+            crypto_flags =
+              message_crypto_flags{message_crypto_flag::signed_content};
+            _buffer.resize(used.size() + message_mac_size);
+            return true;
+        }
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto stored_message::store_and_authenticate(
+  const memory::const_block data,
+  const span_size_t max_size,
+  context& ctx,
+  main_ctx_object& user) noexcept -> bool {
+    // the session key agreed with the target node in the nonce exchange
+    // makes the signature a cheap HMAC instead of a private key operation
+    // on every message, broadcast messages still use the private key
+    if(const auto session_key{ctx.get_own_session_key(target_id)}) {
+        if(_store_and_mac(data, session_key, max_size, ctx)) [[likely]] {
+            return true;
+        }
+        user.log_debug("failed to store message authentication code")
+          .arg("maxSize", max_size);
+        crypto_flags = {};
+    }
+    return store_and_sign(data, max_size, ctx, user);
+}
+//------------------------------------------------------------------------------
 auto stored_message::store_and_sign(
   const memory::const_block data,
   const span_size_t max_size,
   context& ctx,
   main_ctx_object& user) noexcept -> bool {
-
     if(const ok md_type{ctx.default_message_digest()}) {
         auto& ssl = ctx.ssl();
         _buffer.resize(max_size);
@@ -109,41 +149,264 @@ auto stored_message::store_and_sign(
 //------------------------------------------------------------------------------
 auto stored_message::verify_bits(context& ctx, main_ctx_object&) const noexcept
   -> verification_bits {
-    return ctx.verify_remote_signature(content(), signature(), source_id);
+    if(crypto_flags.has(message_crypto_flag::asymmetric)) {
+        return ctx.verify_remote_signature(content(), signature(), source_id);
+    }
+    if(is_signed()) {
+        return ctx.verify_remote_mac(content(), signature(), source_id);
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+// compact_message_header
+//------------------------------------------------------------------------------
+auto compact_message_header::store(
+  const message_id msg_id,
+  const message_info& info,
+  memory::block dest) noexcept -> bool {
+    if(dest.size() < size()) [[unlikely]] {
+        return false;
+    }
+    // the priority and the crypto flags share a single byte
+    const auto flags{std::uint8_t(
+      std::to_underlying(info.priority) |
+      std::uint8_t(info.crypto_flags.bits() << 4U))};
+
+    dest[0] = marker;
+    _store<std::uint8_t>(dest, _flags_offset, flags);
+    _store<std::uint8_t>(
+      dest, _hop_count_offset, std::uint8_t(info.hop_count));
+    _store<std::uint8_t>(
+      dest, _age_offset, std::uint8_t(info.age_quarter_seconds));
+    _store<std::uint32_t>(dest, _sequence_offset, info.sequence_no);
+    _store<identifier_t>(dest, _class_offset, msg_id.class_().value());
+    _store<identifier_t>(dest, _method_offset, msg_id.method().value());
+    _store<identifier_t>(dest, _source_offset, info.source_id.value());
+    _store<identifier_t>(dest, _target_offset, info.target_id.value());
+    _store<identifier_t>(dest, _serializer_offset, info.serializer_id.value());
+    return true;
+}
+//------------------------------------------------------------------------------
+auto compact_message_header::load(
+  const memory::const_block src,
+  identifier& class_id,
+  identifier& method_id,
+  message_info& info) noexcept -> bool {
+    if(not is_compact(src)) [[unlikely]] {
+        return false;
+    }
+    const auto flags{_load<std::uint8_t>(src, _flags_offset)};
+    const auto priority{std::uint8_t(flags & 0x0FU)};
+    if(priority > std::to_underlying(message_priority::critical))
+      [[unlikely]] {
+        return false;
+    }
+    info.priority = static_cast<message_priority>(priority);
+    info.crypto_flags =
+      message_crypto_flags{static_cast<message_crypto_flag>(flags >> 4U)};
+    info.hop_count = message_info::hop_count_t(
+      _load<std::uint8_t>(src, _hop_count_offset));
+    info.age_quarter_seconds =
+      message_info::age_t(_load<std::uint8_t>(src, _age_offset));
+    info.sequence_no = _load<std::uint32_t>(src, _sequence_offset);
+    class_id = identifier{_load<identifier_t>(src, _class_offset)};
+    method_id = identifier{_load<identifier_t>(src, _method_offset)};
+    info.source_id = _load<identifier_t>(src, _source_offset);
+    info.target_id = _load<identifier_t>(src, _target_offset);
+    info.serializer_id = _load<identifier_t>(src, _serializer_offset);
+    return true;
+}
+//------------------------------------------------------------------------------
+void compact_message_header::patch_routing(
+  memory::block dest,
+  const message_info& info) noexcept {
+    assert(is_compact(dest));
+    _store<std::uint8_t>(
+      dest, _hop_count_offset, std::uint8_t(info.hop_count));
+    _store<std::uint8_t>(
+      dest, _age_offset, std::uint8_t(info.age_quarter_seconds));
+    _store<identifier_t>(dest, _source_offset, info.source_id.value());
+    _store<identifier_t>(dest, _target_offset, info.target_id.value());
+}
+//------------------------------------------------------------------------------
+auto serialize_compact_message(
+  const message_id msg_id,
+  const message_view& msg,
+  memory::block dest) noexcept -> memory::const_block {
+    const auto total_size{compact_message_header::size() + msg.data().size()};
+    if(dest.size() >= total_size) [[likely]] {
+        if(compact_message_header::store(msg_id, msg, dest)) [[likely]] {
+            memory::copy(msg.data(), skip(dest, compact_message_header::size()));
+            return head(dest, total_size);
+        }
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+auto deserialize_compact_message(
+  message_id& msg_id,
+  stored_message& msg,
+  const memory::const_block src) noexcept -> bool {
+    identifier class_id{};
+    identifier method_id{};
+    if(compact_message_header::load(src, class_id, method_id, msg))
+      [[likely]] {
+        msg.store_content(skip(src, compact_message_header::size()));
+        msg_id = {class_id, method_id};
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+// shared_serialized_message
+//------------------------------------------------------------------------------
+shared_serialized_message::shared_serialized_message(
+  const memory::const_block serialized,
+  const message_info& info) noexcept {
+    if(compact_message_header::is_compact(serialized)) [[likely]] {
+        memory::buffer buf;
+        // room for the variable-length size prefix
+        buf.resize(serialized.size() + 8);
+        if(const auto stored{store_data_with_size(serialized, cover(buf))})
+          [[likely]] {
+            buf.resize(stored.size());
+            compact_message_header::patch_routing(
+              get_data_with_size(cover(buf)), info);
+            _buffer = {hold<memory::buffer>, std::move(buf)};
+        }
+    }
+}
+//------------------------------------------------------------------------------
+auto shared_serialized_message::deferred(
+  const memory::const_block serialized,
+  const message_info& info) noexcept -> shared_serialized_message {
+    shared_serialized_message result;
+    if(compact_message_header::is_compact(serialized)) [[likely]] {
+        result._source = serialized;
+        result._info = info;
+    }
+    return result;
+}
+//------------------------------------------------------------------------------
+auto shared_serialized_message::share() const noexcept
+  -> shared_serialized_message {
+    if(not _buffer and not _source.empty()) {
+        _buffer = shared_serialized_message{_source, _info}._buffer;
+    }
+    shared_serialized_message result;
+    result._buffer = _buffer;
+    return result;
+}
+//------------------------------------------------------------------------------
+// message_tick
+//------------------------------------------------------------------------------
+static thread_local std::optional<message_timestamp> current_message_tick{};
+//------------------------------------------------------------------------------
+auto message_timestamp_now() noexcept -> message_timestamp {
+    if(current_message_tick) [[likely]] {
+        return *current_message_tick;
+    }
+    return std::chrono::steady_clock::now();
+}
+//------------------------------------------------------------------------------
+message_tick::message_tick() noexcept {
+    if(not current_message_tick) {
+        current_message_tick = std::chrono::steady_clock::now();
+        _is_outermost = true;
+    }
+}
+//------------------------------------------------------------------------------
+message_tick::~message_tick() noexcept {
+    if(_is_outermost) {
+        current_message_tick.reset();
+    }
 }
 //------------------------------------------------------------------------------
 // message_storage
 //------------------------------------------------------------------------------
+auto message_storage::_next_entry(const span_size_t req_size) noexcept
+  -> _entry_t& {
+    if(_count < _messages.size()) [[likely]] {
+        auto& entry{_messages[_count++]};
+        auto& message{std::get<1>(entry)};
+        auto buf{message.release_buffer()};
+        if(buf.capacity() < req_size) {
+            _buffers.eat(std::move(buf));
+            buf = _buffers.get(req_size);
+        } else {
+            ++_slot_reuses;
+        }
+        message = stored_message{{}, std::move(buf)};
+        return entry;
+    }
+    ++_count;
+    return _messages.emplace_back(
+      message_id{},
+      stored_message{{}, _buffers.get(req_size)},
+      message_timestamp{});
+}
+//------------------------------------------------------------------------------
+void message_storage::_recycle(stored_message& message) noexcept {
+    if(message.storage().size() > _max_slot_buffer_size) [[unlikely]] {
+        _buffers.eat(message.release_buffer());
+    } else {
+        message.clear_data();
+    }
+    message.mark_too_old();
+}
+//------------------------------------------------------------------------------
+void message_storage::_compact() noexcept {
+    // the removed entries are swapped behind the used ones, so that
+    // they can be reused later together with their buffers
+    std::size_t used{0U};
+    for(std::size_t i = 0; i < _count; ++i) {
+        if(not std::get<1>(_messages[i]).too_many_hops()) {
+            if(i != used) {
+                std::swap(_messages[i], _messages[used]);
+            }
+            ++used;
+        }
+    }
+    _count = used;
+}
+//------------------------------------------------------------------------------
 auto message_storage::fetch_all(const fetch_handler handler) noexcept -> bool {
     bool fetched_some{false};
     bool clear_all{true};
-    for(auto& [msg_id, message, insert_time] : _messages) {
-        const auto msg_age{std::chrono::duration_cast<message_age>(
-          _clock_t::now() - insert_time)};
+    const auto now{message_timestamp_now()};
+    for(std::size_t i = 0; i < _count; ++i) {
+        auto& [msg_id, message, insert_time] = _messages[i];
+        const auto msg_age{message_age_since(insert_time, now)};
         if(handler(msg_id, msg_age, message)) {
-            _buffers.eat(message.release_buffer());
-            message.mark_too_old();
+            _recycle(message);
             fetched_some = true;
         } else {
             clear_all = false;
         }
     }
     if(clear_all) {
-        _messages.clear();
+        // the whole batch is released at once
+        _count = 0U;
     } else {
-        std::erase_if(_messages, [](const auto& t) {
-            return std::get<1>(t).too_many_hops();
-        });
+        _compact();
     }
     return fetched_some;
 }
 //------------------------------------------------------------------------------
 void message_storage::cleanup(const cleanup_predicate predicate) noexcept {
-    std::erase_if(_messages, [predicate](auto& t) {
-        const auto msg_age{std::chrono::duration_cast<message_age>(
-          _clock_t::now() - std::get<2>(t))};
-        return predicate(msg_age);
-    });
+    bool removed_some{false};
+    const auto now{message_timestamp_now()};
+    for(std::size_t i = 0; i < _count; ++i) {
+        auto& [msg_id, message, insert_time] = _messages[i];
+        const auto msg_age{message_age_since(insert_time, now)};
+        if(predicate(msg_age)) {
+            _recycle(message);
+            removed_some = true;
+        }
+    }
+    if(removed_some) {
+        _compact();
+    }
 }
 //------------------------------------------------------------------------------
 void message_storage::log_stats(main_ctx_object& user) {
@@ -154,7 +417,9 @@ void message_storage::log_stats(main_ctx_object& user) {
           .arg("poolGets", stats.number_of_gets())
           .arg("poolHits", stats.number_of_hits())
           .arg("poolEats", stats.number_of_eats())
-          .arg("poolDscrds", stats.number_of_discards());
+          .arg("poolDscrds", stats.number_of_discards())
+          .arg("slotCount", _messages.size())
+          .arg("slotReuses", _slot_reuses);
     });
 }
 //------------------------------------------------------------------------------
@@ -164,9 +429,11 @@ auto serialized_message_storage::fetch_all(const fetch_handler handler) noexcept
   -> bool {
     bool fetched_some{false};
     bool clear_all{true};
-    for(auto& [message, timestamp, priority] : _messages) {
-        if(handler(timestamp, priority, view(message))) [[likely]] {
+    for(auto& entry : _messages) {
+        auto& [message, timestamp, priority, shared] = entry;
+        if(handler(timestamp, priority, _data_of(entry))) [[likely]] {
             _buffers.eat(std::move(message));
+            shared = {};
             fetched_some = true;
         } else {
             clear_all = false;
@@ -175,9 +442,7 @@ auto serialized_message_storage::fetch_all(const fetch_handler handler) noexcept
     if(clear_all) [[likely]] {
         _messages.clear();
     } else {
-        std::erase_if(_messages, [](const auto& entry) {
-            return std::get<0>(entry).empty();
-        });
+        std::erase_if(_messages, &serialized_message_storage::_is_removed);
     }
     return fetched_some;
 }
@@ -227,7 +492,45 @@ void serialized_message_storage::push(
     if(not message.empty()) [[likely]] {
         auto buf{_buffers.get(message.size())};
         memory::copy_into(message, buf);
-        _messages.emplace_back(std::move(buf), _clock_t::now(), priority);
+        _messages.emplace_back(
+          std::move(buf),
+          message_timestamp_now(),
+          priority,
+          shared_serialized_message{});
+    }
+}
+//------------------------------------------------------------------------------
+void serialized_message_storage::push_with_size(
+  const memory::const_block message,
+  const message_priority priority) noexcept {
+    if(not message.empty()) [[likely]] {
+        // room for the variable-length size prefix
+        const span_size_t max_size{message.size() + 8};
+        auto buf{_buffers.get(max_size)};
+        buf.resize(max_size);
+        if(const auto stored{store_data_with_size(message, cover(buf))})
+          [[likely]] {
+            buf.resize(stored.size());
+            _messages.emplace_back(
+              std::move(buf),
+              message_timestamp_now(),
+              priority,
+              shared_serialized_message{});
+        } else {
+            _buffers.eat(std::move(buf));
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void serialized_message_storage::push_shared(
+  const shared_serialized_message& message,
+  const message_priority priority) noexcept {
+    if(auto shared{message.share()}) [[likely]] {
+        _messages.emplace_back(
+          memory::buffer{},
+          message_timestamp_now(),
+          priority,
+          std::move(shared));
     }
 }
 //------------------------------------------------------------------------------
@@ -235,14 +538,14 @@ auto serialized_message_storage::pack_into(memory::block dest) noexcept
   -> message_pack_info {
     message_packing_context packing{dest};
 
-    for(const auto& [message, timestamp, priority] : _messages) {
-        (void)(timestamp);
+    for(const auto& entry : _messages) {
         if(packing.is_full()) {
             break;
         }
         if(const auto packed{
-             store_data_with_size(view(message), packing.dest())}) [[likely]] {
-            packing.add(packed.size(), priority);
+             store_data_with_size(_data_of(entry), packing.dest())})
+          [[likely]] {
+            packing.add(packed.size(), std::get<2>(entry));
         }
         packing.next();
     }
@@ -251,6 +554,49 @@ auto serialized_message_storage::pack_into(memory::block dest) noexcept
     return packing.info();
 }
 //------------------------------------------------------------------------------
+auto serialized_message_storage::pack_sized_into(memory::block dest) noexcept
+  -> message_pack_info {
+    message_packing_context packing{dest};
+
+    for(const auto& entry : _messages) {
+        if(packing.is_full()) {
+            break;
+        }
+        const auto message{_data_of(entry)};
+        if(message.size() <= packing.dest().size()) [[likely]] {
+            memory::copy(message, packing.dest());
+            packing.add(message.size(), std::get<2>(entry));
+        }
+        packing.next();
+    }
+    packing.finalize();
+
+    return packing.info();
+}
+//------------------------------------------------------------------------------
+auto serialized_message_storage::gather_sized(
+  const span_size_t max_size,
+  std::vector<memory::const_block>& dest) noexcept -> message_pack_info {
+    message_pack_info info{max_size};
+    message_pack_info::bit_set current_bit{1U};
+    span_size_t remaining{max_size};
+
+    for(const auto& entry : _messages) {
+        if(current_bit == 0U) {
+            break;
+        }
+        const auto message{_data_of(entry)};
+        if(message.size() <= remaining) [[likely]] {
+            dest.push_back(message);
+            info.add(message.size(), std::get<2>(entry), current_bit);
+            remaining -= message.size();
+        }
+        current_bit <<= 1U;
+    }
+
+    return info;
+}
+//------------------------------------------------------------------------------
 void serialized_message_storage::cleanup(
   const message_pack_info& packed) noexcept {
     auto to_be_removed{packed.bits()};
@@ -261,13 +607,12 @@ void serialized_message_storage::cleanup(
         while(to_be_removed) {
             if((to_be_removed & 1U) == 1U) {
                 _buffers.eat(std::move(std::get<0>(_messages[i])));
+                std::get<3>(_messages[i]) = {};
             }
             ++i;
             to_be_removed >>= 1U;
         }
-        std::erase_if(_messages, [](const auto& entry) {
-            return std::get<0>(entry).empty();
-        });
+        std::erase_if(_messages, &serialized_message_storage::_is_removed);
     }
 }
 //------------------------------------------------------------------------------
@@ -285,27 +630,52 @@ void serialized_message_storage::log_stats(main_ctx_object& user) {
 //------------------------------------------------------------------------------
 // message_priority_queue
 //------------------------------------------------------------------------------
+auto message_priority_queue::_fifo::push(stored_message message) noexcept
+  -> stored_message& {
+    if(_count == _slots.size()) [[unlikely]] {
+        _grow();
+    }
+    auto& slot{_slots[_wrap(_head + _count)]};
+    slot = std::move(message);
+    ++_count;
+    return slot;
+}
+//------------------------------------------------------------------------------
+void message_priority_queue::_fifo::rotate() noexcept {
+    if(_count < _slots.size()) {
+        _slots[_wrap(_head + _count)] = std::move(_slots[_head]);
+    }
+    _head = _wrap(_head + 1U);
+}
+//------------------------------------------------------------------------------
+void message_priority_queue::_fifo::_grow() noexcept {
+    std::vector<stored_message> slots;
+    slots.resize(std::max(_slots.size() * 2U, std::size_t(16U)));
+    for(std::size_t i = 0; i < _count; ++i) {
+        slots[i] = std::move(_slots[_wrap(_head + i)]);
+    }
+    _slots = std::move(slots);
+    _head = 0U;
+}
+//------------------------------------------------------------------------------
 auto message_priority_queue::process_all(
   const message_context& msg_ctx,
   const handler_type handler) noexcept -> span_size_t {
-    std::size_t result{_messages.size()};
-    bool clear_all{true};
-    for(auto& message : _messages) {
-        if(handler(msg_ctx, message)) {
-            _buffers.eat(message.release_buffer());
-            message.mark_too_old();
-        } else {
-            clear_all = false;
+    span_size_t result{0};
+    for(auto pos{_fifos.rbegin()}; pos != _fifos.rend(); ++pos) {
+        // handled messages are removed from the front of the ring,
+        // the unhandled ones are moved to the back keeping their order
+        for(auto count{pos->size()}; count > 0; --count) {
+            if(handler(msg_ctx, pos->front())) {
+                _buffers.eat(pos->front().release_buffer());
+                pos->pop();
+                ++result;
+            } else {
+                pos->rotate();
+            }
         }
     }
-    if(clear_all) {
-        _messages.clear();
-    } else {
-        result = std::erase_if(_messages, [](const auto& message) {
-            return message.too_many_hops();
-        });
-    }
-    return span_size(result);
+    return result;
 }
 //------------------------------------------------------------------------------
 // connection_outgoing_messages
@@ -314,7 +684,23 @@ auto connection_outgoing_messages::enqueue(
   main_ctx_object& user,
   const message_id msg_id,
   const message_view& message,
-  memory::block temp) noexcept -> bool {
+  memory::block temp,
+  const message_header_format format) noexcept -> bool {
+
+    if(format == message_header_format::compact) {
+        if(const auto serialized{
+             serialize_compact_message(msg_id, message, temp)}) [[likely]] {
+            user.log_trace("enqueuing message ${message} to be sent")
+              .arg("message", msg_id);
+            _serialized.push_with_size(serialized, message.priority);
+            return true;
+        }
+        user.log_error("failed to serialize message ${message}")
+          .arg("message", msg_id)
+          .arg("format", format)
+          .arg("size", message.data().size());
+        return false;
+    }
 
     block_data_sink sink(temp);
     default_serializer_backend backend(sink);
@@ -322,7 +708,7 @@ auto connection_outgoing_messages::enqueue(
       [[likely]] {
         user.log_trace("enqueuing message ${message} to be sent")
           .arg("message", msg_id);
-        _serialized.push(sink.done(), message.priority);
+        _serialized.push_with_size(sink.done(), message.priority);
         return true;
     } else {
         user.log_error("failed to serialize message ${message}")
@@ -335,6 +721,40 @@ auto connection_outgoing_messages::enqueue(
 //------------------------------------------------------------------------------
 // connection_incoming_messages
 //------------------------------------------------------------------------------
+void connection_incoming_messages::_unpack(
+  main_ctx_object& user,
+  const message_timestamp data_ts,
+  const memory::const_block blk) noexcept {
+    _unpacked.push_if([&user, data_ts, blk](
+                        message_id& msg_id,
+                        message_timestamp& msg_ts,
+                        stored_message& message) {
+        if(compact_message_header::is_compact(blk)) {
+            if(deserialize_compact_message(msg_id, message, blk)) [[likely]] {
+                msg_ts = data_ts;
+                return true;
+            }
+            user.log_error("failed to deserialize message")
+              .arg("format", message_header_format::compact)
+              .arg("block", blk);
+            return false;
+        }
+        block_data_source source(blk);
+        default_deserializer_backend backend(source);
+        if(const auto deserialized{deserialize_message(msg_id, message, backend)})
+          [[likely]] {
+            user.log_trace("fetched message ${message}").arg("message", msg_id);
+            msg_ts = data_ts;
+            return true;
+        } else {
+            user.log_error("failed to deserialize message")
+              .arg("errors", get_errors(deserialized))
+              .arg("block", blk);
+            return false;
+        }
+    });
+}
+//------------------------------------------------------------------------------
 auto connection_incoming_messages::fetch_messages(
   main_ctx_object& user,
   const fetch_handler handler) noexcept -> bool {
@@ -345,25 +765,7 @@ auto connection_incoming_messages::fetch_messages(
         for_each_data_with_size(
           data, [this, &user, data_ts](const memory::const_block blk) {
               if(not blk.empty()) [[likely]] {
-                  _unpacked.push_if([&user, data_ts, blk](
-                                      message_id& msg_id,
-                                      message_timestamp& msg_ts,
-                                      stored_message& message) {
-                      block_data_source source(blk);
-                      default_deserializer_backend backend(source);
-                      if(const auto deserialized{deserialize_message(
-                           msg_id, message, backend)}) [[likely]] {
-                          user.log_trace("fetched message ${message}")
-                            .arg("message", msg_id);
-                          msg_ts = data_ts;
-                          return true;
-                      } else {
-                          user.log_error("failed to deserialize message")
-                            .arg("errors", get_errors(deserialized))
-                            .arg("block", blk);
-                          return false;
-                      }
-                  });
+                  _unpack(user, data_ts, blk);
               }
           });
         return true;
@@ -375,4 +777,53 @@ auto connection_incoming_messages::fetch_messages(
     return false;
 }
 //------------------------------------------------------------------------------
+auto connection_incoming_messages::fetch_serialized(
+  main_ctx_object& user,
+  const fetch_serialized_handler handler) noexcept -> bool {
+    some_true something_done{};
+    const auto deserialized_handler{
+      [&](
+        const message_id msg_id,
+        const message_age msg_age,
+        const message_view& message) -> bool {
+          return handler(msg_id, msg_age, message, {});
+      }};
+    // messages left over from previous fetches go first
+    something_done(_unpacked.fetch_all({construct_from, deserialized_handler}));
+
+    const auto now{message_timestamp_now()};
+    const auto unpacker{[&, this](
+                          const message_timestamp data_ts,
+                          const message_priority,
+                          const memory::const_block data) {
+        const auto msg_age{message_age_since(data_ts, now)};
+        for_each_data_with_size(data, [&](const memory::const_block blk) {
+            if(blk.empty()) [[unlikely]] {
+                return;
+            }
+            identifier class_id{};
+            identifier method_id{};
+            message_info info{};
+            if(compact_message_header::load(blk, class_id, method_id, info)) {
+                // the content is passed as a view into the received block
+                const message_id msg_id{class_id, method_id};
+                const message_view message{
+                  info, skip(blk, compact_message_header::size())};
+                if(not handler(msg_id, msg_age, message, blk)) {
+                    _unpack(user, data_ts, blk);
+                }
+                something_done();
+            } else {
+                _unpack(user, data_ts, blk);
+            }
+        });
+        return true;
+    }};
+    if(_packed.fetch_all({construct_from, unpacker})) {
+        something_done(
+          _unpacked.fetch_all({construct_from, deserialized_handler}));
+    }
+    return something_done;
+}
+//------------------------------------------------------------------------------
 } // namespace eagine::msgbus
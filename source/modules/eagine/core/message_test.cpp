@@ -414,6 +414,106 @@ void message_storage_push_if_fetch(unsigned, auto& s) {
     test.check_equal(storage.count(), 0U, "count is zero");
 }
 //------------------------------------------------------------------------------
+// message storage recycle
+//------------------------------------------------------------------------------
+void message_storage_recycle(unsigned, auto& s) {
+    eagitest::case_ test{s, 18, "message storage recycle"};
+    auto& rg{test.random()};
+
+    eagine::msgbus::message_storage storage;
+    std::vector<eagine::byte> content;
+    eagine::span_size_t expected{0};
+
+    for(unsigned r = 0; r < test.repeats(50); ++r) {
+        const auto pc{rg.get_between<eagine::span_size_t>(0, 100)};
+        for(eagine::span_size_t m = 0; m < pc; ++m) {
+            // mostly small messages with an occasional large one
+            content.resize(
+              rg.get_between<std::size_t>(0U, rg.get_bool() ? 200U : 2000U));
+            rg.fill(content);
+            const eagine::message_id msg_id{
+              eagine::random_identifier(), eagine::random_identifier()};
+            eagine::msgbus::message_view message{eagine::view(content)};
+            message.set_sequence_no(
+              eagine::msgbus::message_sequence_t(content.size()));
+            storage.push(msg_id, message);
+            ++expected;
+        }
+        test.check_equal(storage.count(), expected, "count");
+
+        storage.fetch_all(
+          {eagine::construct_from,
+           [&](
+             const eagine::message_id,
+             const eagine::msgbus::message_age,
+             const eagine::msgbus::message_view& msg) {
+               test.check_equal(
+                 msg.data().size(),
+                 eagine::span_size(msg.sequence_no),
+                 "content size");
+               if(rg.get_bool()) {
+                   --expected;
+                   return true;
+               }
+               return false;
+           }});
+        test.check_equal(storage.count(), expected, "count");
+        test.check_equal(storage.empty(), expected == 0, "empty");
+    }
+}
+//------------------------------------------------------------------------------
+// message mac
+//------------------------------------------------------------------------------
+void message_mac_check(
+  eagitest::case_& test,
+  eagine::msgbus::context& ctx,
+  const eagine::memory::const_block key,
+  const eagine::memory::const_block data,
+  const std::string_view expected,
+  const char* label) {
+    const auto mac{ctx.compute_message_mac(key, data)};
+    test.ensure(mac.has_value(), label);
+    const std::string_view digits{"0123456789abcdef"};
+    std::string hex;
+    for(const auto b : *mac) {
+        hex.push_back(digits[std::to_integer<unsigned>(b) >> 4U]);
+        hex.push_back(digits[std::to_integer<unsigned>(b) & 0x0FU]);
+    }
+    test.check_equal(hex, std::string{expected}, label);
+}
+//------------------------------------------------------------------------------
+void message_mac_rfc4231(auto& s) {
+    eagitest::case_ test{s, 19, "message mac"};
+    const auto ctx{eagine::msgbus::make_context(s.context())};
+
+    const std::vector<eagine::byte> key1(20U, eagine::byte(0x0bU));
+    message_mac_check(
+      test,
+      *ctx,
+      eagine::view(key1),
+      eagine::memory::as_bytes(std::string_view{"Hi There"}),
+      "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7",
+      "case 1");
+
+    message_mac_check(
+      test,
+      *ctx,
+      eagine::memory::as_bytes(std::string_view{"Jefe"}),
+      eagine::memory::as_bytes(std::string_view{"what do ya want for nothing?"}),
+      "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843",
+      "case 2");
+
+    const std::vector<eagine::byte> key6(131U, eagine::byte(0xaaU));
+    message_mac_check(
+      test,
+      *ctx,
+      eagine::view(key6),
+      eagine::memory::as_bytes(std::string_view{
+        "Test Using Larger Than Block-Size Key - Hash Key First"}),
+      "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54",
+      "case 6");
+}
+//------------------------------------------------------------------------------
 // serialized message storage push cleanup
 //------------------------------------------------------------------------------
 void serialized_message_storage_push_cleanup(unsigned, auto& s) {
@@ -663,10 +763,283 @@ void connection_in_out_messages_push_fetch(unsigned, auto& s) {
     test.check_equal(nout, ninc, "all transferred");
 }
 //------------------------------------------------------------------------------
+void connection_in_out_messages_gather_fetch(unsigned, auto& s) {
+    eagitest::case_ test{s, 14, "connection in/out messages gather fetch"};
+    eagitest::track trck{test, 0, 2};
+    auto& rg{test.random()};
+
+    eagine::msgbus::connection_outgoing_messages out;
+    eagine::msgbus::connection_incoming_messages inc;
+
+    eagine::main_ctx_object user{"Test", s.context()};
+    eagine::span_size_t nout{0};
+    eagine::span_size_t ninc{0};
+
+    const auto fetch_func = [&](
+                              const eagine::message_id msg_id,
+                              const eagine::msgbus::message_age,
+                              const eagine::msgbus::message_view& msg) {
+        test.check(
+          eagine::are_equal(
+            msg.content(),
+            eagine::memory::as_bytes(msg_id.method().name().view())),
+          "content");
+        trck.checkpoint(2);
+        ++ninc;
+        return true;
+    };
+
+    std::vector<eagine::byte> temp;
+    std::vector<eagine::byte> frame;
+    std::vector<eagine::memory::const_block> gathered;
+
+    const auto transfer = [&](eagine::span_size_t max_size) {
+        gathered.clear();
+        const auto packed{out.gather_into(max_size, gathered)};
+        test.check(packed.used() <= max_size, "fits");
+        frame.clear();
+        for(const auto blk : gathered) {
+            frame.insert(frame.end(), blk.begin(), blk.end());
+        }
+        test.check_equal(
+          eagine::span_size(frame.size()), packed.used(), "gathered size");
+        inc.push(eagine::view(frame));
+        out.cleanup(packed);
+    };
+
+    for(unsigned r = 0; r < test.repeats(10); ++r) {
+        temp.resize(1U << rg.get_std_size(8, 15));
+        const auto mc{test.random().get_between(1U, 100U)};
+        for(unsigned m = 0; m < mc; ++m) {
+            const eagine::message_id msg_id{
+              eagine::random_identifier(), eagine::random_identifier()};
+            eagine::msgbus::message_view message{
+              eagine::memory::as_bytes(msg_id.method().name().view())};
+            test.check(
+              out.enqueue(user, msg_id, message, eagine::cover(temp)),
+              "enqueued");
+            ++nout;
+            trck.checkpoint(1);
+        }
+
+        transfer(eagine::span_size(temp.size()));
+
+        if(rg.get_bool()) {
+            inc.fetch_messages(user, {eagine::construct_from, fetch_func});
+        }
+    }
+    while(not out.empty()) {
+        transfer(eagine::span_size(temp.size()));
+    }
+
+    while(not inc.empty()) {
+        inc.fetch_messages(user, {eagine::construct_from, fetch_func});
+    }
+
+    test.check_equal(nout, ninc, "all transferred");
+}
+//------------------------------------------------------------------------------
+// compact header
+//------------------------------------------------------------------------------
+void message_compact_roundtrip(unsigned, auto& s) {
+    eagitest::case_ test{s, 15, "compact message round-trip"};
+    auto& rg{test.random()};
+
+    std::vector<eagine::byte> buffer{};
+    std::vector<eagine::byte> content{};
+    content.resize(rg.get_between<std::size_t>(0, 1280));
+    rg.fill(content);
+    buffer.resize(content.size() + 64U);
+
+    const eagine::message_id msg_id{
+      eagine::random_identifier(), eagine::random_identifier()};
+    eagine::msgbus::message_view message{eagine::view(content)};
+    message.set_source_id(eagine::random_identifier().value());
+    message.set_target_id(eagine::random_identifier().value());
+    message.set_sequence_no(
+      rg.get_between<eagine::msgbus::message_sequence_t>(0U, 1000000U));
+    message.set_priority(eagine::msgbus::message_priority::high);
+    message.add_age(std::chrono::seconds{2});
+    message.add_hop();
+
+    const auto serialized{eagine::msgbus::serialize_compact_message(
+      msg_id, message, eagine::cover(buffer))};
+    test.ensure(not serialized.empty(), "serialized");
+    test.check(
+      eagine::msgbus::compact_message_header::is_compact(serialized),
+      "is compact");
+    test.check_equal(
+      serialized.size(),
+      eagine::msgbus::compact_message_header::size() +
+        eagine::span_size(content.size()),
+      "size ok");
+
+    // patch the routing fields in place
+    eagine::msgbus::message_info routed{message};
+    routed.add_hop();
+    routed.add_age(std::chrono::seconds{1});
+    routed.set_source_id(eagine::random_identifier().value());
+    eagine::msgbus::compact_message_header::patch_routing(
+      eagine::head(eagine::cover(buffer), serialized.size()), routed);
+
+    eagine::message_id dest_id{};
+    eagine::msgbus::stored_message dest;
+    test.ensure(
+      eagine::msgbus::deserialize_compact_message(dest_id, dest, serialized),
+      "deserialized");
+
+    test.check(dest_id == msg_id, "message id ok");
+    test.check(dest.source_id == routed.source_id, "source ok");
+    test.check(dest.target_id == message.target_id, "target ok");
+    test.check(dest.sequence_no == message.sequence_no, "sequence ok");
+    test.check(dest.priority == message.priority, "priority ok");
+    test.check_equal(dest.hop_count, routed.hop_count, "hop count ok");
+    test.check_equal(
+      dest.age_quarter_seconds, routed.age_quarter_seconds, "age ok");
+    test.check(
+      eagine::are_equal(eagine::view(content), dest.const_content()),
+      "content ok");
+}
+//------------------------------------------------------------------------------
+void connection_in_out_messages_mixed_formats(unsigned, auto& s) {
+    eagitest::case_ test{s, 16, "connection in/out messages mixed formats"};
+    eagitest::track trck{test, 0, 2};
+    auto& rg{test.random()};
+
+    eagine::msgbus::connection_outgoing_messages out;
+    eagine::msgbus::connection_incoming_messages inc;
+
+    eagine::main_ctx_object user{"Test", s.context()};
+    eagine::span_size_t nout{0};
+    eagine::span_size_t ninc{0};
+
+    const auto fetch_func = [&](
+                              const eagine::message_id msg_id,
+                              const eagine::msgbus::message_age,
+                              const eagine::msgbus::message_view& msg) {
+        test.check(
+          eagine::are_equal(
+            msg.content(),
+            eagine::memory::as_bytes(msg_id.method().name().view())),
+          "content");
+        trck.checkpoint(2);
+        ++ninc;
+        return true;
+    };
+
+    std::vector<eagine::byte> temp;
+    temp.resize(4096);
+    for(unsigned r = 0; r < test.repeats(10); ++r) {
+        const auto mc{test.random().get_between(1U, 50U)};
+        for(unsigned m = 0; m < mc; ++m) {
+            const eagine::message_id msg_id{
+              eagine::random_identifier(), eagine::random_identifier()};
+            eagine::msgbus::message_view message{
+              eagine::memory::as_bytes(msg_id.method().name().view())};
+            test.check(
+              out.enqueue(
+                user,
+                msg_id,
+                message,
+                eagine::cover(temp),
+                rg.get_bool() ? eagine::msgbus::message_header_format::compact
+                              : eagine::msgbus::message_header_format::portable),
+              "enqueued");
+            ++nout;
+            trck.checkpoint(1);
+        }
+        while(not out.empty()) {
+            const auto packed{out.pack_into(eagine::cover(temp))};
+            inc.push(head(eagine::view(temp), packed.used()));
+            out.cleanup(packed);
+        }
+        inc.fetch_messages(user, {eagine::construct_from, fetch_func});
+    }
+
+    test.check_equal(nout, ninc, "all transferred");
+}
+//------------------------------------------------------------------------------
+void connection_in_out_messages_shared_forward(unsigned, auto& s) {
+    eagitest::case_ test{s, 17, "connection in/out messages shared forward"};
+    eagitest::track trck{test, 0, 2};
+
+    eagine::msgbus::connection_outgoing_messages out1;
+    eagine::msgbus::connection_outgoing_messages out2;
+    eagine::msgbus::connection_incoming_messages inc;
+
+    eagine::main_ctx_object user{"Test", s.context()};
+    eagine::span_size_t nout{0};
+    eagine::span_size_t ninc{0};
+    const auto router_id{eagine::random_identifier().value()};
+
+    const auto fetch_func = [&](
+                              const eagine::message_id msg_id,
+                              const eagine::msgbus::message_age,
+                              const eagine::msgbus::message_view& msg,
+                              const eagine::memory::const_block serialized) {
+        test.check(not serialized.empty(), "serialized");
+        test.check(
+          eagine::are_equal(
+            msg.content(),
+            eagine::memory::as_bytes(msg_id.method().name().view())),
+          "content");
+        test.check(msg.source_id == router_id, "source ok");
+        test.check_equal(
+          msg.hop_count,
+          eagine::msgbus::message_info::hop_count_t(1),
+          "hop count ok");
+        trck.checkpoint(2);
+        ++ninc;
+        return true;
+    };
+
+    std::vector<eagine::byte> temp;
+    temp.resize(4096);
+    std::vector<eagine::byte> received;
+    received.resize(4096);
+    for(unsigned r = 0; r < test.repeats(10); ++r) {
+        const auto mc{test.random().get_between(1U, 20U)};
+        for(unsigned m = 0; m < mc; ++m) {
+            const eagine::message_id msg_id{
+              eagine::random_identifier(), eagine::random_identifier()};
+            eagine::msgbus::message_view message{
+              eagine::memory::as_bytes(msg_id.method().name().view())};
+            message.set_source_id(eagine::random_identifier().value());
+            const auto serialized{eagine::msgbus::serialize_compact_message(
+              msg_id, message, eagine::cover(received))};
+            test.ensure(not serialized.empty(), "serialized");
+
+            eagine::msgbus::message_info routed{message};
+            routed.add_hop();
+            routed.set_source_id(router_id);
+            // copied when first enqueued, shared by the second queue
+            const auto forwarded{
+              eagine::msgbus::shared_serialized_message::deferred(
+                serialized, routed)};
+            test.ensure(bool(forwarded), "forwarded");
+            // the same bytes are queued in both outgoing connections
+            out1.enqueue_shared(forwarded, message.priority);
+            out2.enqueue_shared(forwarded, message.priority);
+            nout += 2;
+            trck.checkpoint(1);
+        }
+        for(auto* out : {&out1, &out2}) {
+            while(not out->empty()) {
+                const auto packed{out->pack_into(eagine::cover(temp))};
+                inc.push(head(eagine::view(temp), packed.used()));
+                out->cleanup(packed);
+            }
+        }
+        inc.fetch_serialized(user, {eagine::construct_from, fetch_func});
+    }
+
+    test.check_equal(nout, ninc, "all transferred");
+}
+//------------------------------------------------------------------------------
 // main
 //------------------------------------------------------------------------------
 auto test_main(eagine::test_ctx& ctx) -> int {
-    eagitest::ctx_suite test{ctx, "message", 13};
+    eagitest::ctx_suite test{ctx, "message", 19};
     test.once(message_valid_endpoint_id);
     test.once(message_is_special);
     test.once(message_serialize_header_roundtrip);
@@ -680,6 +1053,12 @@ auto test_main(eagine::test_ctx& ctx) -> int {
     test.repeat(10, serialized_message_storage_push_fetch);
     test.repeat(10, serialized_message_storage_push_if_fetch);
     test.repeat(10, connection_in_out_messages_push_fetch);
+    test.repeat(10, connection_in_out_messages_gather_fetch);
+    test.repeat(100, message_compact_roundtrip);
+    test.repeat(10, connection_in_out_messages_mixed_formats);
+    test.repeat(10, connection_in_out_messages_shared_forward);
+    test.repeat(10, message_storage_recycle);
+    test.once(message_mac_rfc4231);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------
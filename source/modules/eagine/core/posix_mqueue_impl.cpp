@@ -99,6 +99,12 @@ public:
         return (_last_errno == EAGAIN) or (_last_errno == ETIMEDOUT);
     }
 
+    /// @brief Indicates if a previous send failed because the queue was full.
+    /// @see needs_retry
+    auto was_full() const noexcept -> bool {
+        return _last_errno == EAGAIN;
+    }
+
     /// @brief Indicates if this message queue is open.
     /// @see is_usable
     constexpr auto is_open() const noexcept -> bool {
@@ -140,6 +146,19 @@ public:
         return 2 * 1024;
     }
 
+    constexpr static auto default_queue_depth() noexcept -> span_size_t {
+        return 8;
+    }
+
+    /// @brief Sets the queue depth and message size used by create.
+    /// @see create
+    auto set_limits(const span_size_t depth, const span_size_t size) noexcept
+      -> posix_mqueue& {
+        _queue_depth = depth;
+        _message_size = size;
+        return *this;
+    }
+
     /// @brief Returns the absolute maximum block size that can be sent in a message.
     /// @see data_size
     auto max_data_size() noexcept -> valid_if_positive<span_size_t>;
@@ -161,6 +180,18 @@ public:
     /// @brief Receives messages and calls the specified handler on them.
     auto receive(memory::span<char>, const receive_handler) noexcept -> bool;
 
+    /// @brief Returns the handle of the receiving queue if it can be polled.
+    /// @see connection_readiness
+    auto pollable_handle() const noexcept -> std::optional<int> {
+#if defined(__linux__)
+        // on Linux message queue descriptors are file descriptors
+        if(is_usable()) [[likely]] {
+            return {int(_ihandle)};
+        }
+#endif
+        return {};
+    }
+
 private:
     std::string _s2cname{};
     std::string _c2sname{};
@@ -169,8 +200,13 @@ private:
         return ::mqd_t(-1);
     }
 
+    auto _create(const span_size_t depth, const span_size_t size) noexcept
+      -> int;
+
     ::mqd_t _ihandle{_invalid_handle()};
     ::mqd_t _ohandle{_invalid_handle()};
+    span_size_t _queue_depth{default_queue_depth()};
+    span_size_t _message_size{default_data_size()};
     int _last_errno{0};
 };
 //------------------------------------------------------------------------------
@@ -181,6 +217,8 @@ posix_mqueue::posix_mqueue(posix_mqueue&& temp) noexcept
     swap(_c2sname, temp._c2sname);
     swap(_ihandle, temp._ihandle);
     swap(_ohandle, temp._ohandle);
+    swap(_queue_depth, temp._queue_depth);
+    swap(_message_size, temp._message_size);
 }
 //------------------------------------------------------------------------------
 posix_mqueue::~posix_mqueue() noexcept {
@@ -246,13 +284,13 @@ auto posix_mqueue::unlink() noexcept -> posix_mqueue& {
     return *this;
 }
 //------------------------------------------------------------------------------
-auto posix_mqueue::create() noexcept -> posix_mqueue& {
-    log_debug("creating new message queue ${name}").arg("name", get_name());
-
+auto posix_mqueue::_create(
+  const span_size_t depth,
+  const span_size_t size) noexcept -> int {
     struct ::mq_attr attr {};
     zero(as_bytes(cover_one(attr)));
-    attr.mq_maxmsg = limit_cast<long>(8);
-    attr.mq_msgsize = limit_cast<long>(default_data_size());
+    attr.mq_maxmsg = limit_cast<long>(depth);
+    attr.mq_msgsize = limit_cast<long>(size);
     errno = 0;
     // NOLINTNEXTLINE(hicpp-vararg)
     _ihandle = ::mq_open(
@@ -273,6 +311,31 @@ auto posix_mqueue::create() noexcept -> posix_mqueue& {
           S_IRUSR | S_IWUSR,
           &attr);
         _last_errno = errno;
+        if(_last_errno) {
+            ::mq_close(_ihandle);
+            ::mq_unlink(_c2sname.c_str());
+            _ihandle = _invalid_handle();
+        }
+    }
+    return _last_errno;
+}
+//------------------------------------------------------------------------------
+auto posix_mqueue::create() noexcept -> posix_mqueue& {
+    log_debug("creating new message queue ${name}")
+      .arg("name", get_name())
+      .arg("depth", _queue_depth)
+      .arg("size", "ByteSize", _message_size);
+
+    if(_create(_queue_depth, _message_size) == EINVAL) [[unlikely]] {
+        // the system limits (fs.mqueue.msg_max, fs.mqueue.msgsize_max)
+        // may be lower than the configured values
+        log_warning("falling back to default limits of message queue ${name}")
+          .arg("name", get_name())
+          .arg("depth", _queue_depth)
+          .arg("size", "ByteSize", _message_size);
+        _queue_depth = default_queue_depth();
+        _message_size = default_data_size();
+        _create(_queue_depth, _message_size);
     }
     if(_last_errno) {
         log_error("failed to create message queue ${name}")
@@ -381,6 +444,9 @@ auto posix_mqueue::receive(
 // connection
 //------------------------------------------------------------------------------
 struct posix_mqueue_shared_state {
+    span_size_t queue_depth{posix_mqueue::default_queue_depth()};
+    span_size_t message_size{posix_mqueue::default_data_size()};
+
     auto make_id() const noexcept {
         return random_identifier();
     }
@@ -412,6 +478,15 @@ public:
     return limit_cast<unsigned>(std::to_underlying(priority));
 }
 //------------------------------------------------------------------------------
+// Queue messages packing several size-prefixed messages are sent with their
+// priority raised by this offset, so that they can be told apart from queue
+// messages carrying a single serialized message sent by peers which do not
+// support the packing. The client announces the support in the sequence
+// number of the connection request and switches to packing when it receives
+// the first packed queue message from the server.
+static constexpr const unsigned posix_mqueue_packed_priority{8U};
+static constexpr const message_sequence_t posix_mqueue_packed_format{1U};
+//------------------------------------------------------------------------------
 /// @brief Implementation of connection on top of POSIX message queues.
 /// @ingroup msgbus
 /// @see posix_mqueue
@@ -430,10 +505,23 @@ public:
       main_ctx_parent parent,
       shared_holder<posix_mqueue_shared_state> shared_state) noexcept;
 
+    posix_mqueue_connection(posix_mqueue_connection&&) = delete;
+    posix_mqueue_connection(const posix_mqueue_connection&) = delete;
+    auto operator=(posix_mqueue_connection&&) = delete;
+    auto operator=(const posix_mqueue_connection&) = delete;
+
+    ~posix_mqueue_connection() noexcept override;
+
     /// @brief Opens the connection.
-    auto open(std::string name) noexcept -> bool {
+    /// @param packed indicates if the client announced the packed format.
+    auto open(std::string name, const bool packed) noexcept -> bool {
         const std::unique_lock lock_data_queue{_mutex_data_queue};
-        return not _data_queue.set_name(std::move(name)).open().had_error();
+        if(not _data_queue.set_name(std::move(name)).open().had_error()) {
+            _packed_format = packed;
+            _resize_buffers();
+            return true;
+        }
+        return false;
     }
 
     auto is_usable() noexcept -> bool final {
@@ -442,7 +530,8 @@ public:
     }
 
     auto max_data_size() noexcept -> valid_if_positive<span_size_t> final {
-        return {_buffer.size()};
+        const std::unique_lock lock_outgoing{_mutex_outgoing};
+        return {_push_buffer.size()};
     }
 
     auto update() noexcept -> work_done override {
@@ -458,26 +547,57 @@ public:
     auto fetch_messages(const fetch_handler handler) noexcept
       -> work_done final {
         const std::unique_lock lock{_mutex_incoming};
-        return _incoming.fetch_all(handler);
+        some_true something_done{_legacy_incoming.fetch_all(handler)};
+        something_done(_incoming.fetch_messages(*this, handler));
+        return something_done;
     }
 
-    auto query_statistics(connection_statistics&) noexcept -> bool final {
-        return false;
+    auto query_statistics(connection_statistics& stats) noexcept
+      -> bool final {
+        const std::unique_lock lock_data_queue{_mutex_data_queue};
+        if(_sent_blocks > 0) {
+            stats.block_usage_ratio =
+              float(_sent_bytes) /
+              (float(_sent_blocks) * float(std::max(_buffer.size(), span_size_t(1))));
+        }
+        stats.block_size = limit_cast<std::int32_t>(_buffer.size());
+        stats.queue_full_count = limit_cast<std::int32_t>(std::min(
+          _queue_full_count,
+          span_size_t(std::numeric_limits<std::int32_t>::max())));
+        return true;
     }
 
     auto routing_weight() noexcept -> float final {
         return 1.0F;
     }
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        {
+            const std::unique_lock lock_outgoing{_mutex_outgoing};
+            if(not _outgoing.empty() or not _legacy_outgoing.empty()) {
+                return false;
+            }
+        }
+        const std::unique_lock lock_data_queue{_mutex_data_queue};
+        if(const auto handle{_data_queue.pollable_handle()}) {
+            readiness->watch(*handle);
+            return true;
+        }
+        return false;
+    }
+
 protected:
     auto _reconnect(posix_mqueue& connect_queue) noexcept -> work_done;
     auto _checkup(posix_mqueue& connect_queue) noexcept -> work_done;
     auto _receive() noexcept -> work_done;
-    auto _send() noexcept -> bool;
+    auto _send() noexcept -> work_done;
+    void _resize_buffers() noexcept;
 
     auto _handle_send(
       const message_timestamp,
-      const message_priority priority,
+      const message_priority,
       const memory::const_block data) noexcept -> bool;
 
     void _handle_receive(
@@ -487,10 +607,21 @@ protected:
     std::mutex _mutex_data_queue;
     std::mutex _mutex_incoming;
     std::mutex _mutex_outgoing;
+    // used for packing and receiving, guarded by _mutex_data_queue
     memory::buffer _buffer;
-    message_storage _incoming;
-    serialized_message_storage _outgoing;
+    // used for serialization, guarded by _mutex_outgoing
+    memory::buffer _push_buffer;
+    connection_incoming_messages _incoming;
+    connection_outgoing_messages _outgoing;
+    // single messages exchanged with peers not supporting the packing
+    message_storage _legacy_incoming;
+    serialized_message_storage _legacy_outgoing;
+    std::atomic<bool> _packed_format{false};
     posix_mqueue _data_queue{*this};
+    span_size_t _sent_blocks{0};
+    span_size_t _sent_messages{0};
+    span_size_t _sent_bytes{0};
+    span_size_t _queue_full_count{0};
     timeout _reconnect_timeout{std::chrono::seconds{2}, nothing};
     shared_holder<posix_mqueue_shared_state> _shared_state;
 };
@@ -501,18 +632,42 @@ posix_mqueue_connection::posix_mqueue_connection(
   : main_ctx_object{"MQueConn", parent}
   , _shared_state{std::move(shared_state)} {
     const std::unique_lock lock_data_queue{_mutex_data_queue};
+    _data_queue.set_limits(
+      _shared_state->queue_depth, _shared_state->message_size);
+    _resize_buffers();
+}
+//------------------------------------------------------------------------------
+posix_mqueue_connection::~posix_mqueue_connection() noexcept {
+    if(_sent_blocks > 0) {
+        log_stat("message queue statistics")
+          .tag("mqueStats")
+          .arg("blocks", _sent_blocks)
+          .arg("messages", _sent_messages)
+          .arg("bytes", "ByteSize", _sent_bytes)
+          .arg("queueFull", _queue_full_count)
+          .arg("msgsPerBlk", float(_sent_messages) / float(_sent_blocks));
+    }
+}
+//------------------------------------------------------------------------------
+void posix_mqueue_connection::_resize_buffers() noexcept {
     _buffer.resize(_data_queue.data_size());
+    const std::unique_lock lock_outgoing{_mutex_outgoing};
+    _push_buffer.resize(_buffer.size());
 }
 //------------------------------------------------------------------------------
 auto posix_mqueue_connection::send(
   const message_id msg_id,
   const message_view& message) noexcept -> bool {
     if(is_usable()) [[likely]] {
-        block_data_sink sink(cover(_buffer));
+        const std::unique_lock lock_outgoing{_mutex_outgoing};
+        if(_packed_format) [[likely]] {
+            return _outgoing.enqueue(
+              *this, msg_id, message, cover(_push_buffer));
+        }
+        block_data_sink sink(cover(_push_buffer));
         default_serializer_backend backend(sink);
         if(serialize_message(msg_id, message, backend)) [[likely]] {
-            const std::unique_lock lock_outgoing{_mutex_outgoing};
-            _outgoing.push(sink.done(), message.priority);
+            _legacy_outgoing.push(sink.done(), message.priority);
             return true;
         }
         log_error("failed to serialize message");
@@ -544,14 +699,40 @@ auto posix_mqueue_connection::_receive() noexcept -> work_done {
     return something_done;
 }
 //------------------------------------------------------------------------------
-auto posix_mqueue_connection::_send() noexcept -> bool {
+auto posix_mqueue_connection::_send() noexcept -> work_done {
+    some_true something_done{};
     const std::unique_lock lock_data_queue{_mutex_data_queue};
     if(_data_queue.is_usable()) [[likely]] {
         const std::unique_lock lock_outgoing{_mutex_outgoing};
-        return _outgoing.fetch_all(
-          make_callable_ref<&posix_mqueue_connection::_handle_send>(this));
+        if(not _legacy_outgoing.empty()) [[unlikely]] {
+            something_done(_legacy_outgoing.fetch_all(
+              make_callable_ref<&posix_mqueue_connection::_handle_send>(
+                this)));
+        }
+        while(not _outgoing.empty()) {
+            // pack as many messages as fit into a single queue message
+            const auto packed{_outgoing.pack_into(cover(_buffer))};
+            if(packed.is_empty()) [[unlikely]] {
+                break;
+            }
+            _data_queue.send(
+              posix_mqueue_translate_priority(packed.max_priority()) +
+                posix_mqueue_packed_priority,
+              head(as_chars(cover(_buffer)), packed.used()));
+            if(_data_queue.had_error()) [[unlikely]] {
+                if(_data_queue.was_full()) {
+                    ++_queue_full_count;
+                }
+                break;
+            }
+            _outgoing.cleanup(packed);
+            ++_sent_blocks;
+            _sent_messages += packed.count();
+            _sent_bytes += packed.used();
+            something_done();
+        }
     }
-    return false;
+    return something_done;
 }
 //------------------------------------------------------------------------------
 auto posix_mqueue_connection::_reconnect(posix_mqueue& connect_queue) noexcept
@@ -567,6 +748,8 @@ auto posix_mqueue_connection::_reconnect(posix_mqueue& connect_queue) noexcept
               .arg("name", connect_queue.get_name());
 
             if(not _data_queue.set_name(_shared_state->make_id())
+                     .set_limits(
+                       _shared_state->queue_depth, _shared_state->message_size)
                      .create()
                      .had_error()) {
 
@@ -574,14 +757,15 @@ auto posix_mqueue_connection::_reconnect(posix_mqueue& connect_queue) noexcept
 
                 block_data_sink sink(cover(_buffer));
                 default_serializer_backend backend(sink);
+                _packed_format = false;
+                message_view request{_data_queue.get_name()};
+                request.set_sequence_no(posix_mqueue_packed_format);
                 if(serialize_message(
-                     msgbus_id{"pmqConnect"},
-                     message_view(_data_queue.get_name()),
-                     backend)) [[likely]] {
+                     msgbus_id{"pmqConnect"}, request, backend)) [[likely]] {
                     connect_queue.send(
                       posix_mqueue_translate_priority(message_priority::normal),
                       as_chars(sink.done()));
-                    _buffer.resize(_data_queue.data_size());
+                    _resize_buffers();
                     something_done();
                 } else {
                     log_error("failed to serialize connection name")
@@ -603,18 +787,34 @@ auto posix_mqueue_connection::_handle_send(
   const message_priority priority,
   const memory::const_block data) noexcept -> bool {
     const auto uprio{posix_mqueue_translate_priority(priority)};
-    return not _data_queue.send(uprio, as_chars(data)).had_error();
+    if(_data_queue.send(uprio, as_chars(data)).had_error()) [[unlikely]] {
+        if(_data_queue.was_full()) {
+            ++_queue_full_count;
+        }
+        return false;
+    }
+    ++_sent_blocks;
+    ++_sent_messages;
+    _sent_bytes += data.size();
+    return true;
 }
 //------------------------------------------------------------------------------
 void posix_mqueue_connection::_handle_receive(
-  const unsigned,
+  const unsigned priority,
   const memory::span<const char> data) noexcept {
-    _incoming.push_if(
-      [data](message_id& msg_id, message_timestamp&, stored_message& message) {
-          block_data_source source(as_bytes(data));
-          default_deserializer_backend backend(source);
-          return bool(deserialize_message(msg_id, message, backend));
-      });
+    if(priority >= posix_mqueue_packed_priority) [[likely]] {
+        _incoming.push(as_bytes(data));
+        _packed_format = true;
+    } else {
+        _legacy_incoming.push_if([data](
+                                   message_id& msg_id,
+                                   message_timestamp&,
+                                   stored_message& message) {
+            block_data_source source(as_bytes(data));
+            default_deserializer_backend backend(source);
+            return bool(deserialize_message(msg_id, message, backend));
+        });
+    }
 }
 //------------------------------------------------------------------------------
 // connector
@@ -736,6 +936,16 @@ public:
     auto process_accepted(const accept_handler handler) noexcept
       -> work_done final;
 
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        if(const auto handle{_accept_queue.pollable_handle()}) {
+            readiness->watch(*handle);
+            return true;
+        }
+        return false;
+    }
+
 private:
     auto _checkup() noexcept -> work_done;
     auto _receive() noexcept -> work_done;
@@ -764,7 +974,9 @@ auto posix_mqueue_acceptor::process_accepted(
 
         if(unique_holder<posix_mqueue_connection> conn{
              default_selector, *this, _shared_state}) {
-            if(conn->open(to_string(message.text_content()))) {
+            if(conn->open(
+                 to_string(message.text_content()),
+                 message.sequence_no == posix_mqueue_packed_format)) {
                 handler(std::move(conn));
             }
         }
@@ -833,6 +1045,7 @@ public:
     posix_mqueue_connection_factory(main_ctx_parent parent) noexcept
       : main_ctx_object{"MQueConnFc", parent} {
         _increase_res_limit();
+        _init_limits();
     }
 
     using connection_factory::make_acceptor;
@@ -866,6 +1079,41 @@ private:
         errno = 0;
         ::setrlimit(RLIMIT_MSGQUEUE, &rlim);
     }
+
+    void _init_limits() noexcept {
+        auto depth{std::max(
+          app_config()
+            .get<span_size_t>("msgbus.posix_mqueue.queue_depth")
+            .value_or(posix_mqueue::default_queue_depth()),
+          span_size_t(1))};
+        const auto size{std::max(
+          app_config()
+            .get<span_size_t>("msgbus.posix_mqueue.message_size")
+            .value_or(posix_mqueue::default_data_size()),
+          posix_mqueue::default_data_size())};
+
+        struct rlimit rlim {};
+        zero(as_bytes(cover_one(rlim)));
+        if(::getrlimit(RLIMIT_MSGQUEUE, &rlim) == 0) {
+            if(rlim.rlim_cur != RLIM_INFINITY) {
+                // each connection uses a pair of queues and the kernel
+                // accounts some bookkeeping overhead for each message
+                const auto per_message{size + span_size(sizeof(void*) * 8U)};
+                const auto max_depth{std::max(
+                  limit_cast<span_size_t>(rlim.rlim_cur) / (2 * per_message),
+                  span_size_t(1))};
+                if(depth > max_depth) {
+                    log_warning("limiting message queue depth to ${depth}")
+                      .arg("depth", max_depth)
+                      .arg("configured", depth)
+                      .arg("rlimit", "ByteSize", span_size(rlim.rlim_cur));
+                    depth = max_depth;
+                }
+            }
+        }
+        _shared_state->queue_depth = depth;
+        _shared_state->message_size = size;
+    }
 };
 #endif // EAGINE_POSIX
 //------------------------------------------------------------------------------
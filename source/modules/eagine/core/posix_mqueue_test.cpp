@@ -138,13 +138,90 @@ void posix_mqueue_roundtrip(auto& s) {
     }
 }
 //------------------------------------------------------------------------------
+// burst
+//------------------------------------------------------------------------------
+void posix_mqueue_burst(auto& s) {
+
+    if(auto fact{
+         eagine::msgbus::make_posix_mqueue_connection_factory(s.context())}) {
+        eagitest::case_ test{s, 4, "burst"};
+        eagitest::track trck{test, 0, 1};
+
+        auto& rg{test.random()};
+
+        test.ensure(bool(fact), "has factory");
+        auto cacc{fact->make_acceptor(eagine::identifier{"burst"})};
+        test.ensure(bool(cacc), "has acceptor");
+        auto read_conn{fact->make_connector(eagine::identifier{"burst"})};
+        test.ensure(bool(read_conn), "has read connection");
+
+        eagine::shared_holder<eagine::msgbus::connection> write_conn;
+
+        const eagine::timeout accept_time{std::chrono::seconds{5}};
+        while(not write_conn) {
+            read_conn->update();
+            cacc->update();
+            cacc->process_accepted(
+              {eagine::construct_from,
+               [&](eagine::shared_holder<eagine::msgbus::connection> conn) {
+                   write_conn = std::move(conn);
+               }});
+            if(accept_time.is_expired()) {
+                break;
+            }
+        }
+        test.ensure(bool(write_conn), "has write connection");
+
+        const eagine::message_id test_msg_id{"test", "burst"};
+        std::vector<eagine::byte> src;
+
+        eagine::msgbus::message_sequence_t sent{0};
+        eagine::msgbus::message_sequence_t received{0};
+
+        const auto read_func =
+          [&](
+            const eagine::message_id msg_id,
+            const eagine::msgbus::message_age,
+            const eagine::msgbus::message_view& msg) -> bool {
+            test.check(msg_id == test_msg_id, "message id");
+            test.check_equal(msg.sequence_no, received, "in order");
+            ++received;
+            trck.checkpoint(1);
+            return true;
+        };
+
+        // many more messages than the default queue depth before update
+        for(unsigned i = 0, n = test.repeats(500); i < n; ++i) {
+            src.resize(rg.get_std_size(0, 64));
+            rg.fill(src);
+
+            eagine::msgbus::message_view message{eagine::view(src)};
+            message.set_sequence_no(sent);
+            test.check(write_conn->send(test_msg_id, message), "sent");
+            ++sent;
+        }
+
+        const eagine::timeout receive_time{std::chrono::seconds{10}};
+        while(received < sent) {
+            write_conn->update();
+            read_conn->update();
+            read_conn->fetch_messages({eagine::construct_from, read_func});
+            if(receive_time.is_expired()) {
+                break;
+            }
+        }
+        test.check_equal(received, sent, "all received");
+    }
+}
+//------------------------------------------------------------------------------
 // main
 //------------------------------------------------------------------------------
 auto test_main(eagine::test_ctx& ctx) -> int {
-    eagitest::ctx_suite test{ctx, "POSIX connection", 3};
+    eagitest::ctx_suite test{ctx, "POSIX connection", 4};
     test.once(posix_mqueue_type_id);
     test.once(posix_mqueue_addr_kind);
     test.once(posix_mqueue_roundtrip);
+    test.once(posix_mqueue_burst);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------
@@ -0,0 +1,1161 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+module;
+
+#if defined(__linux__) && __has_include(<fcntl.h>) && \
+  __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && \
+  __has_include(<unistd.h>)
+#include <cassert>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EAGINE_POSIX_SHMEM 1
+#else
+#define EAGINE_POSIX_SHMEM 0
+#endif
+
+module eagine.msgbus.core;
+
+import std;
+import eagine.core.types;
+import eagine.core.memory;
+import eagine.core.identifier;
+import eagine.core.serialization;
+import eagine.core.valid_if;
+import eagine.core.utility;
+import eagine.core.main_ctx;
+import <cerrno>;
+
+namespace eagine::msgbus {
+//------------------------------------------------------------------------------
+#if EAGINE_POSIX_SHMEM
+//------------------------------------------------------------------------------
+// shared memory layout
+//------------------------------------------------------------------------------
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+struct posix_shmem_ring_header {
+    /// @brief Position of the next record read by the consumer.
+    alignas(64) std::atomic<std::uint64_t> head;
+    /// @brief Position after the last record written by the producer.
+    alignas(64) std::atomic<std::uint64_t> tail;
+    /// @brief Set by the consumer before it starts waiting for the doorbell.
+    alignas(64) std::atomic<std::uint32_t> reader_waiting;
+};
+
+struct posix_shmem_segment_header {
+    std::uint32_t magic;
+    std::uint32_t ring_size;
+    std::uint32_t block_size;
+    std::atomic<std::uint32_t> client_closed;
+    std::atomic<std::uint32_t> server_closed;
+    /// @brief Process ids used to detect peers which exited without closing.
+    std::atomic<std::int32_t> client_pid;
+    std::atomic<std::int32_t> server_pid;
+    posix_shmem_ring_header client_to_server;
+    posix_shmem_ring_header server_to_client;
+};
+
+struct posix_shmem_accept_slot {
+    static constexpr const std::uint32_t free{0U};
+    static constexpr const std::uint32_t claimed{1U};
+    static constexpr const std::uint32_t requested{2U};
+
+    std::atomic<std::uint32_t> state;
+    std::array<char, 60> segment_name;
+};
+
+struct posix_shmem_accept_header {
+    std::uint32_t magic;
+    std::atomic<std::uint32_t> reader_waiting;
+    std::array<posix_shmem_accept_slot, 16> slots;
+};
+
+static constexpr const std::uint32_t posix_shmem_segment_magic{0x45'4D'42'32U};
+static constexpr const std::uint32_t posix_shmem_accept_magic{0x45'4D'42'41U};
+
+[[nodiscard]] static constexpr auto posix_shmem_header_size() noexcept
+  -> span_size_t {
+    return span_size((sizeof(posix_shmem_segment_header) + 63U) & ~63U);
+}
+//------------------------------------------------------------------------------
+/// @brief Class wrapping a named shared memory object mapped into memory.
+/// @ingroup msgbus
+class posix_shmem_mapping {
+public:
+    posix_shmem_mapping() noexcept = default;
+    posix_shmem_mapping(posix_shmem_mapping&&) = delete;
+    posix_shmem_mapping(const posix_shmem_mapping&) = delete;
+    auto operator=(posix_shmem_mapping&&) = delete;
+    auto operator=(const posix_shmem_mapping&) = delete;
+
+    ~posix_shmem_mapping() noexcept {
+        unmap();
+    }
+
+    explicit operator bool() const noexcept {
+        return _addr != nullptr;
+    }
+
+    /// @brief Creates new shared memory object with the specified name and size.
+    auto create(const std::string& name, const span_size_t size) noexcept
+      -> bool {
+        unmap();
+        errno = 0;
+        // NOLINTNEXTLINE(hicpp-vararg,hicpp-signed-bitwise)
+        const int fd{::shm_open(
+          name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR)};
+        if(fd < 0) {
+            _last_errno = errno;
+            return false;
+        }
+        if(::ftruncate(fd, ::off_t(size)) == 0) {
+            _map(fd, size);
+        }
+        _last_errno = errno;
+        ::close(fd);
+        return bool(*this);
+    }
+
+    /// @brief Opens an existing shared memory object with the specified name.
+    auto open(const std::string& name) noexcept -> bool {
+        unmap();
+        errno = 0;
+        // NOLINTNEXTLINE(hicpp-vararg)
+        const int fd{::shm_open(name.c_str(), O_RDWR, 0)};
+        if(fd < 0) {
+            _last_errno = errno;
+            return false;
+        }
+        struct ::stat st {};
+        if(::fstat(fd, &st) == 0) {
+            _map(fd, span_size(st.st_size));
+        }
+        _last_errno = errno;
+        ::close(fd);
+        return bool(*this);
+    }
+
+    /// @brief Removes the name of the shared memory object.
+    static void unlink(const std::string& name) noexcept {
+        if(not name.empty()) {
+            ::shm_unlink(name.c_str());
+        }
+    }
+
+    void unmap() noexcept {
+        if(_addr) {
+            ::munmap(_addr, std_size(_size));
+            _addr = nullptr;
+            _size = 0;
+        }
+    }
+
+    auto block() const noexcept -> memory::block {
+        return {static_cast<byte*>(_addr), _size};
+    }
+
+    template <typename T>
+    auto as() const noexcept -> T& {
+        assert(_addr and (span_size(sizeof(T)) <= _size));
+        return *static_cast<T*>(_addr);
+    }
+
+    auto last_errno() const noexcept -> int {
+        return _last_errno;
+    }
+
+private:
+    void _map(const int fd, const span_size_t size) noexcept {
+        void* addr{::mmap(
+          nullptr,
+          std_size(size),
+          // NOLINTNEXTLINE(hicpp-signed-bitwise)
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED,
+          fd,
+          0)};
+        if(addr != MAP_FAILED) [[likely]] {
+            _addr = addr;
+            _size = size;
+        }
+    }
+
+    void* _addr{nullptr};
+    span_size_t _size{0};
+    int _last_errno{0};
+};
+//------------------------------------------------------------------------------
+// the segment can be created by any local process, so the layout described
+// by its header must be checked against the mapped size before attaching
+[[nodiscard]] static auto posix_shmem_is_valid_segment(
+  const posix_shmem_mapping& segment) noexcept -> bool {
+    const auto size{std::uint64_t(segment.block().size())};
+    if(size < std::uint64_t(posix_shmem_header_size())) {
+        return false;
+    }
+    const auto& header{segment.as<posix_shmem_segment_header>()};
+    const auto ring_size{std::uint64_t(header.ring_size)};
+    const auto block_size{std::uint64_t(header.block_size)};
+    return (header.magic == posix_shmem_segment_magic) and (ring_size > 0U) and
+           (ring_size % 8U == 0U) and
+           (std::uint64_t(posix_shmem_header_size()) + 2U * ring_size <=
+            size) and
+           (block_size >= std::uint64_t(min_connection_data_size)) and
+           (block_size <= ring_size / 8U);
+}
+//------------------------------------------------------------------------------
+[[nodiscard]] static auto posix_shmem_is_process_alive(
+  const std::int32_t pid) noexcept -> bool {
+    if(pid <= 0) {
+        // the peer did not attach yet
+        return true;
+    }
+    return (::kill(::pid_t(pid), 0) == 0) or (errno != ESRCH);
+}
+//------------------------------------------------------------------------------
+/// @brief Named pipe used to wake up a waiting reader in another process.
+/// @ingroup msgbus
+/// @note Futexes cannot be waited for together with sockets and event fds
+///       cannot be shared with unrelated processes, but a named pipe can be
+///       polled by the connection_readiness like any other handle.
+class posix_shmem_doorbell {
+public:
+    posix_shmem_doorbell() noexcept = default;
+    posix_shmem_doorbell(posix_shmem_doorbell&&) = delete;
+    posix_shmem_doorbell(const posix_shmem_doorbell&) = delete;
+    auto operator=(posix_shmem_doorbell&&) = delete;
+    auto operator=(const posix_shmem_doorbell&) = delete;
+
+    ~posix_shmem_doorbell() noexcept {
+        close();
+    }
+
+    static auto path_of(const std::string& name, const char side) noexcept
+      -> std::string {
+        std::string result{"/tmp"};
+        result.append(name);
+        result.push_back(side);
+        result.append(".fifo");
+        return result;
+    }
+
+    auto create(const std::string& path) noexcept -> bool {
+        unlink(path);
+        // NOLINTNEXTLINE(hicpp-signed-bitwise)
+        if(::mkfifo(path.c_str(), S_IRUSR | S_IWUSR) == 0) {
+            return open(path);
+        }
+        return false;
+    }
+
+    auto open(const std::string& path) noexcept -> bool {
+        close();
+        // on Linux opening a FIFO for both reading and writing never blocks
+        // and the writes do not fail while the other side is not opened yet
+        // NOLINTNEXTLINE(hicpp-vararg,hicpp-signed-bitwise)
+        _fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK);
+        return _fd >= 0;
+    }
+
+    static void unlink(const std::string& path) noexcept {
+        ::unlink(path.c_str());
+    }
+
+    /// @brief Removes the doorbells left behind by processes that terminated.
+    /// @note A doorbell is stale if its shared memory segment does not exist.
+    static auto remove_stale() noexcept -> span_size_t {
+        const std::string_view suffix{".fifo"};
+        span_size_t removed{0};
+        std::error_code error;
+        std::filesystem::directory_iterator pos{"/tmp", error};
+        for(; not error and (pos != std::filesystem::directory_iterator{});
+            pos.increment(error)) {
+            const auto filename{pos->path().filename().string()};
+            std::error_code entry_error;
+            if(
+              (filename.size() <= suffix.size() + 1U) or
+              not filename.ends_with(suffix) or
+              not pos->is_fifo(entry_error)) {
+                continue;
+            }
+            // the name of the segment is followed by the side and the suffix
+            std::string name{"/"};
+            name.append(filename, 0U, filename.size() - suffix.size() - 1U);
+            if(not(name.starts_with("/emb-") or name.ends_with("-shm"))) {
+                continue;
+            }
+            // NOLINTNEXTLINE(hicpp-vararg)
+            const int fd{::shm_open(name.c_str(), O_RDONLY, 0)};
+            if(fd >= 0) {
+                ::close(fd);
+            } else if(errno == ENOENT) {
+                unlink(pos->path().string());
+                ++removed;
+            }
+        }
+        return removed;
+    }
+
+    void close() noexcept {
+        if(_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+    }
+
+    void ring() const noexcept {
+        if(_fd >= 0) [[likely]] {
+            const char ding{'!'};
+            // a full pipe means that the reader will wake up anyway
+            [[maybe_unused]] const auto unused{::write(_fd, &ding, 1U)};
+        }
+    }
+
+    void drain() const noexcept {
+        if(_fd >= 0) [[likely]] {
+            std::array<char, 64> buf{};
+            while(::read(_fd, buf.data(), buf.size()) > 0) {
+            }
+        }
+    }
+
+    auto handle() const noexcept -> std::optional<int> {
+        if(_fd >= 0) [[likely]] {
+            return {_fd};
+        }
+        return {};
+    }
+
+private:
+    int _fd{-1};
+};
+//------------------------------------------------------------------------------
+/// @brief Single-producer/single-consumer ring of size-prefixed records.
+/// @ingroup msgbus
+///
+/// The records are written and read in place in the shared memory.
+/// A record which does not fit into the remaining space at the end
+/// of the ring is preceded by a wrap marker and starts at the beginning.
+class posix_shmem_ring {
+public:
+    posix_shmem_ring() noexcept = default;
+
+    posix_shmem_ring(
+      posix_shmem_ring_header& header,
+      const memory::block data) noexcept
+      : _header{&header}
+      , _data{data} {
+        assert((_data.size() % _record_align) == 0);
+    }
+
+    explicit operator bool() const noexcept {
+        return _header != nullptr;
+    }
+
+    /// @brief Reserves a contiguous block for a record of at most size bytes.
+    auto reserve(const span_size_t size) noexcept -> memory::block {
+        assert(_header);
+        const auto capacity{std::uint64_t(_data.size())};
+        const auto tail{_header->tail.load(std::memory_order_relaxed)};
+        const auto head{_header->head.load(std::memory_order_acquire)};
+        const auto need{_record_size(size)};
+        const auto contiguous{capacity - (tail % capacity)};
+        _start = (contiguous < need) ? tail + contiguous : tail;
+        if(_start + need - head > capacity) {
+            return {};
+        }
+        return eagine::head(
+          skip(_data, span_size(_start % capacity) + _size_bytes), size);
+    }
+
+    /// @brief Publishes the record of the specified size written to the reserved block.
+    /// @returns Indicates if the consumer is waiting and should be woken up.
+    auto commit(const span_size_t size) noexcept -> bool {
+        assert(_header);
+        const auto capacity{std::uint64_t(_data.size())};
+        const auto tail{_header->tail.load(std::memory_order_relaxed)};
+        if(_start != tail) {
+            _store_size(tail % capacity, _wrap_marker);
+        }
+        _store_size(_start % capacity, std::uint32_t(size));
+        _header->tail.store(_start + _record_size(size));
+        return _header->reader_waiting.exchange(0U) != 0U;
+    }
+
+    auto empty() const noexcept -> bool {
+        assert(_header);
+        return _header->head.load(std::memory_order_relaxed) ==
+               _header->tail.load();
+    }
+
+    /// @brief Calls the function on the published records and releases them.
+    template <typename Function>
+    auto fetch(const Function& func) noexcept -> work_done {
+        assert(_header);
+        some_true something_done{};
+        const auto capacity{std::uint64_t(_data.size())};
+        auto pos{_header->head.load(std::memory_order_relaxed)};
+        const auto end{_header->tail.load(std::memory_order_acquire)};
+        while(pos != end) {
+            const auto offset{pos % capacity};
+            const auto size{_load_size(offset)};
+            if(
+              (size != _wrap_marker) and
+              (_record_size(span_size(size)) > capacity - offset))
+              [[unlikely]] {
+                // corrupted record, drop the rest of the published data
+                _header->head.store(end, std::memory_order_release);
+                break;
+            }
+            if(size == _wrap_marker) {
+                pos += capacity - offset;
+            } else {
+                func(eagine::head(
+                  skip(_data, span_size(offset) + _size_bytes),
+                  span_size(size)));
+                pos += _record_size(span_size(size));
+                something_done();
+            }
+            _header->head.store(pos, std::memory_order_release);
+        }
+        return something_done;
+    }
+
+    /// @brief Announces that the consumer is going to wait for the doorbell.
+    /// @returns Indicates if the ring is empty and the consumer can wait.
+    auto prepare_wait() noexcept -> bool {
+        assert(_header);
+        _header->reader_waiting.store(1U);
+        return empty();
+    }
+
+private:
+    static constexpr const std::uint32_t _wrap_marker{~std::uint32_t(0U)};
+    static constexpr const std::uint64_t _record_align{8U};
+    static constexpr const span_size_t _size_bytes{4};
+
+    static constexpr auto _record_size(const span_size_t size) noexcept
+      -> std::uint64_t {
+        return (std::uint64_t(size + _size_bytes) + _record_align - 1U) &
+               ~(_record_align - 1U);
+    }
+
+    void _store_size(const std::uint64_t offset, const std::uint32_t size) noexcept {
+        std::memcpy(_data.data() + offset, &size, sizeof(size));
+    }
+
+    auto _load_size(const std::uint64_t offset) const noexcept -> std::uint32_t {
+        std::uint32_t size{0U};
+        std::memcpy(&size, _data.data() + offset, sizeof(size));
+        return size;
+    }
+
+    posix_shmem_ring_header* _header{nullptr};
+    memory::block _data{};
+    std::uint64_t _start{0U};
+};
+//------------------------------------------------------------------------------
+// connection
+//------------------------------------------------------------------------------
+struct posix_shmem_shared_state {
+    auto make_segment_name() const noexcept -> std::string {
+        std::string result;
+        result.reserve(integer(identifier::max_size() + 5));
+        random_identifier().name().str(result);
+        result.insert(0U, "/emb-");
+        return result;
+    }
+};
+//------------------------------------------------------------------------------
+/// @brief Implementation of the connection_info interface for shared memory connection.
+/// @ingroup msgbus
+/// @see connection_info
+template <typename Base>
+class posix_shmem_connection_info : public Base {
+public:
+    using Base::Base;
+
+    auto kind() noexcept -> connection_kind final {
+        return connection_kind::local_interprocess;
+    }
+
+    auto addr_kind() noexcept -> connection_addr_kind final {
+        return connection_addr_kind::filepath;
+    }
+
+    auto type_id() noexcept -> identifier final {
+        return "PosixShMem";
+    }
+};
+//------------------------------------------------------------------------------
+[[nodiscard]] static auto posix_shmem_fix_name(const string_view name) noexcept
+  -> std::string {
+    std::string result{name ? to_string(name) : std::string{"eagine-msgbus"}};
+    if(result.front() != '/') {
+        result.insert(result.begin(), '/');
+    }
+    result.append("-shm");
+    return result;
+}
+//------------------------------------------------------------------------------
+/// @brief Implementation of connection on top of shared memory ring buffers.
+/// @ingroup msgbus
+/// @see posix_shmem_connector
+/// @see posix_shmem_acceptor
+class posix_shmem_connection
+  : public posix_shmem_connection_info<connection>
+  , public main_ctx_object {
+
+public:
+    /// @brief Alias for received message fetch handler callable.
+    using fetch_handler = connection::fetch_handler;
+
+    /// @brief Construction from parent main context object.
+    posix_shmem_connection(
+      main_ctx_parent parent,
+      shared_holder<posix_shmem_shared_state> shared_state) noexcept
+      : main_ctx_object{"ShMemConn", parent}
+      , _shared_state{std::move(shared_state)} {}
+
+    posix_shmem_connection(posix_shmem_connection&&) = delete;
+    posix_shmem_connection(const posix_shmem_connection&) = delete;
+    auto operator=(posix_shmem_connection&&) = delete;
+    auto operator=(const posix_shmem_connection&) = delete;
+
+    ~posix_shmem_connection() noexcept override {
+        _close();
+    }
+
+    /// @brief Opens the server side of a segment created by a connector.
+    auto open(const std::string& name) noexcept -> bool;
+
+    auto is_usable() noexcept -> bool final {
+        return _segment and not _peer_closed() and not _peer_lost;
+    }
+
+    auto max_data_size() noexcept -> valid_if_positive<span_size_t> final {
+        return {_block_size};
+    }
+
+    auto update() noexcept -> work_done override {
+        some_true something_done{};
+        _check_peer_alive();
+        something_done(_receive());
+        something_done(_flush());
+        return something_done;
+    }
+
+    auto send(const message_id msg_id, const message_view& message) noexcept
+      -> bool final;
+
+    auto fetch_messages(const fetch_handler handler) noexcept
+      -> work_done final {
+        const std::unique_lock lock{_mutex_incoming};
+        return _incoming.fetch_all(handler);
+    }
+
+    auto query_statistics(connection_statistics&) noexcept -> bool final {
+        return false;
+    }
+
+    auto routing_weight() noexcept -> float final {
+        return 0.8F;
+    }
+
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        {
+            const std::unique_lock lock_outgoing{_mutex_outgoing};
+            if(not _outgoing.empty()) {
+                return false;
+            }
+        }
+        if(_input and _input.prepare_wait()) {
+            if(const auto handle{_input_bell.handle()}) {
+                readiness->watch(*handle);
+                return true;
+            }
+        }
+        return false;
+    }
+
+protected:
+    void _attach(const bool is_server) noexcept;
+    void _close() noexcept;
+    auto _peer_closed() const noexcept -> bool;
+    void _check_peer_alive() noexcept;
+    auto _receive() noexcept -> work_done;
+    auto _flush() noexcept -> work_done;
+    auto _write(const memory::const_block data) noexcept -> bool;
+
+    auto _handle_send(
+      const message_timestamp,
+      const message_priority,
+      const memory::const_block data) noexcept -> bool;
+
+    std::mutex _mutex_incoming;
+    std::mutex _mutex_outgoing;
+    std::string _segment_name;
+    posix_shmem_mapping _segment;
+    posix_shmem_ring _input;
+    posix_shmem_ring _output;
+    posix_shmem_doorbell _input_bell;
+    posix_shmem_doorbell _output_bell;
+    memory::buffer _buffer;
+    message_storage _incoming;
+    serialized_message_storage _outgoing;
+    std::atomic<std::uint32_t>* _own_closed{nullptr};
+    std::atomic<std::uint32_t>* _other_closed{nullptr};
+    std::atomic<std::int32_t>* _other_pid{nullptr};
+    timeout _liveness_check{std::chrono::seconds{1}};
+    span_size_t _block_size{min_connection_data_size};
+    bool _output_full{false};
+    bool _peer_lost{false};
+    shared_holder<posix_shmem_shared_state> _shared_state;
+};
+//------------------------------------------------------------------------------
+void posix_shmem_connection::_attach(const bool is_server) noexcept {
+    auto& header{_segment.as<posix_shmem_segment_header>()};
+    const auto ring_size{span_size(header.ring_size)};
+    const auto rings{skip(_segment.block(), posix_shmem_header_size())};
+    const auto c2s{head(rings, ring_size)};
+    const auto s2c{head(skip(rings, ring_size), ring_size)};
+
+    _block_size = span_size(header.block_size);
+    _buffer.resize(_block_size);
+    if(is_server) {
+        _input = {header.client_to_server, c2s};
+        _output = {header.server_to_client, s2c};
+        _own_closed = &header.server_closed;
+        _other_closed = &header.client_closed;
+        _other_pid = &header.client_pid;
+        header.server_pid.store(std::int32_t(::getpid()));
+    } else {
+        _input = {header.server_to_client, s2c};
+        _output = {header.client_to_server, c2s};
+        _own_closed = &header.client_closed;
+        _other_closed = &header.server_closed;
+        _other_pid = &header.server_pid;
+        header.client_pid.store(std::int32_t(::getpid()));
+    }
+    _peer_lost = false;
+    _liveness_check.reset();
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connection::open(const std::string& name) noexcept -> bool {
+    _segment_name = name;
+    if(not _segment.open(_segment_name)) {
+        log_error("failed to open shared memory segment ${name}")
+          .arg("name", _segment_name)
+          .arg("errno", _segment.last_errno());
+        return false;
+    }
+    if(not posix_shmem_is_valid_segment(_segment)) [[unlikely]] {
+        log_error("invalid shared memory segment ${name}")
+          .arg("name", _segment_name)
+          .arg("size", "ByteSize", _segment.block().size());
+        _segment.unmap();
+        return false;
+    }
+    const auto s2c_path{posix_shmem_doorbell::path_of(_segment_name, 's')};
+    const auto c2s_path{posix_shmem_doorbell::path_of(_segment_name, 'c')};
+    if(not _input_bell.open(c2s_path) or not _output_bell.open(s2c_path)) {
+        log_error("failed to open shared memory doorbells of ${name}")
+          .arg("name", _segment_name);
+        _segment.unmap();
+        return false;
+    }
+    _attach(true);
+    // both sides are attached, the names are not needed anymore
+    posix_shmem_mapping::unlink(_segment_name);
+    posix_shmem_doorbell::unlink(s2c_path);
+    posix_shmem_doorbell::unlink(c2s_path);
+    return true;
+}
+//------------------------------------------------------------------------------
+void posix_shmem_connection::_close() noexcept {
+    if(_own_closed) {
+        _own_closed->store(1U);
+        _output_bell.ring();
+        _own_closed = nullptr;
+        _other_closed = nullptr;
+        _other_pid = nullptr;
+    }
+    _input = {};
+    _output = {};
+    _input_bell.close();
+    _output_bell.close();
+    _segment.unmap();
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connection::_peer_closed() const noexcept -> bool {
+    return _other_closed and (_other_closed->load() != 0U);
+}
+//------------------------------------------------------------------------------
+void posix_shmem_connection::_check_peer_alive() noexcept {
+    // a crashed peer never sets its closed flag
+    if(_other_pid and not _peer_lost and _liveness_check) {
+        _liveness_check.reset();
+        if(not posix_shmem_is_process_alive(_other_pid->load())) {
+            log_warning("shared memory connection peer process exited")
+              .arg("name", _segment_name)
+              .arg("pid", _other_pid->load());
+            _peer_lost = true;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connection::_write(const memory::const_block data) noexcept
+  -> bool {
+    if(auto dest{_output.reserve(data.size())}) [[likely]] {
+        copy(data, dest);
+        if(_output.commit(data.size())) {
+            _output_bell.ring();
+        }
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connection::send(
+  const message_id msg_id,
+  const message_view& message) noexcept -> bool {
+    if(is_usable()) [[likely]] {
+        const std::unique_lock lock_outgoing{_mutex_outgoing};
+        if(_outgoing.empty()) [[likely]] {
+            // serialize directly into the ring if there is enough space
+            if(auto dest{_output.reserve(_block_size)}) [[likely]] {
+                block_data_sink sink(dest);
+                default_serializer_backend backend(sink);
+                if(serialize_message(msg_id, message, backend)) [[likely]] {
+                    if(_output.commit(sink.done().size())) {
+                        _output_bell.ring();
+                    }
+                    return true;
+                }
+                log_error("failed to serialize message");
+                return false;
+            }
+        }
+        block_data_sink sink(cover(_buffer));
+        default_serializer_backend backend(sink);
+        if(serialize_message(msg_id, message, backend)) [[likely]] {
+            _outgoing.push(sink.done(), message.priority);
+            return true;
+        }
+        log_error("failed to serialize message");
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connection::_handle_send(
+  const message_timestamp,
+  const message_priority,
+  const memory::const_block data) noexcept -> bool {
+    // keep the order of messages once the ring is full
+    if(not _output_full) [[likely]] {
+        _output_full = not _write(data);
+    }
+    return not _output_full;
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connection::_flush() noexcept -> work_done {
+    if(_output) [[likely]] {
+        const std::unique_lock lock_outgoing{_mutex_outgoing};
+        if(not _outgoing.empty()) {
+            _output_full = false;
+            return _outgoing.fetch_all(
+              make_callable_ref<&posix_shmem_connection::_handle_send>(this));
+        }
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connection::_receive() noexcept -> work_done {
+    if(_input) [[likely]] {
+        _input_bell.drain();
+        const std::unique_lock lock_incoming{_mutex_incoming};
+        return _input.fetch([this](const memory::const_block data) {
+            _incoming.push_if([data](
+                                message_id& msg_id,
+                                message_timestamp&,
+                                stored_message& message) {
+                block_data_source source(data);
+                default_deserializer_backend backend(source);
+                return bool(deserialize_message(msg_id, message, backend));
+            });
+        });
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+// connector
+//------------------------------------------------------------------------------
+/// @brief Implementation of the client side of shared memory connection.
+/// @ingroup msgbus
+/// @see posix_shmem_acceptor
+class posix_shmem_connector final : public posix_shmem_connection {
+    using base = posix_shmem_connection;
+
+public:
+    posix_shmem_connector(
+      main_ctx_parent parent,
+      const string_view address,
+      const span_size_t ring_size,
+      const span_size_t block_size,
+      shared_holder<posix_shmem_shared_state> shared_state) noexcept
+      : base{parent, std::move(shared_state)}
+      , _accept_name{posix_shmem_fix_name(address)}
+      , _ring_size{ring_size}
+      , _requested_block_size{block_size} {}
+
+    ~posix_shmem_connector() noexcept final {
+        _unlink();
+    }
+
+    auto update() noexcept -> work_done final {
+        some_true something_done{};
+        something_done(_checkup());
+        something_done(base::update());
+        return something_done;
+    }
+
+private:
+    auto _checkup() noexcept -> work_done;
+    auto _create_segment() noexcept -> bool;
+    auto _request_accept() noexcept -> bool;
+    void _unlink() noexcept;
+
+    const std::string _accept_name;
+    const span_size_t _ring_size;
+    const span_size_t _requested_block_size;
+    timeout _reconnect_timeout{std::chrono::seconds{2}, nothing};
+};
+//------------------------------------------------------------------------------
+void posix_shmem_connector::_unlink() noexcept {
+    if(not _segment_name.empty()) {
+        // fails harmlessly if the acceptor already removed the names
+        posix_shmem_mapping::unlink(_segment_name);
+        posix_shmem_doorbell::unlink(
+          posix_shmem_doorbell::path_of(_segment_name, 's'));
+        posix_shmem_doorbell::unlink(
+          posix_shmem_doorbell::path_of(_segment_name, 'c'));
+    }
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connector::_create_segment() noexcept -> bool {
+    assert(_shared_state);
+    _segment_name = _shared_state->make_segment_name();
+    const auto size{posix_shmem_header_size() + 2 * _ring_size};
+    if(not _segment.create(_segment_name, size)) {
+        log_error("failed to create shared memory segment ${name}")
+          .arg("name", _segment_name)
+          .arg("size", "ByteSize", size)
+          .arg("errno", _segment.last_errno());
+        return false;
+    }
+    auto& header{*new(&_segment.as<posix_shmem_segment_header>())
+                   posix_shmem_segment_header{}};
+    header.ring_size = limit_cast<std::uint32_t>(_ring_size);
+    header.block_size = limit_cast<std::uint32_t>(_requested_block_size);
+    header.magic = posix_shmem_segment_magic;
+
+    if(
+      not _input_bell.create(posix_shmem_doorbell::path_of(_segment_name, 's')) or
+      not _output_bell.create(
+        posix_shmem_doorbell::path_of(_segment_name, 'c'))) {
+        log_error("failed to create shared memory doorbells of ${name}")
+          .arg("name", _segment_name);
+        return false;
+    }
+    _attach(false);
+    return true;
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connector::_request_accept() noexcept -> bool {
+    posix_shmem_mapping accept_segment;
+    if(not accept_segment.open(_accept_name)) {
+        log_debug("shared memory acceptor ${name} is not available")
+          .arg("name", _accept_name);
+        return false;
+    }
+    auto& header{accept_segment.as<posix_shmem_accept_header>()};
+    if(header.magic != posix_shmem_accept_magic) [[unlikely]] {
+        log_error("invalid shared memory acceptor ${name}")
+          .arg("name", _accept_name);
+        return false;
+    }
+    for(auto& slot : header.slots) {
+        auto state{posix_shmem_accept_slot::free};
+        if(slot.state.compare_exchange_strong(
+             state, posix_shmem_accept_slot::claimed)) {
+            assert(_segment_name.size() < slot.segment_name.size());
+            std::fill(slot.segment_name.begin(), slot.segment_name.end(), '\0');
+            std::copy(
+              _segment_name.begin(),
+              _segment_name.end(),
+              slot.segment_name.begin());
+            slot.state.store(posix_shmem_accept_slot::requested);
+            if(header.reader_waiting.exchange(0U) != 0U) {
+                posix_shmem_doorbell bell;
+                if(bell.open(posix_shmem_doorbell::path_of(_accept_name, 'a'))) {
+                    bell.ring();
+                }
+            }
+            log_debug("requested shared memory connection ${segment}")
+              .arg("segment", _segment_name)
+              .arg("acceptor", _accept_name);
+            return true;
+        }
+    }
+    log_warning("shared memory acceptor ${name} is busy")
+      .arg("name", _accept_name);
+    return false;
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_connector::_checkup() noexcept -> work_done {
+    some_true something_done{};
+    if(not is_usable()) [[unlikely]] {
+        if(_reconnect_timeout) {
+            _close();
+            _unlink();
+            if(_create_segment() and _request_accept()) {
+                something_done();
+            } else {
+                _close();
+                _unlink();
+            }
+            _reconnect_timeout.reset();
+        }
+    }
+    return something_done;
+}
+//------------------------------------------------------------------------------
+// acceptor
+//------------------------------------------------------------------------------
+/// @brief Implementation of acceptor of shared memory connections.
+/// @ingroup msgbus
+/// @see posix_shmem_connector
+class posix_shmem_acceptor final
+  : public posix_shmem_connection_info<acceptor>
+  , public main_ctx_object {
+
+public:
+    /// @brief Alias for accepted connection handler callable.
+    using accept_handler = acceptor::accept_handler;
+
+    posix_shmem_acceptor(
+      main_ctx_parent parent,
+      const string_view address,
+      shared_holder<posix_shmem_shared_state> shared_state) noexcept
+      : main_ctx_object{"ShMemConAc", parent}
+      , _accept_name{posix_shmem_fix_name(address)}
+      , _shared_state{std::move(shared_state)} {}
+
+    posix_shmem_acceptor(posix_shmem_acceptor&&) = delete;
+    posix_shmem_acceptor(const posix_shmem_acceptor&) = delete;
+    auto operator=(posix_shmem_acceptor&&) = delete;
+    auto operator=(const posix_shmem_acceptor&) = delete;
+
+    ~posix_shmem_acceptor() noexcept final {
+        posix_shmem_mapping::unlink(_accept_name);
+        posix_shmem_doorbell::unlink(_bell_path());
+    }
+
+    auto update() noexcept -> work_done final {
+        some_true something_done{};
+        something_done(_checkup());
+        something_done(_receive());
+        return something_done;
+    }
+
+    auto process_accepted(const accept_handler handler) noexcept
+      -> work_done final;
+
+    auto prepare_wait(
+      const shared_holder<connection_readiness>& readiness) noexcept
+      -> bool final {
+        if(_accept_segment and _requests.empty()) {
+            auto& header{_accept_segment.as<posix_shmem_accept_header>()};
+            header.reader_waiting.store(1U);
+            if(_has_requests(header)) {
+                return false;
+            }
+            if(const auto handle{_bell.handle()}) {
+                readiness->watch(*handle);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    auto _bell_path() const noexcept -> std::string {
+        return posix_shmem_doorbell::path_of(_accept_name, 'a');
+    }
+
+    static auto _has_requests(const posix_shmem_accept_header& header) noexcept
+      -> bool {
+        return std::any_of(
+          header.slots.begin(), header.slots.end(), [](const auto& slot) {
+              return slot.state.load() == posix_shmem_accept_slot::requested;
+          });
+    }
+
+    auto _checkup() noexcept -> work_done;
+    auto _receive() noexcept -> work_done;
+
+    const std::string _accept_name;
+    posix_shmem_mapping _accept_segment;
+    posix_shmem_doorbell _bell;
+    std::vector<std::string> _requests;
+    timeout _reconnect_timeout{std::chrono::seconds{2}, nothing};
+    shared_holder<posix_shmem_shared_state> _shared_state;
+};
+//------------------------------------------------------------------------------
+auto posix_shmem_acceptor::_checkup() noexcept -> work_done {
+    some_true something_done{};
+    if(not _accept_segment) [[unlikely]] {
+        if(_reconnect_timeout) {
+            posix_shmem_mapping::unlink(_accept_name);
+            if(_accept_segment.create(
+                 _accept_name, span_size(sizeof(posix_shmem_accept_header)))) {
+                auto& header{*new(&_accept_segment.as<posix_shmem_accept_header>())
+                               posix_shmem_accept_header{}};
+                header.magic = posix_shmem_accept_magic;
+                if(not _bell.create(_bell_path())) {
+                    log_warning("failed to create shared memory doorbell")
+                      .arg("path", "FsPath", _bell_path());
+                }
+                log_debug("accepting shared memory connections on ${name}")
+                  .arg("name", _accept_name);
+                something_done();
+            } else {
+                log_error("failed to create shared memory acceptor ${name}")
+                  .arg("name", _accept_name)
+                  .arg("errno", _accept_segment.last_errno());
+            }
+            _reconnect_timeout.reset();
+        }
+    }
+    return something_done;
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_acceptor::_receive() noexcept -> work_done {
+    some_true something_done{};
+    if(_accept_segment) [[likely]] {
+        _bell.drain();
+        auto& header{_accept_segment.as<posix_shmem_accept_header>()};
+        for(auto& slot : header.slots) {
+            if(slot.state.load() == posix_shmem_accept_slot::requested) {
+                // the name is written by another process, it does not
+                // have to be null-terminated
+                const std::string_view name{
+                  slot.segment_name.data(),
+                  ::strnlen(slot.segment_name.data(), slot.segment_name.size())};
+                if(not name.empty()) [[likely]] {
+                    _requests.emplace_back(name);
+                }
+                slot.state.store(posix_shmem_accept_slot::free);
+                something_done();
+            }
+        }
+    }
+    return something_done;
+}
+//------------------------------------------------------------------------------
+auto posix_shmem_acceptor::process_accepted(
+  const accept_handler handler) noexcept -> work_done {
+    some_true something_done{};
+    for(const auto& name : _requests) {
+        log_debug("accepting shared memory connection ${name}")
+          .arg("name", name);
+        if(unique_holder<posix_shmem_connection> conn{
+             default_selector, *this, _shared_state}) {
+            if(conn->open(name)) {
+                handler(std::move(conn));
+                something_done();
+            }
+        }
+    }
+    _requests.clear();
+    return something_done;
+}
+//------------------------------------------------------------------------------
+// factory
+//------------------------------------------------------------------------------
+/// @brief Implementation of connection_factory for shared memory connections.
+/// @ingroup msgbus
+/// @see posix_shmem_connector
+/// @see posix_shmem_acceptor
+class posix_shmem_connection_factory
+  : public posix_shmem_connection_info<connection_factory>
+  , public main_ctx_object {
+public:
+    posix_shmem_connection_factory(main_ctx_parent parent) noexcept
+      : main_ctx_object{"ShMemConFc", parent} {
+        if(const auto removed{posix_shmem_doorbell::remove_stale()}) {
+            log_debug("removed ${count} stale shared memory doorbells")
+              .arg("count", removed);
+        }
+    }
+
+    using connection_factory::make_acceptor;
+    using connection_factory::make_connector;
+
+    /// @brief Makes an connection acceptor listening at the specified address.
+    auto make_acceptor(const string_view address) noexcept
+      -> shared_holder<acceptor> final {
+        return {hold<posix_shmem_acceptor>, *this, address, _shared_state};
+    }
+
+    /// @brief Makes a connector connecting to the specified address.
+    auto make_connector(const string_view address) noexcept
+      -> shared_holder<connection> final {
+        return {
+          hold<posix_shmem_connector>,
+          *this,
+          address,
+          _ring_size(),
+          _block_size,
+          _shared_state};
+    }
+
+private:
+    auto _ring_size() const noexcept -> span_size_t {
+        // the ring must hold several of the largest messages
+        const auto ring_size{std::max(_ring_size_cfg, 8 * _block_size)};
+        return (ring_size + 63) & ~span_size_t(63);
+    }
+
+    const span_size_t _block_size{std::max(
+      cfg_init("msgbus.posix_shmem.block_size", span_size_t(4 * 1024)),
+      min_connection_data_size)};
+    const span_size_t _ring_size_cfg{
+      cfg_init("msgbus.posix_shmem.ring_size", span_size_t(256 * 1024))};
+    shared_holder<posix_shmem_shared_state> _shared_state{default_selector};
+};
+#endif // EAGINE_POSIX_SHMEM
+//------------------------------------------------------------------------------
+auto make_posix_shmem_connection_factory(
+  [[maybe_unused]] main_ctx_parent parent)
+  -> unique_holder<connection_factory> {
+#if EAGINE_POSIX_SHMEM
+    return {hold<posix_shmem_connection_factory>, parent};
+#else
+    return {};
+#endif
+}
+//------------------------------------------------------------------------------
+} // namespace eagine::msgbus
@@ -38,7 +38,7 @@ auto registered_entry::update_and_process_service() noexcept -> work_done {
 //------------------------------------------------------------------------------
 registry::registry(main_ctx_parent parent) noexcept
   : main_ctx_object{"MsgBusRgtr", parent}
-  , _acceptor{make_direct_acceptor(*this)}
+  , _acceptor{make_direct_lock_free_acceptor(*this)}
   , _router{*this} {
     _router.add_acceptor(_acceptor);
 
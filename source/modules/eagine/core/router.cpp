@@ -21,6 +21,7 @@ import :message;
 import :interface;
 import :blobs;
 import :context;
+import :routing_table;
 
 namespace eagine::msgbus {
 export class router;
@@ -53,6 +54,14 @@ private:
     timeout _is_outdated{adjusted_duration(std::chrono::seconds{60})};
 };
 //------------------------------------------------------------------------------
+using router_routing_table = basic_routing_table<router_endpoint_info>;
+//------------------------------------------------------------------------------
+struct router_route {
+    endpoint_id_t outgoing_id{};
+    bool was_flooded{false};
+    bool is_disconnected{false};
+};
+//------------------------------------------------------------------------------
 class router_pending {
 public:
     router_pending(router&, shared_holder<connection>) noexcept;
@@ -73,6 +82,8 @@ public:
     auto can_be_adopted() noexcept -> bool;
 
     auto update() noexcept -> work_done;
+    auto prepare_wait(const shared_holder<connection_readiness>&) const noexcept
+      -> bool;
 
     void send(const message_id msg_id, const message_view&) noexcept;
     auto release_connection() noexcept -> shared_holder<msgbus::connection>;
@@ -187,9 +198,14 @@ public:
     void cleanup_connection() noexcept;
     auto kind_of_connection() const noexcept -> connection_kind;
     auto query_statistics(connection_statistics&) const noexcept -> bool;
+    auto prepare_wait(const shared_holder<connection_readiness>&) const noexcept
+      -> bool;
 
-    auto send(const main_ctx_object&, const message_id, const message_view&)
-      const noexcept -> bool;
+    auto send(
+      const main_ctx_object&,
+      const message_id,
+      const message_view&,
+      const shared_serialized_message& = {}) const noexcept -> bool;
 
     auto route_messages(
       router&,
@@ -200,13 +216,15 @@ public:
     auto try_route(
       const main_ctx_object&,
       const message_id,
-      const message_view&) const noexcept -> bool;
+      const message_view&,
+      const shared_serialized_message&) const noexcept -> bool;
 
     auto process_blobs(const endpoint_id_t node_id, router_blobs& blobs) noexcept
       -> work_done;
 
 private:
     unique_holder<std::shared_mutex> _lock{default_selector};
+    unique_holder<std::mutex> _send_lock{default_selector};
     shared_holder<connection> _connection{};
     route_node_messages_work_unit _route_messages_work{};
     connection_update_work_unit _update_connection_work{};
@@ -239,12 +257,17 @@ public:
     auto query_statistics(connection_statistics&) const noexcept -> bool;
 
     auto kind_of_connection() const noexcept -> connection_kind;
+    auto prepare_wait(const shared_holder<connection_readiness>&) const noexcept
+      -> bool;
 
     auto update(main_ctx_object&, const endpoint_id_t id_base) noexcept
       -> work_done;
 
-    auto send(const main_ctx_object&, const message_id, const message_view&)
-      const noexcept -> bool;
+    auto send(
+      const main_ctx_object&,
+      const message_id,
+      const message_view&,
+      const shared_serialized_message& = {}) const noexcept -> bool;
 
     auto route_messages(
       router&,
@@ -252,6 +275,7 @@ public:
       -> work_done;
 
 private:
+    mutable std::mutex _send_lock;
     shared_holder<connection> _connection{};
     endpoint_id_t _confirmed_id{};
     timeout _confirm_id_timeout{
@@ -266,14 +290,14 @@ public:
     auto has_id(const endpoint_id_t id) noexcept -> bool;
     auto find(const endpoint_id_t id) noexcept
       -> optional_reference<adjacent_node>;
-    auto find_outgoing(const endpoint_id_t target_id) -> endpoint_id_t;
+    auto find_route(const endpoint_id_t target_id) const noexcept
+      -> router_route;
+    void mark_flooded(const endpoint_id_t target_id) noexcept;
     auto has_some() noexcept -> bool;
     void add_acceptor(shared_holder<acceptor> an_acceptor) noexcept;
     auto handle_pending(router&) noexcept -> work_done;
     auto handle_accept(router&) noexcept -> work_done;
     auto remove_timeouted(const main_ctx_object&) noexcept -> work_done;
-    auto is_disconnected(const endpoint_id_t endpoint_id) const noexcept
-      -> bool;
     void mark_disconnected(const endpoint_id_t endpoint_id) noexcept;
     auto remove_disconnected(const main_ctx_object&) noexcept -> work_done;
     auto update_endpoint_info(
@@ -284,19 +308,34 @@ public:
       -> std::tuple<tribool, tribool, process_instance_id_t>;
     auto subscriptions_of(const endpoint_id_t target_id) noexcept
       -> std::tuple<std::vector<message_id>, process_instance_id_t>;
+    void add_subscription(
+      const endpoint_id_t incoming_id,
+      const message_view& message,
+      const message_id sub_msg_id) noexcept;
+    void remove_subscription(
+      const endpoint_id_t incoming_id,
+      const message_view& message,
+      const message_id sub_msg_id) noexcept;
+    auto subscribers_of(const message_id) const noexcept
+      -> optional_reference<const flat_set<endpoint_id_t>>;
+    void subscriptions_changed() noexcept;
+    auto update_subscribers() noexcept -> work_done;
+    auto prepare_wait(const shared_holder<connection_readiness>&) noexcept
+      -> bool;
     void erase(const endpoint_id_t) noexcept;
     void cleanup() noexcept;
 
 private:
     void _adopt_pending(router&, router_pending&) noexcept;
     auto _do_handle_pending(router&) noexcept -> work_done;
+    void _forget_routes_through(const endpoint_id_t node_id) noexcept;
 
     small_vector<shared_holder<acceptor>, 2> _acceptors;
     std::vector<router_pending> _pending;
     flat_map<endpoint_id_t, adjacent_node> _nodes;
-    flat_map<endpoint_id_t, endpoint_id_t> _endpoint_idx;
-    flat_map<endpoint_id_t, router_endpoint_info> _endpoint_infos;
-    flat_map<endpoint_id_t, timeout> _recently_disconnected;
+    router_routing_table _routes;
+    flat_map<message_id, flat_set<endpoint_id_t>> _subscribers;
+    bool _subscribers_outdated{false};
 };
 //------------------------------------------------------------------------------
 class router_stats {
@@ -311,7 +350,8 @@ public:
     auto statistics() noexcept -> router_statistics;
 
     void message_dropped() noexcept;
-    void log_stats(const main_ctx_object&) noexcept;
+    void message_forwarded() noexcept;
+    void log_stats(const main_ctx_object&, const message_timestamp) noexcept;
 
 private:
     std::shared_mutex _lock;
@@ -326,6 +366,9 @@ private:
     basic_sliding_average<std::chrono::steady_clock::duration, std::int32_t, 8, 64>
       _message_age_avg{};
     std::int64_t _prev_forwarded_messages{0};
+    std::int64_t _logged_forwarded_messages{0};
+    std::atomic<std::int64_t> _forwarded_messages{0};
+    std::atomic<std::int64_t> _dropped_messages{0};
     router_statistics _stats{};
     message_flow_info _flow_info{};
 };
@@ -395,6 +438,7 @@ public:
 
     void handle_resend(const message_view& message) noexcept;
     void handle_prepare(const message_view& message) noexcept;
+    void handle_ack(const message_view& message) noexcept;
 
 private:
     auto _get_blob_target_io(
@@ -436,6 +480,13 @@ public:
         return update(2);
     }
 
+    /// @brief Waits until some connection has pending work or timeout.
+    /// @see connection_readiness
+    /// If all connections can signal incoming data the wait is limited
+    /// by the msgbus.router.max_idle_wait option instead of poll_timeout.
+    auto wait_for_work(const std::chrono::microseconds poll_timeout) noexcept
+      -> bool;
+
     void say_bye() noexcept;
     void cleanup() noexcept;
     void finish() noexcept;
@@ -467,9 +518,9 @@ private:
       const message_age,
       const message_view&) noexcept -> bool;
 
-    auto _update_endpoint_info(
+    void _update_endpoint_info(
       const endpoint_id_t incoming_id,
-      const message_view&) noexcept -> router_endpoint_info&;
+      const message_view&) noexcept;
 
     auto _send_flow_info(const message_flow_info&) noexcept -> work_done;
 
@@ -535,6 +586,8 @@ private:
       -> message_handling_result;
     auto _handle_blob_prepare(const message_view&) noexcept
       -> message_handling_result;
+    auto _handle_blob_ack(const message_view&) noexcept
+      -> message_handling_result;
 
     auto _handle_special_common(
       const message_id msg_id,
@@ -571,31 +624,37 @@ private:
     auto _forward_to(
       const adjacent_node& node_out,
       const message_id msg_id,
-      message_view& message) noexcept -> bool;
+      message_view& message,
+      const shared_serialized_message& serialized) noexcept -> bool;
     auto _route_targeted_message(
       const message_id msg_id,
       const endpoint_id_t incoming_id,
-      message_view& message) noexcept -> bool;
+      message_view& message,
+      const shared_serialized_message& serialized) noexcept -> bool;
     auto _route_broadcast_message(
       const message_id msg_id,
       const endpoint_id_t incoming_id,
-      message_view& message) noexcept -> bool;
+      message_view& message,
+      const shared_serialized_message& serialized) noexcept -> bool;
     auto _route_message(
       const message_id msg_id,
       const endpoint_id_t incoming_id,
-      message_view& message) noexcept -> bool;
+      message_view& message,
+      const memory::const_block serialized = {}) noexcept -> bool;
     auto _handle_parent_message(
       const endpoint_id_t incoming_id,
       const std::chrono::steady_clock::duration message_age_inc,
       const message_id msg_id,
       const message_age msg_age,
-      message_view message) noexcept -> bool;
+      message_view message,
+      const memory::const_block serialized) noexcept -> bool;
     auto _handle_node_message(
       const endpoint_id_t incoming_id,
       const std::chrono::steady_clock::duration message_age_inc,
       const message_id msg_id,
       const message_age msg_age,
       message_view message,
+      const memory::const_block serialized,
       adjacent_node&) noexcept -> bool;
 
     auto _handle_special_parent_message(
@@ -606,17 +665,22 @@ private:
     void _update_connections_by_workers(some_true_atomic&) noexcept;
     auto _update_connections_by_router() noexcept -> work_done;
 
-    spinlock _router_lock;
+    // protects the endpoint info and the subscriber index, sending through
+    // the individual node connections is guarded by per-node locks
+    std::shared_mutex _router_lock;
     router_context _context;
     router_ids _ids;
     router_stats _stats;
     parent_router _parent_router;
     router_nodes _nodes;
     router_blobs _blobs{*this};
+    shared_holder<connection_readiness> _readiness{default_selector};
 
     timeout _no_connection_timeout{adjusted_duration(std::chrono::seconds{30})};
+    std::chrono::microseconds _max_idle_wait{std::chrono::milliseconds{50}};
 
     bool _password_is_required{false};
+    bool _broadcast_to_subscribers{false};
     bool _use_worker_threads{false};
 };
 //------------------------------------------------------------------------------
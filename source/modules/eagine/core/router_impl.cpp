@@ -216,6 +216,11 @@ auto router_pending::update() noexcept -> work_done {
     return something_done();
 }
 //------------------------------------------------------------------------------
+auto router_pending::prepare_wait(
+  const shared_holder<connection_readiness>& readiness) const noexcept -> bool {
+    return _connection and _connection->prepare_wait(readiness);
+}
+//------------------------------------------------------------------------------
 auto router_pending::release_connection() noexcept
   -> shared_holder<msgbus::connection> {
     return std::move(_connection);
@@ -364,6 +369,11 @@ auto adjacent_node::update_connection() noexcept -> work_done {
     return false;
 }
 //------------------------------------------------------------------------------
+auto adjacent_node::prepare_wait(
+  const shared_holder<connection_readiness>& readiness) const noexcept -> bool {
+    return _connection and _connection->prepare_wait(readiness);
+}
+//------------------------------------------------------------------------------
 void adjacent_node::handle_bye_bye() noexcept {
     const std::unique_lock lk_list{*_lock};
     if(not _maybe_router) {
@@ -401,9 +411,15 @@ auto adjacent_node::query_statistics(connection_statistics& stats) const noexcep
 auto adjacent_node::send(
   const main_ctx_object& user,
   const message_id msg_id,
-  const message_view& message) const noexcept -> bool {
+  const message_view& message,
+  const shared_serialized_message& serialized) const noexcept -> bool {
     if(_connection) [[likely]] {
-        if(not _connection->send(msg_id, message)) [[unlikely]] {
+        const std::unique_lock lk_send{*_send_lock};
+        const bool sent{
+          serialized
+            ? _connection->send_serialized(msg_id, message, serialized)
+            : _connection->send(msg_id, message)};
+        if(not sent) [[unlikely]] {
             user.log_debug("failed to send message to connected node");
             return false;
         }
@@ -421,14 +437,23 @@ auto adjacent_node::route_messages(
   -> work_done {
 
     if(_connection) [[likely]] {
+        // on worker threads the tick is captured once per node
+        const message_tick tick{};
         const auto handler{[&](
                              const message_id msg_id,
                              const message_age msg_age,
-                             message_view message) {
+                             message_view message,
+                             const memory::const_block serialized) {
             return parent._handle_node_message(
-              incoming_id, message_age_inc, msg_id, msg_age, message, *this);
+              incoming_id,
+              message_age_inc,
+              msg_id,
+              msg_age,
+              message,
+              serialized,
+              *this);
         }};
-        return _connection->fetch_messages({construct_from, handler});
+        return _connection->fetch_serialized({construct_from, handler});
     }
     return false;
 }
@@ -436,9 +461,14 @@ auto adjacent_node::route_messages(
 auto adjacent_node::try_route(
   const main_ctx_object& user,
   const message_id msg_id,
-  const message_view& message) const noexcept -> bool {
-    if(_maybe_router) {
-        return send(user, msg_id, message);
+  const message_view& message,
+  const shared_serialized_message& serialized) const noexcept -> bool {
+    const bool maybe_router{[this] {
+        const std::shared_lock lk_list{*_lock};
+        return _maybe_router;
+    }()};
+    if(maybe_router) {
+        return send(user, msg_id, message, serialized);
     }
     return false;
 }
@@ -452,6 +482,7 @@ auto adjacent_node::process_blobs(
             const auto handle_send{
               [node_id, this](message_id msg_id, const message_view& message) {
                   if(node_id == message.target_id) {
+                      const std::unique_lock lk_send{*_send_lock};
                       return _connection->send(msg_id, message);
                   }
                   return false;
@@ -526,6 +557,12 @@ inline void parent_router::announce_id(
       .arg("id", id_base);
 }
 //------------------------------------------------------------------------------
+auto parent_router::prepare_wait(
+  const shared_holder<connection_readiness>& readiness) const noexcept -> bool {
+    // without a parent connection there is nothing to wait for
+    return not _connection or _connection->prepare_wait(readiness);
+}
+//------------------------------------------------------------------------------
 auto parent_router::kind_of_connection() const noexcept -> connection_kind {
     if(_connection) {
         return _connection->kind();
@@ -572,9 +609,15 @@ inline auto parent_router::update(
 auto parent_router::send(
   const main_ctx_object& user,
   const message_id msg_id,
-  const message_view& message) const noexcept -> bool {
+  const message_view& message,
+  const shared_serialized_message& serialized) const noexcept -> bool {
     if(_connection) [[likely]] {
-        if(not _connection->send(msg_id, message)) [[unlikely]] {
+        const std::unique_lock lk_send{_send_lock};
+        const bool sent{
+          serialized
+            ? _connection->send_serialized(msg_id, message, serialized)
+            : _connection->send(msg_id, message)};
+        if(not sent) [[unlikely]] {
             user.log_debug("failed to send message to parent router");
             return false;
         }
@@ -591,11 +634,17 @@ auto parent_router::route_messages(
         const auto handler{[&, this](
                              const message_id msg_id,
                              const message_age msg_age,
-                             message_view message) {
+                             message_view message,
+                             const memory::const_block serialized) {
             return parent._handle_parent_message(
-              _confirmed_id, message_age_inc, msg_id, msg_age, message);
+              _confirmed_id,
+              message_age_inc,
+              msg_id,
+              msg_age,
+              message,
+              serialized);
         }};
-        return _connection->fetch_messages({construct_from, handler});
+        return _connection->fetch_serialized({construct_from, handler});
     }
     return false;
 }
@@ -619,9 +668,29 @@ auto router_nodes::find(const endpoint_id_t id) noexcept
     return eagine::find(_nodes, id).ref();
 }
 //------------------------------------------------------------------------------
-auto router_nodes::find_outgoing(const endpoint_id_t target_id)
-  -> endpoint_id_t {
-    return eagine::find(_endpoint_idx, target_id).or_default();
+auto router_nodes::find_route(const endpoint_id_t target_id) const noexcept
+  -> router_route {
+    if(const auto entry{_routes.find(target_id)}) [[likely]] {
+        if(entry->is_routed()) [[likely]] {
+            return {.outgoing_id = entry->outgoing_id};
+        }
+        if(entry->is_negative(message_timestamp_now())) {
+            return {
+              .was_flooded = entry->state == routing_entry_state::flooded,
+              .is_disconnected =
+                entry->state == routing_entry_state::disconnected};
+        }
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+void router_nodes::mark_flooded(const endpoint_id_t target_id) noexcept {
+    auto& entry = _routes[target_id];
+    if(not entry.is_routed()) {
+        entry.mark(
+          routing_entry_state::flooded,
+          message_timestamp_now() + std::chrono::seconds{1});
+    }
 }
 //------------------------------------------------------------------------------
 auto router_nodes::has_some() noexcept -> bool {
@@ -654,7 +723,8 @@ void router_nodes::_adopt_pending(
         parent._update_use_workers();
     }
     node->setup(pending.release_connection(), pending.maybe_router());
-    _recently_disconnected.erase(id);
+    _routes[id].route_through(id);
+    subscriptions_changed();
 }
 //------------------------------------------------------------------------------
 auto router_nodes::_do_handle_pending(router& parent) noexcept -> work_done {
@@ -723,36 +793,44 @@ auto router_nodes::remove_timeouted(const main_ctx_object& user) noexcept
         return false;
     });
 
-    _endpoint_infos.erase_if([this](auto& entry) {
-        auto& [endpoint_id, info] = entry;
-        if(info.is_outdated()) {
-            _endpoint_idx.erase(endpoint_id);
-            mark_disconnected(endpoint_id);
-            return true;
+    // the same clock as in find_route and mark_flooded
+    const auto now{message_timestamp_now()};
+    _routes.erase_if([&, this](const endpoint_id_t endpoint_id, auto& entry) {
+        if(entry.has_info and entry.info.is_outdated()) {
+            entry.has_info = false;
+            entry.info = {};
+            if(_nodes.contains(endpoint_id)) {
+                // directly connected nodes stay routed until they are
+                // removed as disconnected, only the stale info is dropped
+                entry.route_through(endpoint_id);
+            } else {
+                entry.mark(
+                  routing_entry_state::disconnected,
+                  now + std::chrono::seconds{15});
+            }
+            subscriptions_changed();
+            return false;
         }
-        return false;
+        return not entry.has_info and entry.is_expired(now);
     });
 
     return something_done;
 }
 //------------------------------------------------------------------------------
-auto router_nodes::is_disconnected(
-  const endpoint_id_t endpoint_id) const noexcept -> bool {
-    return eagine::find(_recently_disconnected, endpoint_id)
-      .transform([](auto& node) { return not node.is_expired(); })
-      .or_false();
+void router_nodes::mark_disconnected(const endpoint_id_t endpoint_id) noexcept {
+    _routes[endpoint_id].mark(
+      routing_entry_state::disconnected,
+      message_timestamp_now() + std::chrono::seconds{15});
 }
 //------------------------------------------------------------------------------
-void router_nodes::mark_disconnected(const endpoint_id_t endpoint_id) noexcept {
-    const auto node{eagine::find(_recently_disconnected, endpoint_id)};
-    if(node) {
-        if(node->is_expired()) {
-            _recently_disconnected.erase(node.position());
+void router_nodes::_forget_routes_through(const endpoint_id_t node_id) noexcept {
+    _routes.for_each([node_id](const endpoint_id_t, auto& entry) {
+        if(entry.is_routed() and (entry.outgoing_id == node_id)) {
+            // expired negative entry, the route has to be discovered again
+            entry.mark(routing_entry_state::flooded, {});
         }
-    }
-    _recently_disconnected.erase_if(
-      [&](auto& p) { return p.second.is_expired(); });
-    _recently_disconnected.emplace(endpoint_id, std::chrono::seconds{15});
+    });
+    subscriptions_changed();
 }
 //------------------------------------------------------------------------------
 auto router_nodes::remove_disconnected(const main_ctx_object& user) noexcept
@@ -768,6 +846,7 @@ auto router_nodes::remove_disconnected(const main_ctx_object& user) noexcept
     }
     something_done(_nodes.erase_if([this](auto& p) {
         if(p.second.should_disconnect()) [[unlikely]] {
+            _forget_routes_through(p.first);
             mark_disconnected(p.first);
             return true;
         }
@@ -780,10 +859,19 @@ auto router_nodes::remove_disconnected(const main_ctx_object& user) noexcept
 auto router_nodes::update_endpoint_info(
   const endpoint_id_t incoming_id,
   const message_view& message) noexcept -> router_endpoint_info& {
-    _endpoint_idx[message.source_id] = incoming_id;
-    auto& info = _endpoint_infos[message.source_id];
-    info.assign_instance_id(message);
-    return info;
+    auto& entry = _routes[message.source_id];
+    const bool route_changed{
+      not entry.is_routed() or (entry.outgoing_id != incoming_id) or
+      not entry.has_info};
+    const auto prev_instance_id{entry.info.instance_id()};
+    entry.route_through(incoming_id);
+    entry.has_info = true;
+    entry.info.assign_instance_id(message);
+    if(route_changed or (prev_instance_id != entry.info.instance_id()))
+      [[unlikely]] {
+        subscriptions_changed();
+    }
+    return entry.info;
 }
 //------------------------------------------------------------------------------
 auto router_nodes::subscribes_to(
@@ -791,12 +879,13 @@ auto router_nodes::subscribes_to(
   const message_id sub_msg_id) noexcept
   -> std::tuple<tribool, tribool, process_instance_id_t> {
 
-    if(const auto info{eagine::find(_endpoint_infos, target_id)}) {
-        if(info->has_instance_id()) {
+    if(const auto entry{_routes.find(target_id)}) {
+        auto& info = entry->info;
+        if(entry->has_info and info.has_instance_id()) {
             return {
-              info->is_subscribed_to(sub_msg_id),
-              info->is_not_subscribed_to(sub_msg_id),
-              info->instance_id()};
+              info.is_subscribed_to(sub_msg_id),
+              info.is_not_subscribed_to(sub_msg_id),
+              info.instance_id()};
         }
     }
     return {indeterminate, indeterminate, 0U};
@@ -804,15 +893,77 @@ auto router_nodes::subscribes_to(
 //------------------------------------------------------------------------------
 auto router_nodes::subscriptions_of(const endpoint_id_t target_id) noexcept
   -> std::tuple<std::vector<message_id>, process_instance_id_t> {
-    if(const auto info{eagine::find(_endpoint_infos, target_id)}) {
-        return {info->subscriptions(), info->instance_id()};
+    if(const auto entry{_routes.find(target_id)}) {
+        if(entry->has_info) {
+            return {entry->info.subscriptions(), entry->info.instance_id()};
+        }
     }
     return {{}, 0U};
 }
 //------------------------------------------------------------------------------
+void router_nodes::add_subscription(
+  const endpoint_id_t incoming_id,
+  const message_view& message,
+  const message_id sub_msg_id) noexcept {
+    update_endpoint_info(incoming_id, message).add_subscription(sub_msg_id);
+    _subscribers[sub_msg_id].insert(incoming_id);
+}
+//------------------------------------------------------------------------------
+void router_nodes::remove_subscription(
+  const endpoint_id_t incoming_id,
+  const message_view& message,
+  const message_id sub_msg_id) noexcept {
+    update_endpoint_info(incoming_id, message).remove_subscription(sub_msg_id);
+    // the subscriber index is rebuilt during the next maintenance cycle
+    subscriptions_changed();
+}
+//------------------------------------------------------------------------------
+auto router_nodes::update_subscribers() noexcept -> work_done {
+    if(not _subscribers_outdated) [[likely]] {
+        return false;
+    }
+    for(auto& entry : _subscribers) {
+        std::get<1>(entry).clear();
+    }
+    _routes.for_each([this](const endpoint_id_t, auto& entry) {
+        if(entry.has_info and entry.is_routed()) {
+            for(const auto sub_msg_id : entry.info.subscriptions()) {
+                _subscribers[sub_msg_id].insert(entry.outgoing_id);
+            }
+        }
+    });
+    _subscribers.erase_if([](auto& entry) { return entry.second.empty(); });
+    _subscribers_outdated = false;
+    return true;
+}
+//------------------------------------------------------------------------------
+auto router_nodes::subscribers_of(const message_id msg_id) const noexcept
+  -> optional_reference<const flat_set<endpoint_id_t>> {
+    return eagine::find(_subscribers, msg_id).ref();
+}
+//------------------------------------------------------------------------------
+void router_nodes::subscriptions_changed() noexcept {
+    _subscribers_outdated = true;
+}
+//------------------------------------------------------------------------------
 void router_nodes::erase(const endpoint_id_t id) noexcept {
-    _endpoint_idx.erase(id);
-    _endpoint_infos.erase(id);
+    _routes.erase(id);
+    subscriptions_changed();
+}
+//------------------------------------------------------------------------------
+auto router_nodes::prepare_wait(
+  const shared_holder<connection_readiness>& readiness) noexcept -> bool {
+    bool can_wait{true};
+    for(auto& an_acceptor : _acceptors) {
+        can_wait = an_acceptor->prepare_wait(readiness) and can_wait;
+    }
+    for(const auto& pending : _pending) {
+        can_wait = pending.prepare_wait(readiness) and can_wait;
+    }
+    for(const auto& [node_id, node] : _nodes) {
+        can_wait = node.prepare_wait(readiness) and can_wait;
+    }
+    return can_wait;
 }
 //------------------------------------------------------------------------------
 void router_nodes::cleanup() noexcept {
@@ -848,7 +999,10 @@ auto router_stats::avg_msg_age() noexcept -> std::chrono::microseconds {
 }
 //------------------------------------------------------------------------------
 auto router_stats::statistics() noexcept -> router_statistics {
-    return _stats;
+    auto result{_stats};
+    result.forwarded_messages = _forwarded_messages.load();
+    result.dropped_messages = _dropped_messages.load();
+    return result;
 }
 //------------------------------------------------------------------------------
 auto router_stats::update_stats() noexcept
@@ -857,6 +1011,8 @@ auto router_stats::update_stats() noexcept
     const auto now{std::chrono::steady_clock::now()};
     const std::chrono::duration<float> seconds{now - _forwarded_since_stat};
     _stats.uptime_seconds = uptime().count();
+    _stats.forwarded_messages = _forwarded_messages.load();
+    _stats.dropped_messages = _dropped_messages.load();
 
     if(seconds >= std::chrono::seconds{15}) [[unlikely]] {
         _forwarded_since_stat = now;
@@ -885,30 +1041,44 @@ auto router_stats::update_stats() noexcept
 }
 //------------------------------------------------------------------------------
 void router_stats::message_dropped() noexcept {
-    ++_stats.dropped_messages;
+    ++_dropped_messages;
 }
 //------------------------------------------------------------------------------
 constexpr auto router_log_stat_msg_count() noexcept {
     return debug_build ? 100'000 : 1'000'000;
 }
 //------------------------------------------------------------------------------
-void router_stats::log_stats(const main_ctx_object& user) noexcept {
-    if(++_stats.forwarded_messages % router_log_stat_msg_count() == 0) {
-        const auto now{std::chrono::steady_clock::now()};
-        const std::chrono::duration<float> interval{now - _forwarded_since_log};
-        _forwarded_since_log = now;
+void router_stats::message_forwarded() noexcept {
+    _forwarded_messages.fetch_add(1, std::memory_order_relaxed);
+}
+//------------------------------------------------------------------------------
+void router_stats::log_stats(
+  const main_ctx_object& user,
+  const message_timestamp now) noexcept {
+    const auto forwarded{_forwarded_messages.load(std::memory_order_relaxed)};
+    const auto logged{_logged_forwarded_messages};
+    if(
+      forwarded / router_log_stat_msg_count() !=
+      logged / router_log_stat_msg_count()) [[unlikely]] {
+        _logged_forwarded_messages = forwarded;
+        const auto avg_age{avg_msg_age()};
+        const std::chrono::duration<float> interval{[&, this] {
+            const std::unique_lock lk{_lock};
+            const auto result{now - _forwarded_since_log};
+            _forwarded_since_log = now;
+            return result;
+        }()};
 
         if(interval > interval.zero()) [[likely]] {
-            const auto msgs_per_sec{
-              float(router_log_stat_msg_count()) / interval.count()};
+            const auto msgs_per_sec{float(forwarded - logged) / interval.count()};
 
             user.log_chart_sample("msgsPerSec", msgs_per_sec);
             user.log_stat("forwarded ${count} messages (${msgsPerSec})")
               .tag("msgStats")
-              .arg("count", _stats.forwarded_messages)
-              .arg("dropped", _stats.dropped_messages)
+              .arg("count", forwarded)
+              .arg("dropped", _dropped_messages.load())
               .arg("interval", interval)
-              .arg("avgMsgAge", avg_msg_age())
+              .arg("avgMsgAge", avg_age)
               .arg("msgsPerSec", "RatePerSec", msgs_per_sec);
         }
     }
@@ -1030,7 +1200,8 @@ router_blobs::router_blobs(router& parent) noexcept
       parent,
       msgbus_id{"blobFrgmnt"},
       msgbus_id{"blobResend"},
-      msgbus_id{"blobPrpare"}} {}
+      msgbus_id{"blobPrpare"},
+      msgbus_id{"blobFrgAck"}} {}
 //------------------------------------------------------------------------------
 auto router_blobs::has_outgoing() noexcept -> bool {
     return _blobs.has_outgoing();
@@ -1099,6 +1270,10 @@ void router_blobs::handle_prepare(const message_view& message) noexcept {
     _blobs.process_prepare(message);
 }
 //------------------------------------------------------------------------------
+void router_blobs::handle_ack(const message_view& message) noexcept {
+    _blobs.process_ack(message);
+}
+//------------------------------------------------------------------------------
 // router
 //------------------------------------------------------------------------------
 router::router(main_ctx_parent parent) noexcept
@@ -1106,10 +1281,22 @@ router::router(main_ctx_parent parent) noexcept
   , _context{make_context(*this)}
   , _password_is_required{app_config()
                             .get<bool>("msgbus.router.requires_password")
-                            .value_or(false)} {
+                            .value_or(false)}
+  , _max_idle_wait{app_config()
+                     .get<std::chrono::microseconds>(
+                       "msgbus.router.max_idle_wait")
+                     .value_or(std::chrono::milliseconds{50})}
+  , _broadcast_to_subscribers{
+      app_config()
+        .get<bool>("msgbus.router.broadcast_to_subscribers")
+        .value_or(false)} {
     declare_state("multiThred", "multiThrd", "singleThrd");
     _ids.setup_from_config(*this);
     _ids.set_description(*this);
+    if(_broadcast_to_subscribers) {
+        log_info("broadcasting only to nodes leading to subscribers")
+          .tag("brdcstSubs");
+    }
 }
 //------------------------------------------------------------------------------
 auto router::_uptime_seconds() noexcept -> std::int64_t {
@@ -1225,11 +1412,11 @@ auto router::_handle_blob(
     return true;
 }
 //------------------------------------------------------------------------------
-auto router::_update_endpoint_info(
+void router::_update_endpoint_info(
   const endpoint_id_t incoming_id,
-  const message_view& message) noexcept -> router_endpoint_info& {
+  const message_view& message) noexcept {
     const std::unique_lock lk{_router_lock};
-    return _nodes.update_endpoint_info(incoming_id, message);
+    _nodes.update_endpoint_info(incoming_id, message);
 }
 //------------------------------------------------------------------------------
 auto router::_send_flow_info(const message_flow_info& flow_info) noexcept
@@ -1275,9 +1462,8 @@ auto router::_handle_subscribed(
           .arg("source", message.source_id)
           .arg("message", sub_msg_id);
 
-        auto& info = _update_endpoint_info(incoming_id, message);
         const std::unique_lock lk{_router_lock};
-        info.add_subscription(sub_msg_id);
+        _nodes.add_subscription(incoming_id, message, sub_msg_id);
     }
     return should_be_forwarded;
 }
@@ -1310,7 +1496,6 @@ auto router::_handle_not_not_a_router(
     if(incoming_id == message.source_id) {
         log_debug("node ${source} is not a router")
           .arg("source", message.source_id);
-        const std::unique_lock lk{_router_lock};
         node.mark_not_a_router();
     }
     return was_handled;
@@ -1326,9 +1511,8 @@ auto router::_handle_not_subscribed(
           .arg("source", message.source_id)
           .arg("message", sub_msg_id);
 
-        auto& info = _update_endpoint_info(incoming_id, message);
         const std::unique_lock lk{_router_lock};
-        info.remove_subscription(sub_msg_id);
+        _nodes.remove_subscription(incoming_id, message, sub_msg_id);
     }
     return should_be_forwarded;
 }
@@ -1374,7 +1558,7 @@ auto router::_handle_subscribers_query(const message_view& message) noexcept
     message_id sub_msg_id{};
     if(default_deserialize_message_type(sub_msg_id, message.content())) {
         const auto [is_sub, is_not_sub, inst_id] = [&, this] {
-            const std::unique_lock lk{_router_lock};
+            const std::shared_lock lk{_router_lock};
             return _nodes.subscribes_to(message.target_id, sub_msg_id);
         }();
         if(is_sub or is_not_sub) {
@@ -1397,7 +1581,7 @@ auto router::_handle_subscribers_query(const message_view& message) noexcept
 auto router::_handle_subscriptions_query(const message_view& message) noexcept
   -> message_handling_result {
     const auto [subs, inst_id] = [&, this] {
-        const std::unique_lock lk{_router_lock};
+        const std::shared_lock lk{_router_lock};
         return _nodes.subscriptions_of(message.target_id);
     }();
     for(const auto& sub_msg_id : subs) {
@@ -1586,6 +1770,16 @@ auto router::_handle_blob_prepare(const message_view& message) noexcept
     return should_be_forwarded;
 }
 //------------------------------------------------------------------------------
+auto router::_handle_blob_ack(const message_view& message) noexcept
+  -> message_handling_result {
+    if(has_id(message.target_id)) {
+        const std::unique_lock lk{_router_lock};
+        _blobs.handle_ack(message);
+        return was_handled;
+    }
+    return should_be_forwarded;
+}
+//------------------------------------------------------------------------------
 auto router::_handle_special_common(
   const message_id msg_id,
   const endpoint_id_t incoming_id,
@@ -1609,6 +1803,8 @@ auto router::_handle_special_common(
             return _handle_blob_resend(message);
         case id_v("blobPrpare"):
             return _handle_blob_prepare(message);
+        case id_v("blobFrgAck"):
+            return _handle_blob_ack(message);
         case id_v("rtrCertQry"):
             return _handle_router_certificate_query(message);
         case id_v("eptCertQry"):
@@ -1620,6 +1816,7 @@ auto router::_handle_special_common(
         case id_v("reqRutrPwd"):
             return _handle_password_request(message);
         case id_v("pong"):
+        case id_v("eptSessAck"):
         case id_v("topoRutrCn"):
         case id_v("topoBrdgCn"):
         case id_v("topoEndpt"):
@@ -1730,55 +1927,65 @@ void router::_update_use_workers() noexcept {
 auto router::_forward_to(
   const adjacent_node& node_out,
   const message_id msg_id,
-  message_view& message) noexcept -> bool {
-    _stats.log_stats(*this);
-    return node_out.send(*this, msg_id, message);
+  message_view& message,
+  const shared_serialized_message& serialized) noexcept -> bool {
+    _stats.message_forwarded();
+    return node_out.send(*this, msg_id, message, serialized);
 }
 //------------------------------------------------------------------------------
 auto router::_route_targeted_message(
   const message_id msg_id,
   const endpoint_id_t incoming_id,
-  message_view& message) noexcept -> bool {
+  message_view& message,
+  const shared_serialized_message& serialized) noexcept -> bool {
     bool has_routed = false;
 
     const auto own_id{get_id()};
-    if(const auto outgoing_id{_nodes.find_outgoing(message.target_id)}) {
+    // directly connected nodes are also in the routing table
+    const auto route{[&, this] {
+        const std::shared_lock lk{_router_lock};
+        return _nodes.find_route(message.target_id);
+    }()};
+    if(route.outgoing_id) {
         // if the message should go through the parent router
-        if(outgoing_id == own_id) {
-            const std::unique_lock lk{_router_lock};
-            has_routed |= _parent_router.send(*this, msg_id, message);
+        if(route.outgoing_id == own_id) {
+            has_routed |=
+              _parent_router.send(*this, msg_id, message, serialized);
         } else {
-            _nodes.find(outgoing_id).and_then([&](auto& node_out) {
+            _nodes.find(route.outgoing_id).and_then([&](auto& node_out) {
                 if(node_out.is_allowed(msg_id)) {
-                    const std::unique_lock lk{_router_lock};
-                    has_routed = _forward_to(node_out, msg_id, message);
+                    has_routed =
+                      _forward_to(node_out, msg_id, message, serialized);
                 }
             });
         }
     }
 
     if(not has_routed) {
-        for(const auto& [outgoing_id, node_out] : _nodes.get()) {
-            if(outgoing_id == message.target_id) {
-                if(node_out.is_allowed(msg_id)) {
-                    const std::unique_lock lk{_router_lock};
-                    has_routed = _forward_to(node_out, msg_id, message);
+        if(not route.is_disconnected) [[likely]] {
+            // unknown targets are flooded to the child routers only once
+            // in a while, otherwise they go just through the parent router
+            if(not route.was_flooded) {
+                bool has_flooded{false};
+                for(const auto& [outgoing_id, node_out] : _nodes.get()) {
+                    if(incoming_id != outgoing_id) {
+                        has_flooded |= node_out.try_route(
+                          *this, msg_id, message, serialized);
+                    }
                 }
-            }
-        }
-    }
-
-    if(not has_routed) {
-        if(not _nodes.is_disconnected(message.target_id)) [[likely]] {
-            const std::unique_lock lk{_router_lock};
-            for(const auto& [outgoing_id, node_out] : _nodes.get()) {
-                if(incoming_id != outgoing_id) {
-                    has_routed |= node_out.try_route(*this, msg_id, message);
+                // the flood is recorded even if some node accepted the
+                // message, connections to child routers accept everything.
+                // Routed entries are not affected by this.
+                {
+                    const std::unique_lock lk{_router_lock};
+                    _nodes.mark_flooded(message.target_id);
                 }
+                has_routed |= has_flooded;
             }
             // if the message didn't come from the parent router
             if(incoming_id != own_id) {
-                has_routed |= _parent_router.send(*this, msg_id, message);
+                has_routed |=
+                  _parent_router.send(*this, msg_id, message, serialized);
             }
         }
     }
@@ -1788,18 +1995,43 @@ auto router::_route_targeted_message(
 auto router::_route_broadcast_message(
   const message_id msg_id,
   const endpoint_id_t incoming_id,
-  message_view& message) noexcept -> bool {
-
-    const std::unique_lock lk{_router_lock};
-    for(const auto& [outgoing_id, node_out] : _nodes.get()) {
-        if(incoming_id != outgoing_id) {
-            if(node_out.is_allowed(msg_id)) {
-                _forward_to(node_out, msg_id, message);
+  message_view& message,
+  const shared_serialized_message& serialized) noexcept -> bool {
+
+    // special messages are always forwarded, regular messages are optionally
+    // forwarded only to nodes that lead to at least one subscriber
+    if(_broadcast_to_subscribers and not is_special_message(msg_id)) {
+        // the subscriber set is copied so that the router lock is not held
+        // while the message is being sent
+        small_vector<endpoint_id_t, 16> outgoing_ids;
+        {
+            const std::shared_lock lk{_router_lock};
+            _nodes.subscribers_of(msg_id).and_then([&](const auto& ids) {
+                for(const auto outgoing_id : ids) {
+                    outgoing_ids.push_back(outgoing_id);
+                }
+            });
+        }
+        for(const auto outgoing_id : outgoing_ids) {
+            if(incoming_id != outgoing_id) {
+                _nodes.find(outgoing_id).and_then([&](auto& node_out) {
+                    if(node_out.is_allowed(msg_id)) {
+                        _forward_to(node_out, msg_id, message, serialized);
+                    }
+                });
+            }
+        }
+    } else {
+        for(const auto& [outgoing_id, node_out] : _nodes.get()) {
+            if(incoming_id != outgoing_id) {
+                if(node_out.is_allowed(msg_id)) {
+                    _forward_to(node_out, msg_id, message, serialized);
+                }
             }
         }
     }
     if(not has_id(incoming_id)) {
-        _parent_router.send(*this, msg_id, message);
+        _parent_router.send(*this, msg_id, message, serialized);
     }
     return true;
 }
@@ -1807,16 +2039,27 @@ auto router::_route_broadcast_message(
 auto router::_route_message(
   const message_id msg_id,
   const endpoint_id_t incoming_id,
-  message_view& message) noexcept -> bool {
+  message_view& message,
+  const memory::const_block serialized) noexcept -> bool {
 
     bool result = true;
     if(not message.too_many_hops()) [[likely]] {
         message.add_hop();
 
+        // messages received with the compact header are copied and patched
+        // once, when the first outgoing connection takes the serialized form,
+        // and the same bytes are shared by all outgoing connections
+        const auto forwarded{
+          serialized.empty()
+            ? shared_serialized_message{}
+            : shared_serialized_message::deferred(serialized, message)};
+
         if(message.target_id != broadcast_endpoint_id()) {
-            result |= _route_targeted_message(msg_id, incoming_id, message);
+            result |= _route_targeted_message(
+              msg_id, incoming_id, message, forwarded);
         } else {
-            result |= _route_broadcast_message(msg_id, incoming_id, message);
+            result |= _route_broadcast_message(
+              msg_id, incoming_id, message, forwarded);
         }
     } else {
         log_warning("message ${message} discarded after too many hops")
@@ -1832,7 +2075,8 @@ auto router::_handle_parent_message(
   const std::chrono::steady_clock::duration message_age_inc,
   const message_id msg_id,
   const message_age msg_age,
-  message_view message) noexcept -> bool {
+  message_view message,
+  const memory::const_block serialized) noexcept -> bool {
     _stats.update_avg_msg_age(message.add_age(msg_age).age() + message_age_inc);
 
     if(is_special_message(msg_id)) {
@@ -1842,7 +2086,7 @@ auto router::_handle_parent_message(
         _stats.message_dropped();
         return true;
     }
-    return _route_message(msg_id, incoming_id, message);
+    return _route_message(msg_id, incoming_id, message, serialized);
 }
 //------------------------------------------------------------------------------
 auto router::_handle_node_message(
@@ -1851,6 +2095,7 @@ auto router::_handle_node_message(
   const message_id msg_id,
   const message_age msg_age,
   message_view message,
+  const memory::const_block serialized,
   adjacent_node& node) noexcept -> bool {
     _stats.update_avg_msg_age(message.add_age(msg_age).age() + message_age_inc);
 
@@ -1861,7 +2106,7 @@ auto router::_handle_node_message(
         _stats.message_dropped();
         return true;
     }
-    return _route_message(msg_id, incoming_id, message);
+    return _route_message(msg_id, incoming_id, message, serialized);
 }
 //------------------------------------------------------------------------------
 auto router::_handle_special_parent_message(
@@ -1947,6 +2192,7 @@ auto router::do_maintenance() noexcept -> work_done {
     some_true something_done{};
 
     something_done(_update_stats());
+    something_done(_nodes.update_subscribers());
     something_done(_process_blobs());
     something_done(_nodes.handle_pending(*this));
     something_done(_nodes.handle_accept(*this));
@@ -1985,6 +2231,7 @@ auto router::do_work() noexcept -> work_done {
 auto router::update(const valid_if_positive<int>& count) noexcept -> work_done {
     static const auto exec_time_id{register_time_interval("busUpdate")};
     const auto exec_time{measure_time_interval(exec_time_id)};
+    const message_tick tick{};
     some_true something_done{};
 
     something_done(do_maintenance());
@@ -1999,10 +2246,20 @@ auto router::update(const valid_if_positive<int>& count) noexcept -> work_done {
             something_done(do_work_by_router());
         } while((n-- > 0) and something_done);
     }
+    _stats.log_stats(*this, tick.now());
 
     return something_done;
 }
 //------------------------------------------------------------------------------
+auto router::wait_for_work(const std::chrono::microseconds poll_timeout) noexcept
+  -> bool {
+    bool can_wait{not _blobs.has_outgoing()};
+    can_wait = _parent_router.prepare_wait(_readiness) and can_wait;
+    can_wait = _nodes.prepare_wait(_readiness) and can_wait;
+    return _readiness->wait_for(
+      can_wait ? std::max(_max_idle_wait, poll_timeout) : poll_timeout);
+}
+//------------------------------------------------------------------------------
 void router::say_bye() noexcept {
     const auto msgid{msgbus_id{"byeByeRutr"}};
     message_view msg{};
@@ -2017,7 +2274,7 @@ void router::say_bye() noexcept {
 //------------------------------------------------------------------------------
 void router::cleanup() noexcept {
     _nodes.cleanup();
-    _stats.log_stats(*this);
+    _stats.log_stats(*this, message_timestamp_now());
 }
 //------------------------------------------------------------------------------
 void router::finish() noexcept {
@@ -0,0 +1,104 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin_ctx.hpp>
+import std;
+import eagine.core;
+import eagine.msgbus.core;
+//------------------------------------------------------------------------------
+// flood to child router
+//------------------------------------------------------------------------------
+void router_flood_child_router(unsigned, auto& s) {
+    eagitest::case_ test{s, 1, "flood to child router"};
+    auto& ctx{s.context()};
+
+    eagine::msgbus::endpoint endpoint{"Endpoint", ctx};
+
+    auto acceptor = eagine::msgbus::make_direct_acceptor(ctx);
+    endpoint.add_connection(acceptor->make_connection());
+    // the child router is emulated by a connection announcing a non-endpoint
+    // id, a second router in this process would use the same id range
+    auto child_conn{acceptor->make_connection()};
+    test.ensure(bool(child_conn), "has child connection");
+
+    eagine::msgbus::router router(ctx);
+    router.add_acceptor(std::move(acceptor));
+
+    const eagine::endpoint_id_t child_id{eagine::random_identifier().value()};
+    const eagine::endpoint_id_t unknown_id{
+      eagine::random_identifier().value()};
+    const eagine::message_id test_msg_id{"eagiTest", "unknown"};
+
+    int received{0};
+    const auto read_func = [&](
+                             const eagine::message_id msg_id,
+                             const eagine::msgbus::message_age,
+                             const eagine::msgbus::message_view& msg) -> bool {
+        if(msg_id == test_msg_id) {
+            test.check(msg.target_id == unknown_id, "target id");
+            ++received;
+        }
+        return true;
+    };
+    const auto update_child = [&]() {
+        child_conn->update();
+        child_conn->fetch_messages({eagine::construct_from, read_func});
+    };
+
+    eagine::msgbus::message_view announce{};
+    announce.set_source_id(child_id);
+    child_conn->send(eagine::msgbus::msgbus_id{"announceId"}, announce);
+
+    eagine::timeout connect_time{std::chrono::seconds{5}};
+    while(not(endpoint.has_id() and router.has_node_id(child_id))) {
+        if(connect_time.is_expired()) {
+            test.fail("failed to connect");
+            return;
+        }
+        router.update();
+        endpoint.update();
+        update_child();
+    }
+
+    // the target is not known to the router, the first message is flooded
+    // to the child router and the following ones hit the negative entry,
+    // even though the child router connection accepted the first one
+    const int sent{100};
+    for(int i = 0; i < sent; ++i) {
+        eagine::msgbus::message_view message{};
+        message.set_target_id(unknown_id);
+        endpoint.post(test_msg_id, message);
+    }
+
+    eagine::timeout process_time{std::chrono::milliseconds{250}};
+    while(not process_time.is_expired()) {
+        router.update();
+        endpoint.update();
+        update_child();
+    }
+
+    test.check(received > 0, "flooded");
+    test.check(received < sent, "flood cached");
+}
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+auto test_main(eagine::test_ctx& ctx) -> int {
+    enable_message_bus(ctx);
+    ctx.preinitialize();
+
+    eagitest::ctx_suite test{ctx, "router", 1};
+    test.repeat(5, router_flood_child_router);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    return eagine::test_main_impl(argc, argv, test_main);
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end_ctx.hpp>
@@ -0,0 +1,268 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+export module eagine.msgbus.core:routing_table;
+
+import std;
+import eagine.core.types;
+import eagine.core.identifier;
+import :types;
+
+namespace eagine::msgbus {
+//------------------------------------------------------------------------------
+/// @brief Enumeration of the states of routing table entries.
+/// @ingroup msgbus
+/// @see basic_routing_table
+export enum class routing_entry_state : std::uint8_t {
+    /// @brief The outgoing node leading to the endpoint is known.
+    routed,
+    /// @brief The target is unknown and was recently flooded to all nodes.
+    flooded,
+    /// @brief The endpoint was recently disconnected.
+    disconnected
+};
+//------------------------------------------------------------------------------
+/// @brief Entry in a message bus routing table.
+/// @ingroup msgbus
+/// @see basic_routing_table
+export template <typename Info>
+struct routing_table_entry {
+    using clock_type = std::chrono::steady_clock;
+
+    /// @brief Id of the outgoing node leading to the endpoint.
+    endpoint_id_t outgoing_id{};
+    /// @brief The expiration time of the negative (flooded, disconnected) states.
+    clock_type::time_point expires{};
+    /// @brief The state of this entry.
+    routing_entry_state state{routing_entry_state::routed};
+    /// @brief Indicates that the additional info was set by the endpoint.
+    bool has_info{false};
+    /// @brief Additional information about the endpoint.
+    Info info{};
+
+    /// @brief Indicates if the outgoing node leading to the endpoint is known.
+    auto is_routed() const noexcept -> bool {
+        return (state == routing_entry_state::routed) and
+               is_valid_id(outgoing_id);
+    }
+
+    /// @brief Indicates if this entry caches a negative lookup result.
+    auto is_negative(const clock_type::time_point now) const noexcept
+      -> bool {
+        return (state != routing_entry_state::routed) and (now < expires);
+    }
+
+    /// @brief Indicates if this entry is negative, but expired.
+    auto is_expired(const clock_type::time_point now) const noexcept -> bool {
+        return (state != routing_entry_state::routed) and not(now < expires);
+    }
+
+    /// @brief Marks this entry as routed through the specified node.
+    void route_through(const endpoint_id_t node_id) noexcept {
+        state = routing_entry_state::routed;
+        outgoing_id = node_id;
+    }
+
+    /// @brief Marks this entry as negative until the specified time.
+    void mark(
+      const routing_entry_state new_state,
+      const clock_type::time_point until) noexcept {
+        state = new_state;
+        expires = until;
+        outgoing_id = {};
+    }
+};
+//------------------------------------------------------------------------------
+/// @brief Open-addressing hash table mapping endpoint ids to routing entries.
+/// @ingroup msgbus
+/// @see routing_table_entry
+///
+/// The endpoint ids are kept in a separate densely packed array, so that
+/// the linear probing touches only the keys, and the whole entry with
+/// the outgoing node id and the endpoint info is accessed only on a hit.
+export template <typename Info>
+class basic_routing_table {
+public:
+    using entry_type = routing_table_entry<Info>;
+
+    /// @brief Returns the number of entries in this table.
+    auto size() const noexcept -> span_size_t {
+        return _count;
+    }
+
+    /// @brief Indicates if this table is empty.
+    auto empty() const noexcept -> bool {
+        return _count == 0;
+    }
+
+    /// @brief Reserves space for the specified number of entries.
+    void reserve(const span_size_t count) noexcept {
+        std::size_t capacity{_min_capacity};
+        while(capacity * _max_load_den < std::size_t(count) * _max_load_num) {
+            capacity <<= 1U;
+        }
+        if(capacity > _keys.size()) {
+            _rehash(capacity);
+        }
+    }
+
+    /// @brief Finds the entry for the specified endpoint id.
+    auto find(const endpoint_id_t endpoint_id) noexcept -> entry_type* {
+        if(const auto pos{_find_pos(endpoint_id)}) [[likely]] {
+            return &_entries[*pos];
+        }
+        return nullptr;
+    }
+
+    /// @brief Finds the entry for the specified endpoint id.
+    auto find(const endpoint_id_t endpoint_id) const noexcept
+      -> const entry_type* {
+        if(const auto pos{_find_pos(endpoint_id)}) [[likely]] {
+            return &_entries[*pos];
+        }
+        return nullptr;
+    }
+
+    /// @brief Returns the entry for the specified endpoint id, inserts if needed.
+    auto operator[](const endpoint_id_t endpoint_id) noexcept -> entry_type& {
+        if(
+          std::size_t(_count + 1) * _max_load_den >
+          _keys.size() * _max_load_num) [[unlikely]] {
+            _rehash(_keys.empty() ? _min_capacity : _keys.size() * 2U);
+        }
+        const auto mask{_keys.size() - 1U};
+        for(auto pos{_home(endpoint_id)};; pos = (pos + 1U) & mask) {
+            if(_keys[pos] == endpoint_id) {
+                return _entries[pos];
+            }
+            if(not is_valid_id(_keys[pos])) {
+                _keys[pos] = endpoint_id;
+                _entries[pos] = {};
+                ++_count;
+                return _entries[pos];
+            }
+        }
+    }
+
+    /// @brief Erases the entry for the specified endpoint id.
+    /// @note Invalidates pointers to entries.
+    auto erase(const endpoint_id_t endpoint_id) noexcept -> bool {
+        if(const auto found{_find_pos(endpoint_id)}) {
+            _erase_at(*found);
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Erases all entries for which the predicate returns true.
+    /// @note The predicate is called exactly once for each entry and can
+    ///       modify the entry.
+    template <typename Predicate>
+    auto erase_if(Predicate predicate) noexcept -> span_size_t {
+        // the keys are collected first, because the backward-shift deletion
+        // moves the entries that were not visited yet
+        _erased.clear();
+        for(std::size_t pos = 0; pos < _keys.size(); ++pos) {
+            if(is_valid_id(_keys[pos])) {
+                if(predicate(_keys[pos], _entries[pos])) {
+                    _erased.push_back(_keys[pos]);
+                }
+            }
+        }
+        for(const auto endpoint_id : _erased) {
+            erase(endpoint_id);
+        }
+        return span_size(_erased.size());
+    }
+
+    /// @brief Calls the specified function for each entry.
+    template <typename Function>
+    void for_each(Function func) noexcept {
+        for(std::size_t pos = 0; pos < _keys.size(); ++pos) {
+            if(is_valid_id(_keys[pos])) {
+                func(_keys[pos], _entries[pos]);
+            }
+        }
+    }
+
+    /// @brief Removes all entries from this table.
+    void clear() noexcept {
+        std::fill(_keys.begin(), _keys.end(), endpoint_id_t{});
+        _count = 0;
+    }
+
+private:
+    static constexpr const std::size_t _min_capacity{64U};
+    static constexpr const std::size_t _max_load_num{3U};
+    static constexpr const std::size_t _max_load_den{4U};
+
+    auto _home(const endpoint_id_t endpoint_id) const noexcept -> std::size_t {
+        // Fibonacci hashing spreads the mostly sequential endpoint ids
+        const auto hash{
+          std::uint64_t(endpoint_id.value()) * 0x9E37'79B9'7F4A'7C15ULL};
+        return std::size_t(hash >> 32U) & (_keys.size() - 1U);
+    }
+
+    auto _find_pos(const endpoint_id_t endpoint_id) const noexcept
+      -> std::optional<std::size_t> {
+        if(_keys.empty() or not is_valid_id(endpoint_id)) [[unlikely]] {
+            return {};
+        }
+        const auto mask{_keys.size() - 1U};
+        for(auto pos{_home(endpoint_id)};; pos = (pos + 1U) & mask) {
+            if(_keys[pos] == endpoint_id) [[likely]] {
+                return {pos};
+            }
+            if(not is_valid_id(_keys[pos])) {
+                return {};
+            }
+        }
+    }
+
+    void _erase_at(std::size_t pos) noexcept {
+        // backward-shift deletion, keeps the probe sequences tombstone-free
+        const auto mask{_keys.size() - 1U};
+        auto next{(pos + 1U) & mask};
+        while(is_valid_id(_keys[next])) {
+            const auto home{_home(_keys[next])};
+            if(((next - home) & mask) >= ((next - pos) & mask)) {
+                _keys[pos] = _keys[next];
+                _entries[pos] = std::move(_entries[next]);
+                pos = next;
+            }
+            next = (next + 1U) & mask;
+        }
+        _keys[pos] = {};
+        _entries[pos] = {};
+        --_count;
+    }
+
+    void _rehash(const std::size_t capacity) noexcept {
+        std::vector<endpoint_id_t> old_keys(capacity);
+        std::vector<entry_type> old_entries(capacity);
+        std::swap(old_keys, _keys);
+        std::swap(old_entries, _entries);
+        const auto mask{_keys.size() - 1U};
+        for(std::size_t old = 0; old < old_keys.size(); ++old) {
+            if(is_valid_id(old_keys[old])) {
+                auto pos{_home(old_keys[old])};
+                while(is_valid_id(_keys[pos])) {
+                    pos = (pos + 1U) & mask;
+                }
+                _keys[pos] = old_keys[old];
+                _entries[pos] = std::move(old_entries[old]);
+            }
+        }
+    }
+
+    std::vector<endpoint_id_t> _keys;
+    std::vector<entry_type> _entries;
+    std::vector<endpoint_id_t> _erased;
+    span_size_t _count{0};
+};
+//------------------------------------------------------------------------------
+} // namespace eagine::msgbus
@@ -0,0 +1,159 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin_ctx.hpp>
+import std;
+import eagine.core;
+import eagine.msgbus.core;
+//------------------------------------------------------------------------------
+// empty
+//------------------------------------------------------------------------------
+void routing_table_empty(auto& s) {
+    eagitest::case_ test{s, 1, "empty"};
+
+    eagine::msgbus::basic_routing_table<int> table;
+    test.check(table.empty(), "is empty");
+    test.check_equal(table.size(), eagine::span_size_t(0), "size is zero");
+    test.check(table.find(eagine::endpoint_id_t{1}) == nullptr, "not found 1");
+    test.check(table.find(eagine::endpoint_id_t{}) == nullptr, "not found 0");
+}
+//------------------------------------------------------------------------------
+// insert / find
+//------------------------------------------------------------------------------
+void routing_table_insert_find(unsigned, auto& s) {
+    eagitest::case_ test{s, 2, "insert/find"};
+    auto& rg{test.random()};
+
+    eagine::msgbus::basic_routing_table<int> table;
+    std::map<eagine::identifier_t, int> reference;
+
+    for(unsigned i = 0; i < test.repeats(5000); ++i) {
+        const auto id{rg.get_between<eagine::identifier_t>(1, 100000)};
+        const auto value{rg.get_int(0, 1000)};
+        auto& entry = table[eagine::endpoint_id_t{id}];
+        entry.info = value;
+        entry.route_through(eagine::endpoint_id_t{id % 16 + 1});
+        reference[id] = value;
+    }
+
+    test.check_equal(
+      table.size(), eagine::span_size(reference.size()), "same size");
+
+    for(const auto& [id, value] : reference) {
+        const auto found{table.find(eagine::endpoint_id_t{id})};
+        test.ensure(found != nullptr, "found");
+        test.check_equal(found->info, value, "same value");
+        test.check(found->is_routed(), "is routed");
+        test.check(
+          found->outgoing_id == eagine::endpoint_id_t{id % 16 + 1},
+          "same outgoing id");
+    }
+}
+//------------------------------------------------------------------------------
+// erase
+//------------------------------------------------------------------------------
+void routing_table_erase(unsigned, auto& s) {
+    eagitest::case_ test{s, 3, "erase"};
+    auto& rg{test.random()};
+
+    eagine::msgbus::basic_routing_table<int> table;
+    std::set<eagine::identifier_t> reference;
+
+    for(unsigned i = 0; i < test.repeats(10000); ++i) {
+        const auto id{rg.get_between<eagine::identifier_t>(1, 2000)};
+        if(rg.get_bool()) {
+            table[eagine::endpoint_id_t{id}].info = int(id);
+            reference.insert(id);
+        } else {
+            test.check_equal(
+              table.erase(eagine::endpoint_id_t{id}),
+              reference.erase(id) > 0,
+              "erased");
+        }
+    }
+
+    test.check_equal(
+      table.size(), eagine::span_size(reference.size()), "same size");
+
+    for(eagine::identifier_t id = 1; id <= 2000; ++id) {
+        const auto found{table.find(eagine::endpoint_id_t{id})};
+        if(reference.contains(id)) {
+            test.ensure(found != nullptr, "found");
+            test.check_equal(found->info, int(id), "same value");
+        } else {
+            test.check(found == nullptr, "not found");
+        }
+    }
+}
+//------------------------------------------------------------------------------
+// erase_if
+//------------------------------------------------------------------------------
+void routing_table_erase_if(auto& s) {
+    eagitest::case_ test{s, 4, "erase_if"};
+
+    eagine::msgbus::basic_routing_table<int> table;
+    table.reserve(1000);
+    for(eagine::identifier_t id = 1; id <= 1000; ++id) {
+        table[eagine::endpoint_id_t{id}].info = int(id);
+    }
+
+    const auto erased{table.erase_if([](auto, auto& entry) {
+        return entry.info % 3 == 0;
+    })};
+    test.check_equal(erased, eagine::span_size_t(333), "erased count");
+    test.check_equal(
+      table.size(), eagine::span_size_t(667), "remaining count");
+
+    for(eagine::identifier_t id = 1; id <= 1000; ++id) {
+        const auto found{table.find(eagine::endpoint_id_t{id})};
+        test.check_equal(found != nullptr, id % 3 != 0, "found");
+    }
+}
+//------------------------------------------------------------------------------
+// negative entries
+//------------------------------------------------------------------------------
+void routing_table_negative(auto& s) {
+    eagitest::case_ test{s, 5, "negative"};
+    using eagine::msgbus::routing_entry_state;
+    const auto now{std::chrono::steady_clock::now()};
+
+    eagine::msgbus::basic_routing_table<int> table;
+    auto& flooded = table[eagine::endpoint_id_t{1}];
+    flooded.mark(routing_entry_state::flooded, now + std::chrono::seconds{1});
+    test.check(not flooded.is_routed(), "flooded is not routed");
+    test.check(flooded.is_negative(now), "flooded is negative");
+    test.check(not flooded.is_expired(now), "flooded is not expired");
+    test.check(
+      flooded.is_expired(now + std::chrono::seconds{2}), "flooded expires");
+
+    auto& routed = table[eagine::endpoint_id_t{2}];
+    routed.route_through(eagine::endpoint_id_t{3});
+    test.check(routed.is_routed(), "routed is routed");
+    test.check(not routed.is_negative(now), "routed is not negative");
+    test.check(
+      not routed.is_expired(now + std::chrono::seconds{2}),
+      "routed does not expire");
+}
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+auto test_main(eagine::test_ctx& ctx) -> int {
+    eagitest::ctx_suite test{ctx, "routing_table", 5};
+    test.once(routing_table_empty);
+    test.repeat(10, routing_table_insert_find);
+    test.repeat(10, routing_table_erase);
+    test.once(routing_table_erase_if);
+    test.once(routing_table_negative);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    return eagine::test_main_impl(argc, argv, test_main);
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end_ctx.hpp>
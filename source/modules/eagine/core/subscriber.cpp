@@ -171,7 +171,8 @@ protected:
       : _endpoint{bus} {}
 
     subscriber_base(subscriber_base&& temp) noexcept
-      : _endpoint{temp._endpoint} {}
+      : _endpoint{temp._endpoint}
+      , _dispatch{std::move(temp._dispatch)} {}
 
     template <typename Base, typename Unused>
     auto decode_chain(
@@ -287,10 +288,22 @@ protected:
     auto _process_all(const span<const handler_entry> msg_handlers) noexcept
       -> work_done {
         span_size_t done{0};
-        for(const auto& entry : msg_handlers) {
-            assert(entry.queue);
-            const message_context msg_ctx{this->bus_node(), entry.msg_id};
-            done += entry.queue->process_all(msg_ctx, entry.handler);
+        if(not _dispatch.empty()) [[likely]] {
+            // visit only the queues that received some messages
+            _endpoint.visit_dirty_queues(
+              {construct_from, [&](message_priority_queue& queue) {
+                   if(const auto entry{_find_handler(msg_handlers, queue)}) {
+                       const message_context msg_ctx{
+                         this->bus_node(), entry->msg_id};
+                       done += queue.process_all(msg_ctx, entry->handler);
+                   }
+               }});
+        } else {
+            for(const auto& entry : msg_handlers) {
+                assert(entry.queue);
+                const message_context msg_ctx{this->bus_node(), entry.msg_id};
+                done += entry.queue->process_all(msg_ctx, entry.handler);
+            }
         }
         return done > 0;
     }
@@ -311,6 +324,7 @@ protected:
         for(auto& entry : msg_handlers) {
             entry.queue = &this->bus_node().ensure_queue(entry.msg_id);
         }
+        _setup_dispatch(msg_handlers);
     }
 
     void _finish() noexcept {
@@ -321,7 +335,49 @@ protected:
     }
 
 private:
+    static auto _queue_hash(const message_priority_queue* queue) noexcept
+      -> std::size_t {
+        const auto h{
+          std::size_t(std::bit_cast<std::uintptr_t>(queue) >> 4U) *
+          std::size_t(0x9E3779B97F4A7C15U)};
+        return h ^ (h >> 17U);
+    }
+
+    // builds the open-addressing table mapping queues to handler entries
+    void _setup_dispatch(const span<handler_entry> msg_handlers) noexcept {
+        const auto size{std::bit_ceil(
+          std::max(std_size(msg_handlers.size()) * 2U, std::size_t(8U)))};
+        const auto mask{size - 1U};
+        _dispatch.assign(size, {nullptr, 0});
+        for(span_size_t index = 0; index < msg_handlers.size(); ++index) {
+            auto pos{_queue_hash(msg_handlers[index].queue)};
+            while(std::get<0>(_dispatch[pos & mask])) {
+                ++pos;
+            }
+            _dispatch[pos & mask] = {msg_handlers[index].queue, index};
+        }
+    }
+
+    auto _find_handler(
+      const span<const handler_entry> msg_handlers,
+      const message_priority_queue& queue) const noexcept
+      -> const handler_entry* {
+        const auto mask{_dispatch.size() - 1U};
+        for(auto pos{_queue_hash(&queue)};; ++pos) {
+            const auto& [entry_queue, index] = _dispatch[pos & mask];
+            if(not entry_queue) {
+                break;
+            }
+            if(entry_queue == &queue) [[likely]] {
+                return &msg_handlers[index];
+            }
+        }
+        return nullptr;
+    }
+
     endpoint& _endpoint;
+    std::vector<std::tuple<const message_priority_queue*, span_size_t>>
+      _dispatch;
 };
 //------------------------------------------------------------------------------
 /// @brief Template for subscribers with predefined count of handled message types.
@@ -267,6 +267,26 @@ export struct endpoint_info {
     }
 };
 //------------------------------------------------------------------------------
+/// @brief Message bus connection message batching policy.
+/// @ingroup msgbus
+/// @see connection_statistics
+export enum class connection_batching_policy : std::uint8_t {
+    /// @brief Fixed block size and priority-based send countdown.
+    fixed,
+    /// @brief Block size and flush deadline adapted to the measured load.
+    adaptive
+};
+//------------------------------------------------------------------------------
+/// @brief Format of the bus message header used on the wire.
+/// @ingroup msgbus
+/// @see compact_message_header
+export enum class message_header_format : std::uint8_t {
+    /// @brief Header written by the default (portable) serializer backend.
+    portable,
+    /// @brief Fixed-layout, little-endian binary header.
+    compact
+};
+//------------------------------------------------------------------------------
 /// @brief Structure holding message bus connection statistics.
 /// @ingroup msgbus
 export struct connection_statistics {
@@ -281,6 +301,22 @@ export struct connection_statistics {
 
     /// @brief Number of bytes per second transferred.
     float bytes_per_second{-1.F};
+
+    /// @brief The message batching policy used by the connection.
+    connection_batching_policy batching_policy{
+      connection_batching_policy::fixed};
+
+    /// @brief The currently used message data block size in bytes.
+    std::int32_t block_size{-1};
+
+    /// @brief How long can a partially filled block wait, in microseconds.
+    std::int32_t flush_deadline_us{-1};
+
+    /// @brief Average duration of sending a block, in microseconds.
+    std::int32_t send_latency_us{-1};
+
+    /// @brief Number of sends postponed because the peer's queue was full.
+    std::int32_t queue_full_count{-1};
 };
 //------------------------------------------------------------------------------
 /// @brief Structure holding message bus data flow information.
@@ -324,8 +360,12 @@ export auto parse_ipv4_addr(const string_view addr_str) noexcept
 /// @ingroup msgbus
 /// @see blob_option
 export enum class blob_option : std::uint8_t {
+    /// @brief The blob content is compressed.
     compressed = 1U << 0U,
-    with_metadata = 1U << 1U
+    /// @brief The blob carries metadata.
+    with_metadata = 1U << 1U,
+    /// @brief The fragments are acknowledged and sent in a congestion window.
+    windowed = 1U << 2U
 };
 
 //------------------------------------------------------------------------------
@@ -466,12 +506,33 @@ struct enumerator_traits<msgbus::connection_protocol> {
 };
 //------------------------------------------------------------------------------
 export template <>
+struct enumerator_traits<msgbus::connection_batching_policy> {
+    static constexpr auto mapping() noexcept {
+        using msgbus::connection_batching_policy;
+        return enumerator_map_type<connection_batching_policy, 2>{
+          {{"fixed", connection_batching_policy::fixed},
+           {"adaptive", connection_batching_policy::adaptive}}};
+    }
+};
+//------------------------------------------------------------------------------
+export template <>
+struct enumerator_traits<msgbus::message_header_format> {
+    static constexpr auto mapping() noexcept {
+        using msgbus::message_header_format;
+        return enumerator_map_type<message_header_format, 2>{
+          {{"portable", message_header_format::portable},
+           {"compact", message_header_format::compact}}};
+    }
+};
+//------------------------------------------------------------------------------
+export template <>
 struct enumerator_traits<msgbus::blob_option> {
     static constexpr auto mapping() noexcept {
         using msgbus::blob_option;
-        return enumerator_map_type<blob_option, 2>{
+        return enumerator_map_type<blob_option, 3>{
           {{"compressed", blob_option::compressed},
-           {"with_metadata", blob_option::with_metadata}}};
+           {"with_metadata", blob_option::with_metadata},
+           {"windowed", blob_option::windowed}}};
     }
 };
 //------------------------------------------------------------------------------
@@ -616,11 +677,21 @@ struct data_member_traits<msgbus::connection_statistics> {
           endpoint_id_t,
           endpoint_id_t,
           float,
-          float>(
+          float,
+          msgbus::connection_batching_policy,
+          std::int32_t,
+          std::int32_t,
+          std::int32_t,
+          std::int32_t>(
           {"local_id", &S::local_id},
           {"remote_id", &S::remote_id},
           {"block_usage_ratio", &S::block_usage_ratio},
-          {"bytes_per_second", &S::bytes_per_second});
+          {"bytes_per_second", &S::bytes_per_second},
+          {"batching_policy", &S::batching_policy},
+          {"block_size", &S::block_size},
+          {"flush_deadline_us", &S::flush_deadline_us},
+          {"send_latency_us", &S::send_latency_us},
+          {"queue_full_count", &S::queue_full_count});
     }
 };
 //------------------------------------------------------------------------------
@@ -20,6 +20,31 @@ import :host_info;
 
 namespace eagine::msgbus {
 //------------------------------------------------------------------------------
+/// @brief Creates a BLOB I/O object reading the content of a file.
+/// @ingroup msgbus
+/// @see make_file_target_blob_io
+///
+/// The optional offset and size select a part of the file. Where supported,
+/// the file is memory-mapped and the fragments are copied straight from
+/// the page cache. Returns an empty holder if the file cannot be opened.
+export auto make_file_source_blob_io(
+  const std::filesystem::path& file_path,
+  std::optional<span_size_t> offs = {},
+  std::optional<span_size_t> size = {}) noexcept
+  -> shared_holder<source_blob_io>;
+
+/// @brief Creates a BLOB I/O object storing the received content into a file.
+/// @ingroup msgbus
+/// @see make_file_source_blob_io
+///
+/// The file is created or truncated. Where supported, it is resized to the
+/// total BLOB size when the first fragment arrives, without allocating its
+/// blocks, and memory-mapped. Returns an empty holder if the file cannot
+/// be opened.
+export auto make_file_target_blob_io(
+  const std::filesystem::path& file_path) noexcept
+  -> shared_holder<target_blob_io>;
+//------------------------------------------------------------------------------
 export struct resource_server_driver : interface<resource_server_driver> {
     virtual auto has_resource(const url&) noexcept -> tribool {
         return indeterminate;
@@ -127,6 +152,11 @@ export struct resource_manipulator_signals {
     signal<void(const endpoint_id_t, const url&) noexcept>
       server_has_not_resource;
 
+    /// @brief Triggered when a server responds with the size of a resource.
+    /// @see query_resource_size
+    signal<void(const endpoint_id_t, const url&, const span_size_t) noexcept>
+      server_resource_size;
+
     /// @brief Triggered when a resource becomes available.
     signal<void(const endpoint_id_t, const url&) noexcept> resource_appeared;
 
@@ -152,6 +182,10 @@ struct resource_manipulator_intf : interface<resource_manipulator_intf> {
       const endpoint_id_t endpoint_id,
       const url& locator) noexcept -> std::optional<message_sequence_t> = 0;
 
+    virtual auto query_resource_size(
+      const endpoint_id_t endpoint_id,
+      const url& locator) noexcept -> std::optional<message_sequence_t> = 0;
+
     virtual auto query_resource_content(
       endpoint_id_t endpoint_id,
       const url& locator,
@@ -159,6 +193,10 @@ struct resource_manipulator_intf : interface<resource_manipulator_intf> {
       const message_priority priority,
       const std::chrono::seconds max_time)
       -> std::optional<message_sequence_t> = 0;
+
+    virtual void cancel_resource_content(
+      const endpoint_id_t endpoint_id,
+      const message_sequence_t request_id) noexcept = 0;
 };
 //------------------------------------------------------------------------------
 auto make_resource_manipulator_impl(subscriber&, resource_manipulator_signals&)
@@ -201,6 +239,18 @@ public:
         return search_resource(broadcast_endpoint_id(), locator);
     }
 
+    /// @brief Sends a query to a server asking for the size of a resource.
+    /// @see server_resource_size
+    /// @see server_has_not_resource
+    ///
+    /// The size is used to split the resource into ranges, that can be
+    /// requested by adding the offs and size arguments to the locator.
+    auto query_resource_size(
+      const endpoint_id_t endpoint_id,
+      const url& locator) noexcept -> std::optional<message_sequence_t> {
+        return _impl->query_resource_size(endpoint_id, locator);
+    }
+
     /// @brief Requests the contents of the file with the specified URL.
     auto query_resource_content(
       endpoint_id_t endpoint_id,
@@ -244,6 +294,17 @@ public:
           max_time);
     }
 
+    /// @brief Stops the transfer of a resource content requested earlier.
+    /// @see query_resource_content
+    ///
+    /// The target I/O object is notified through handle_cancelled and
+    /// the server is asked to stop sending the data.
+    void cancel_resource_content(
+      const endpoint_id_t endpoint_id,
+      const message_sequence_t request_id) noexcept {
+        _impl->cancel_resource_content(endpoint_id, request_id);
+    }
+
 protected:
     using base::base;
 
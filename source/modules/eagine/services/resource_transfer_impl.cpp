@@ -9,6 +9,17 @@ module;
 
 #include <cassert>
 
+#if __has_include(<fcntl.h>) && __has_include(<sys/mman.h>) && \
+  __has_include(<sys/stat.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EAGINE_MSGBUS_USE_MAPPED_FILE_BLOB_IO 1
+#else
+#define EAGINE_MSGBUS_USE_MAPPED_FILE_BLOB_IO 0
+#endif
+
 module eagine.msgbus.services;
 
 import std;
@@ -167,8 +178,11 @@ public:
     auto store_fragment(
       const span_size_t offs,
       const memory::const_block src,
-      const blob_info&) noexcept -> bool final {
-        _file.seekg(_offs + offs, std::ios::beg);
+      const blob_info& info) noexcept -> bool final {
+        if(_size == 0) {
+            _size = _offs + info.total_size;
+        }
+        _file.seekp(_offs + offs, std::ios::beg);
         return write_to_stream(_file, head(src, _size - _offs - offs)).good();
     }
 
@@ -203,12 +217,315 @@ file_blob_io::file_blob_io(
     _file.seekg(0, std::ios::end);
     _size = static_cast<span_size_t>(_file.tellg());
     if(size) {
-        _size = _size ? math::minimum(_size, *size) : *size;
+        const auto end{offs.value_or(0) + *size};
+        _size = _size ? math::minimum(_size, end) : end;
     }
     if(offs) {
         _offs = math::minimum(_size, *offs);
     }
 }
+//------------------------------------------------------------------------------
+// range_source_blob_io
+//------------------------------------------------------------------------------
+class range_source_blob_io final : public source_blob_io {
+public:
+    range_source_blob_io(
+      shared_holder<source_blob_io> io,
+      std::optional<span_size_t> offs,
+      std::optional<span_size_t> size) noexcept
+      : _io{std::move(io)}
+      , _offs{offs.value_or(0)}
+      , _size{size} {}
+
+    auto prepare() noexcept -> blob_preparation_result final {
+        return _io->prepare();
+    }
+
+    auto total_size() noexcept -> span_size_t final {
+        // the size of the wrapped I/O may be known only after preparation
+        const auto rest{math::maximum(_io->total_size() - _offs, span_size(0))};
+        return _size ? math::minimum(rest, *_size) : rest;
+    }
+
+    auto fetch_fragment(const span_size_t offs, memory::block dst) noexcept
+      -> span_size_t final {
+        const auto rest{math::maximum(total_size() - offs, span_size(0))};
+        return _io->fetch_fragment(_offs + offs, head(dst, rest));
+    }
+
+private:
+    shared_holder<source_blob_io> _io;
+    const span_size_t _offs;
+    const std::optional<span_size_t> _size;
+};
+//------------------------------------------------------------------------------
+#if EAGINE_MSGBUS_USE_MAPPED_FILE_BLOB_IO
+//------------------------------------------------------------------------------
+// mapped_file
+//------------------------------------------------------------------------------
+class mapped_file {
+public:
+    mapped_file(const int fd) noexcept
+      : _fd{fd} {}
+    mapped_file(mapped_file&&) = delete;
+    mapped_file(const mapped_file&) = delete;
+    auto operator=(mapped_file&&) = delete;
+    auto operator=(const mapped_file&) = delete;
+
+    ~mapped_file() noexcept {
+        close();
+    }
+
+    static auto open(
+      const std::filesystem::path& path,
+      const int flags) noexcept -> int {
+        // NOLINTNEXTLINE(hicpp-signed-bitwise)
+        return ::open(path.c_str(), flags | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    }
+
+    auto file_size() const noexcept -> span_size_t {
+        struct ::stat st{};
+        if(::fstat(_fd, &st) == 0) {
+            return limit_cast<span_size_t>(st.st_size);
+        }
+        return 0;
+    }
+
+    auto resize(const span_size_t size) noexcept -> bool {
+        // does not allocate the blocks, the file stays sparse until written
+        return ::ftruncate(_fd, static_cast<::off_t>(size)) == 0;
+    }
+
+    auto map(
+      const span_size_t offs,
+      const span_size_t size,
+      const int prot) noexcept -> bool {
+        // the mapping has to start at a page boundary
+        const auto page_offs{offs % _page_size()};
+        void* addr{::mmap(
+          nullptr,
+          std_size(page_offs + size),
+          prot,
+          MAP_SHARED,
+          _fd,
+          static_cast<::off_t>(offs - page_offs))};
+        if(addr != MAP_FAILED) [[likely]] {
+            _addr = addr;
+            _map_size = page_offs + size;
+            _skip = page_offs;
+            return true;
+        }
+        return false;
+    }
+
+    void advise(
+      const span_size_t offs,
+      const span_size_t size,
+      const int advice) const noexcept {
+        const auto bgn{math::minimum(_skip + offs, _map_size)};
+        const auto page_bgn{bgn - bgn % _page_size()};
+        const auto end{math::minimum(_skip + offs + size, _map_size)};
+        if(page_bgn < end) {
+            ::madvise(
+              static_cast<byte*>(_addr) + page_bgn,
+              std_size(end - page_bgn),
+              advice);
+        }
+    }
+
+    auto content() const noexcept -> memory::block {
+        return skip(memory::block{static_cast<byte*>(_addr), _map_size}, _skip);
+    }
+
+    void close() noexcept {
+        if(_addr) {
+            ::munmap(_addr, std_size(_map_size));
+            _addr = nullptr;
+            _map_size = 0;
+            _skip = 0;
+        }
+        if(_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+    }
+
+private:
+    static auto _page_size() noexcept -> span_size_t {
+        static const auto page_size{math::maximum(
+          limit_cast<span_size_t>(::sysconf(_SC_PAGESIZE)), span_size_t(1))};
+        return page_size;
+    }
+
+    int _fd{-1};
+    void* _addr{nullptr};
+    span_size_t _map_size{0};
+    span_size_t _skip{0};
+};
+//------------------------------------------------------------------------------
+// mapped_file_source_blob_io
+//------------------------------------------------------------------------------
+class mapped_file_source_blob_io final : public source_blob_io {
+public:
+    mapped_file_source_blob_io(
+      const int fd,
+      std::optional<span_size_t> offs,
+      std::optional<span_size_t> size) noexcept;
+
+    auto total_size() noexcept -> span_size_t final {
+        return _content.size();
+    }
+
+    auto fetch_fragment(const span_size_t offs, memory::block dst) noexcept
+      -> span_size_t final {
+        // touching the mapping past the end of a file truncated meanwhile
+        // raises SIGBUS, so only the part still backed by the file is copied
+        const auto backed{math::maximum(
+          _file.file_size() - _file_offs - offs, span_size_t(0))};
+        const auto src{
+          head(skip(_content, offs), math::minimum(dst.size(), backed))};
+        if(src.empty()) [[unlikely]] {
+            return 0;
+        }
+        if(offs + src.size() > _prefetched) {
+            // keep the kernel reading ahead of the fragments being sent
+            _prefetched = offs + _prefetch_size;
+            _file.advise(offs, _prefetch_size, MADV_WILLNEED);
+        }
+        copy(src, dst);
+        return src.size();
+    }
+
+private:
+    static constexpr const span_size_t _prefetch_size{4 * 1024 * 1024};
+
+    mapped_file _file;
+    memory::const_block _content;
+    span_size_t _file_offs{0};
+    span_size_t _prefetched{0};
+};
+//------------------------------------------------------------------------------
+mapped_file_source_blob_io::mapped_file_source_blob_io(
+  const int fd,
+  std::optional<span_size_t> offs,
+  std::optional<span_size_t> size) noexcept
+  : _file{fd} {
+    const auto file_size{_file.file_size()};
+    const auto bgn{math::minimum(file_size, offs.value_or(0))};
+    const auto len{math::minimum(file_size - bgn, size.value_or(file_size))};
+    if((len > 0) and _file.map(bgn, len, PROT_READ)) {
+        _file.advise(0, len, MADV_SEQUENTIAL);
+        _content = head(_file.content(), len);
+        _file_offs = bgn;
+    }
+}
+//------------------------------------------------------------------------------
+// mapped_file_target_blob_io
+//------------------------------------------------------------------------------
+class mapped_file_target_blob_io final : public target_blob_io {
+public:
+    mapped_file_target_blob_io(const int fd) noexcept
+      : _file{fd} {}
+
+    auto store_fragment(
+      const span_size_t offs,
+      const memory::const_block src,
+      const blob_info& info) noexcept -> bool final {
+        if(not _mapped and not _map(info.total_size)) [[unlikely]] {
+            return false;
+        }
+        auto dst{skip(_content, offs)};
+        if(src.size() <= dst.size()) [[likely]] {
+            copy(src, dst);
+            return true;
+        }
+        return false;
+    }
+
+    auto check_stored(
+      const span_size_t offs,
+      const memory::const_block blk) noexcept -> bool final {
+        return are_equal(head(skip(_content, offs), blk.size()), blk);
+    }
+
+    void handle_finished(
+      const message_id,
+      const message_age,
+      const message_info&,
+      const blob_info&) noexcept final {
+        _content = {};
+        _file.close();
+    }
+
+    void handle_cancelled() noexcept final {
+        _content = {};
+        _file.close();
+    }
+
+private:
+    auto _map(const span_size_t size) noexcept -> bool {
+        if(size == 0) {
+            // the file was truncated when opened, zero bytes cannot be mapped
+            _mapped = true;
+            return true;
+        }
+        // the file is pre-sized so that fragments can arrive in any order
+        if(_file.resize(size) and _file.map(0, size, PROT_READ | PROT_WRITE)) {
+            _file.advise(0, size, MADV_SEQUENTIAL);
+            _content = _file.content();
+            _mapped = true;
+            return true;
+        }
+        return false;
+    }
+
+    mapped_file _file;
+    memory::block _content;
+    bool _mapped{false};
+};
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
+auto make_file_source_blob_io(
+  const std::filesystem::path& file_path,
+  std::optional<span_size_t> offs,
+  std::optional<span_size_t> size) noexcept -> shared_holder<source_blob_io> {
+#if EAGINE_MSGBUS_USE_MAPPED_FILE_BLOB_IO
+    // falls back to the stream-based I/O if the file cannot be mapped
+    if(const auto fd{mapped_file::open(file_path, O_RDONLY)}; fd >= 0) {
+        shared_holder<source_blob_io> mapped{
+          hold<mapped_file_source_blob_io>, fd, offs, size};
+        if(mapped->total_size() > 0) {
+            return mapped;
+        }
+    }
+#endif
+    std::fstream file{file_path, std::ios::in | std::ios::binary};
+    if(file.is_open()) {
+        return {hold<file_blob_io>, std::move(file), offs, size};
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+auto make_file_target_blob_io(const std::filesystem::path& file_path) noexcept
+  -> shared_holder<target_blob_io> {
+#if EAGINE_MSGBUS_USE_MAPPED_FILE_BLOB_IO
+    // NOLINTNEXTLINE(hicpp-signed-bitwise)
+    const auto flags{O_RDWR | O_CREAT | O_TRUNC};
+    if(const auto fd{mapped_file::open(file_path, flags)}; fd >= 0) {
+        return {hold<mapped_file_target_blob_io>, fd};
+    }
+#endif
+    std::fstream file{
+      file_path,
+      std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary};
+    if(file.is_open()) {
+        return {
+          hold<file_blob_io>, std::move(file), std::nullopt, std::nullopt};
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
 // resource_server_impl
 //------------------------------------------------------------------------------
 class resource_server_impl : public resource_server_intf {
@@ -260,6 +577,10 @@ private:
       const message_context& ctx,
       const stored_message& message) noexcept -> bool;
 
+    auto _handle_resource_size_query(
+      const message_context& ctx,
+      const stored_message& message) noexcept -> bool;
+
     auto _handle_resource_content_request(
       const message_context& ctx,
       const stored_message& message) noexcept -> bool;
@@ -268,6 +589,14 @@ private:
       const message_context& ctx,
       const stored_message& message) noexcept -> bool;
 
+    auto _handle_resource_ack(
+      const message_context& ctx,
+      const stored_message& message) noexcept -> bool;
+
+    auto _handle_resource_content_cancel(
+      const message_context& ctx,
+      const stored_message& message) noexcept -> bool;
+
     subscriber& base;
     resource_server_driver& driver;
     blob_manipulator _blobs;
@@ -289,7 +618,8 @@ resource_server_impl::resource_server_impl(
       base,
       message_id{"eagiRsrces", "fragment"},
       message_id{"eagiRsrces", "fragResend"},
-      message_id{"eagiRsrces", "blobPrpare"}} {}
+      message_id{"eagiRsrces", "blobPrpare"},
+      message_id{"eagiRsrces", "fragAck"}} {}
 //------------------------------------------------------------------------------
 void resource_server_impl::add_methods() noexcept {
     base.add_method(
@@ -298,6 +628,12 @@ void resource_server_impl::add_methods() noexcept {
         "eagiRsrces",
         "qryResurce",
         &resource_server_impl::_handle_has_resource_query>{});
+    base.add_method(
+      this,
+      message_map<
+        "eagiRsrces",
+        "qryRsrSize",
+        &resource_server_impl::_handle_resource_size_query>{});
     base.add_method(
       this,
       message_map<
@@ -310,6 +646,18 @@ void resource_server_impl::add_methods() noexcept {
         "eagiRsrces",
         "fragResend",
         &resource_server_impl::_handle_resource_resend_request>{});
+    base.add_method(
+      this,
+      message_map<
+        "eagiRsrces",
+        "fragAck",
+        &resource_server_impl::_handle_resource_ack>{});
+    base.add_method(
+      this,
+      message_map<
+        "eagiRsrces",
+        "cnclContnt",
+        &resource_server_impl::_handle_resource_content_cancel>{});
 }
 //------------------------------------------------------------------------------
 auto resource_server_impl::update() noexcept -> work_done {
@@ -396,6 +744,12 @@ auto resource_server_impl::get_resource(
   tuple<shared_holder<source_blob_io>, std::chrono::seconds, message_priority> {
     auto read_io{driver.get_resource_io(endpoint_id, locator)};
     if(not read_io) {
+        const auto range_offs{
+          from_string<span_size_t>(locator.argument("offs").or_default())
+            .to_optional()};
+        const auto range_size{
+          from_string<span_size_t>(locator.argument("size").or_default())
+            .to_optional()};
         if(locator.has_scheme("eagires")) {
             if(const auto count{locator.argument("count")}) {
                 if(const auto bytes{from_string<span_size_t>(*count)}) {
@@ -413,24 +767,23 @@ auto resource_server_impl::get_resource(
                     }
                 }
             }
+            if(read_io and (range_offs or range_size)) {
+                read_io = shared_holder<source_blob_io>{
+                  hold<range_source_blob_io>,
+                  std::move(read_io),
+                  range_offs,
+                  range_size};
+            }
         } else if(locator.has_scheme("file")) {
             const auto file_path = get_file_path(locator);
             if(is_contained(file_path)) {
-                std::fstream file{file_path, std::ios::in | std::ios::binary};
-                if(file.is_open()) {
+                read_io =
+                  make_file_source_blob_io(file_path, range_offs, range_size);
+                if(read_io) {
                     ctx.bus_node()
-                      .log_info("sending file ${filePath} to ${target}")
+                      .log_info("opened file ${filePath} for ${target}")
                       .arg("target", endpoint_id)
                       .arg("filePath", "FsPath", file_path);
-                    read_io.emplace_derived(
-                      hold<file_blob_io>,
-                      std::move(file),
-                      from_string<span_size_t>(
-                        locator.argument("offs").or_default())
-                        .to_optional(),
-                      from_string<span_size_t>(
-                        locator.argument("size").or_default())
-                        .to_optional());
                 }
             }
         }
@@ -468,6 +821,36 @@ auto resource_server_impl::_handle_has_resource_query(
     return true;
 }
 //------------------------------------------------------------------------------
+auto resource_server_impl::_handle_resource_size_query(
+  const message_context& ctx,
+  const stored_message& message) noexcept -> bool {
+    std::string url_str;
+    if(default_deserialize(url_str, message.content())) [[likely]] {
+        const url locator{url_str};
+        auto [read_io, max_time, priority] =
+          get_resource(ctx, locator, message.source_id, message.priority);
+        if(read_io) {
+            const std::tuple<std::string, std::uint64_t> params{
+              std::move(url_str),
+              limit_cast<std::uint64_t>(read_io->total_size())};
+            auto buffer{default_serialize_buffer_for(params)};
+            if(const auto serialized{default_serialize(params, cover(buffer))})
+              [[likely]] {
+                message_view response{*serialized};
+                response.setup_response(message);
+                ctx.bus_node().post(
+                  message_id{"eagiRsrces", "resrceSize"}, response);
+            }
+        } else {
+            message_view response{message.content()};
+            response.setup_response(message);
+            ctx.bus_node().post(
+              message_id{"eagiRsrces", "hasNotRsrc"}, response);
+        }
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
 auto resource_server_impl::_handle_resource_content_request(
   const message_context& ctx,
   const stored_message& message) noexcept -> bool {
@@ -513,6 +896,26 @@ auto resource_server_impl::_handle_resource_resend_request(
     return true;
 }
 //------------------------------------------------------------------------------
+auto resource_server_impl::_handle_resource_ack(
+  const message_context&,
+  const stored_message& message) noexcept -> bool {
+    _blobs.process_ack(message);
+    return true;
+}
+//------------------------------------------------------------------------------
+auto resource_server_impl::_handle_resource_content_cancel(
+  const message_context& ctx,
+  const stored_message& message) noexcept -> bool {
+    if(_blobs.cancel_outgoing(message.source_id, message.sequence_no)) {
+        ctx.bus_node()
+          .log_debug("cancelled content stream for ${target}")
+          .tag("rsrcCntCnl")
+          .arg("target", message.source_id)
+          .arg("blobId", message.sequence_no);
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
 // resource_manipulator_impl
 //------------------------------------------------------------------------------
 class resource_manipulator_impl : public resource_manipulator_intf {
@@ -537,6 +940,10 @@ public:
       const endpoint_id_t endpoint_id,
       const url& locator) noexcept -> std::optional<message_sequence_t> final;
 
+    auto query_resource_size(
+      const endpoint_id_t endpoint_id,
+      const url& locator) noexcept -> std::optional<message_sequence_t> final;
+
     auto query_resource_content(
       endpoint_id_t endpoint_id,
       const url& locator,
@@ -545,7 +952,16 @@ public:
       const std::chrono::seconds max_time)
       -> std::optional<message_sequence_t> final;
 
+    void cancel_resource_content(
+      const endpoint_id_t endpoint_id,
+      const message_sequence_t request_id) noexcept final;
+
 private:
+    auto _send_locator_query(
+      const message_id msg_id,
+      const endpoint_id_t endpoint_id,
+      const url& locator) noexcept -> std::optional<message_sequence_t>;
+
     void _handle_alive(
       const result_context&,
       const subscriber_alive& alive) noexcept;
@@ -580,6 +996,10 @@ private:
       const message_context&,
       const stored_message& message) noexcept -> bool;
 
+    auto _handle_resource_size(
+      const message_context&,
+      const stored_message& message) noexcept -> bool;
+
     auto _handle_resource_fragment(
       [[maybe_unused]] const message_context& ctx,
       const stored_message& message) noexcept -> bool;
@@ -592,6 +1012,10 @@ private:
       const message_context&,
       const stored_message& message) noexcept -> bool;
 
+    auto _handle_resource_ack(
+      const message_context&,
+      const stored_message& message) noexcept -> bool;
+
     auto _handle_resource_prepare(
       const message_context&,
       const stored_message& message) noexcept -> bool;
@@ -606,7 +1030,8 @@ private:
       base.bus_node(),
       message_id{"eagiRsrces", "fragment"},
       message_id{"eagiRsrces", "fragResend"},
-      message_id{"eagiRsrces", "blobPrpare"}};
+      message_id{"eagiRsrces", "blobPrpare"},
+      message_id{"eagiRsrces", "fragAck"}};
 
     resetting_timeout _search_servers{std::chrono::seconds{5}, nothing};
 
@@ -719,6 +1144,20 @@ auto resource_manipulator_impl::_handle_has_not_resource(
     return true;
 }
 //------------------------------------------------------------------------------
+auto resource_manipulator_impl::_handle_resource_size(
+  const message_context&,
+  const stored_message& message) noexcept -> bool {
+    std::tuple<std::string, std::uint64_t> params{};
+    if(default_deserialize(params, message.content())) [[likely]] {
+        const url locator{std::move(std::get<0>(params))};
+        signals.server_resource_size(
+          message.source_id,
+          locator,
+          limit_cast<span_size_t>(std::get<1>(params)));
+    }
+    return true;
+}
+//------------------------------------------------------------------------------
 auto resource_manipulator_impl::_handle_resource_fragment(
   [[maybe_unused]] const message_context& ctx,
   const stored_message& message) noexcept -> bool {
@@ -740,6 +1179,13 @@ auto resource_manipulator_impl::_handle_resource_resend_request(
     return true;
 }
 //------------------------------------------------------------------------------
+auto resource_manipulator_impl::_handle_resource_ack(
+  const message_context&,
+  const stored_message& message) noexcept -> bool {
+    _blobs.process_ack(message);
+    return true;
+}
+//------------------------------------------------------------------------------
 auto resource_manipulator_impl::_handle_resource_prepare(
   const message_context&,
   const stored_message& message) noexcept -> bool {
@@ -792,6 +1238,12 @@ void resource_manipulator_impl::add_methods() noexcept {
         "eagiRsrces",
         "hasNotRsrc",
         &resource_manipulator_impl::_handle_has_not_resource>{});
+    base.add_method(
+      this,
+      message_map<
+        "eagiRsrces",
+        "resrceSize",
+        &resource_manipulator_impl::_handle_resource_size>{});
 
     base.add_method(
       this,
@@ -811,6 +1263,12 @@ void resource_manipulator_impl::add_methods() noexcept {
         "eagiRsrces",
         "fragResend",
         &resource_manipulator_impl::_handle_resource_resend_request>{});
+    base.add_method(
+      this,
+      message_map<
+        "eagiRsrces",
+        "fragAck",
+        &resource_manipulator_impl::_handle_resource_ack>{});
     base.add_method(
       this,
       message_map<
@@ -863,14 +1321,14 @@ auto resource_manipulator_impl::server_endpoint_id(const url& locator) noexcept
     return broadcast_endpoint_id();
 }
 //------------------------------------------------------------------------------
-auto resource_manipulator_impl::search_resource(
+auto resource_manipulator_impl::_send_locator_query(
+  const message_id msg_id,
   const endpoint_id_t endpoint_id,
   const url& locator) noexcept -> std::optional<message_sequence_t> {
     auto buffer = default_serialize_buffer_for(locator.str());
 
     if(const auto serialized{default_serialize(locator.str(), cover(buffer))})
       [[likely]] {
-        const auto msg_id{message_id{"eagiRsrces", "qryResurce"}};
         message_view message{*serialized};
         message.set_target_id(endpoint_id);
         base.bus_node().set_next_sequence_id(msg_id, message);
@@ -880,6 +1338,20 @@ auto resource_manipulator_impl::search_resource(
     return {};
 }
 //------------------------------------------------------------------------------
+auto resource_manipulator_impl::search_resource(
+  const endpoint_id_t endpoint_id,
+  const url& locator) noexcept -> std::optional<message_sequence_t> {
+    return _send_locator_query(
+      message_id{"eagiRsrces", "qryResurce"}, endpoint_id, locator);
+}
+//------------------------------------------------------------------------------
+auto resource_manipulator_impl::query_resource_size(
+  const endpoint_id_t endpoint_id,
+  const url& locator) noexcept -> std::optional<message_sequence_t> {
+    return _send_locator_query(
+      message_id{"eagiRsrces", "qryRsrSize"}, endpoint_id, locator);
+}
+//------------------------------------------------------------------------------
 auto resource_manipulator_impl::query_resource_content(
   endpoint_id_t endpoint_id,
   const url& locator,
@@ -910,6 +1382,16 @@ auto resource_manipulator_impl::query_resource_content(
     return {};
 }
 //------------------------------------------------------------------------------
+void resource_manipulator_impl::cancel_resource_content(
+  const endpoint_id_t endpoint_id,
+  const message_sequence_t request_id) noexcept {
+    _blobs.cancel_incoming(request_id);
+    message_view message{};
+    message.set_target_id(endpoint_id);
+    message.set_sequence_no(request_id);
+    base.bus_node().post(message_id{"eagiRsrces", "cnclContnt"}, message);
+}
+//------------------------------------------------------------------------------
 auto make_resource_manipulator_impl(
   subscriber& base,
   resource_manipulator_signals& sigs)
@@ -0,0 +1,187 @@
+/// @file
+///
+/// Copyright Matus Chochlik.
+/// Distributed under the Boost Software License, Version 1.0.
+/// See accompanying file LICENSE_1_0.txt or copy at
+/// https://www.boost.org/LICENSE_1_0.txt
+///
+
+#include <eagine/testing/unit_begin_ctx.hpp>
+import std;
+import eagine.core;
+import eagine.msgbus.core;
+import eagine.msgbus.services;
+//------------------------------------------------------------------------------
+auto resource_transfer_test_path(eagitest::case_& test)
+  -> std::filesystem::path {
+    return std::filesystem::temp_directory_path() /
+           std::format(
+             "eagine-msgbus-resource_transfer-{}.bin",
+             test.random().get_between<std::uint32_t>(0U, 1000000U));
+}
+//------------------------------------------------------------------------------
+void resource_transfer_write_file(
+  const std::filesystem::path& path,
+  const std::vector<eagine::byte>& content) {
+    std::ofstream file{path, std::ios::out | std::ios::binary};
+    eagine::write_to_stream(file, eagine::view(content));
+}
+//------------------------------------------------------------------------------
+auto resource_transfer_read_file(const std::filesystem::path& path)
+  -> std::vector<eagine::byte> {
+    std::vector<eagine::byte> content;
+    content.resize(eagine::std_size(std::filesystem::file_size(path)));
+    std::ifstream file{path, std::ios::in | std::ios::binary};
+    eagine::read_from_stream(file, eagine::cover(content));
+    return content;
+}
+//------------------------------------------------------------------------------
+// source slicing
+//------------------------------------------------------------------------------
+void resource_transfer_file_source_slice(unsigned, auto& s) {
+    eagitest::case_ test{s, 1, "file source slice"};
+    auto& rg{test.random()};
+    using eagine::span_size_t;
+
+    const auto path{resource_transfer_test_path(test)};
+    std::vector<eagine::byte> content;
+    content.resize(rg.get_between<std::size_t>(1, 256 * 1024));
+    rg.fill(content);
+    resource_transfer_write_file(path, content);
+
+    const auto file_size{eagine::span_size(content.size())};
+    std::optional<span_size_t> offs;
+    std::optional<span_size_t> size;
+    if(rg.get_bool()) {
+        offs = rg.get_between<span_size_t>(0, file_size + 16);
+    }
+    if(rg.get_bool()) {
+        size = rg.get_between<span_size_t>(0, file_size + 16);
+    }
+    const auto bgn{std::min(offs.value_or(0), file_size)};
+    const auto len{std::min(file_size - bgn, size.value_or(file_size))};
+    const auto expected{
+      eagine::head(eagine::skip(eagine::view(content), bgn), len)};
+
+    if(const auto io{
+         eagine::msgbus::make_file_source_blob_io(path, offs, size)}) {
+        test.check_equal(io->total_size(), len, "total size");
+
+        std::vector<eagine::byte> fragment;
+        span_size_t done{0};
+        while(done < len) {
+            fragment.resize(rg.get_between<std::size_t>(1, 8192));
+            const auto fetched{
+              io->fetch_fragment(done, eagine::cover(fragment))};
+            test.ensure(fetched > 0, "fetched");
+            test.check(
+              eagine::are_equal(
+                eagine::head(eagine::view(fragment), fetched),
+                eagine::head(eagine::skip(expected, done), fetched)),
+              "content ok");
+            done += fetched;
+        }
+        test.check_equal(done, len, "fetched all");
+    } else {
+        test.fail("open source file");
+    }
+    std::filesystem::remove(path);
+}
+//------------------------------------------------------------------------------
+// target out of order
+//------------------------------------------------------------------------------
+void resource_transfer_file_target_shuffled(unsigned, auto& s) {
+    eagitest::case_ test{s, 2, "file target shuffled"};
+    auto& rg{test.random()};
+    using eagine::span_size_t;
+
+    const auto path{resource_transfer_test_path(test)};
+    std::vector<eagine::byte> content;
+    content.resize(rg.get_between<std::size_t>(1, 256 * 1024));
+    rg.fill(content);
+    const auto total{eagine::span_size(content.size())};
+
+    const auto fragment_size{rg.get_between<span_size_t>(1, 4096)};
+    std::vector<span_size_t> offsets;
+    for(span_size_t offs = 0; offs < total; offs += fragment_size) {
+        offsets.push_back(offs);
+    }
+    std::shuffle(
+      offsets.begin(),
+      offsets.end(),
+      std::mt19937{rg.get_between<std::uint32_t>(0U, 1000000U)});
+
+    eagine::msgbus::blob_info info{};
+    info.total_size = total;
+
+    if(const auto io{eagine::msgbus::make_file_target_blob_io(path)}) {
+        for(const auto offs : offsets) {
+            const auto fragment{eagine::head(
+              eagine::skip(eagine::view(content), offs), fragment_size)};
+            test.check(io->store_fragment(offs, fragment, info), "stored");
+            test.check(io->check_stored(offs, fragment), "check stored");
+        }
+        io->handle_finished(
+          {"test", "shuffled"},
+          eagine::msgbus::message_age{},
+          eagine::msgbus::message_info{},
+          info);
+
+        const auto stored{resource_transfer_read_file(path)};
+        test.check_equal(stored.size(), content.size(), "file size");
+        test.check(
+          eagine::are_equal(eagine::view(stored), eagine::view(content)),
+          "content ok");
+    } else {
+        test.fail("open target file");
+    }
+    std::filesystem::remove(path);
+}
+//------------------------------------------------------------------------------
+// empty files
+//------------------------------------------------------------------------------
+void resource_transfer_file_empty(auto& s) {
+    eagitest::case_ test{s, 3, "empty files"};
+    const auto path{resource_transfer_test_path(test)};
+
+    resource_transfer_write_file(path, {});
+    if(const auto io{eagine::msgbus::make_file_source_blob_io(path)}) {
+        test.check_equal(io->total_size(), eagine::span_size(0), "source size");
+    } else {
+        test.fail("open source file");
+    }
+
+    // the previous content of the target file is discarded
+    resource_transfer_write_file(
+      path, {eagine::byte{0xBF}, eagine::byte{0xEF}});
+    eagine::msgbus::blob_info info{};
+    if(const auto io{eagine::msgbus::make_file_target_blob_io(path)}) {
+        test.check(io->store_fragment(0, {}, info), "stored");
+        io->handle_finished(
+          {"test", "empty"},
+          eagine::msgbus::message_age{},
+          eagine::msgbus::message_info{},
+          info);
+        test.check_equal(
+          std::filesystem::file_size(path), std::uintmax_t(0), "target size");
+    } else {
+        test.fail("open target file");
+    }
+    std::filesystem::remove(path);
+}
+//------------------------------------------------------------------------------
+// main
+//------------------------------------------------------------------------------
+auto test_main(eagine::test_ctx& ctx) -> int {
+    eagitest::ctx_suite test{ctx, "resource transfer", 3};
+    test.repeat(20, resource_transfer_file_source_slice);
+    test.repeat(20, resource_transfer_file_target_shuffled);
+    test.once(resource_transfer_file_empty);
+    return test.exit_code();
+}
+//------------------------------------------------------------------------------
+auto main(int argc, const char** argv) -> int {
+    return eagine::test_main_impl(argc, argv, test_main);
+}
+//------------------------------------------------------------------------------
+#include <eagine/testing/unit_end_ctx.hpp>
@@ -70,6 +70,8 @@ export struct resource_data_consumer_node_config {
     application_config_value<std::chrono::seconds> server_response_timeout;
     application_config_value<std::chrono::seconds> resource_search_interval;
     application_config_value<std::chrono::seconds> resource_stream_timeout;
+    application_config_value<span_size_t> range_size;
+    application_config_value<span_size_t> range_requests_per_source;
     int _dummy;
 
     resource_data_consumer_node_config(application_config& c);
@@ -90,6 +92,191 @@ export struct resource_request_params {
     std::optional<msgbus::message_priority> priority{};
 };
 //------------------------------------------------------------------------------
+/// @brief Reassembles a resource from ranges fetched from several servers.
+/// @ingroup msgbus
+/// @see resource_data_consumer_node
+///
+/// Unassigned ranges are handed out to the sources with a free request slot,
+/// the fastest source first, so faster servers transfer a larger part of the
+/// resource. When there are no unassigned ranges left, an idle source that is
+/// faster than the source of a pending range requests that range too.
+/// Every byte is stored into the target I/O object only once.
+/// If none of the sources supports ranges, the whole resource is fetched
+/// from one of them.
+class resource_range_download {
+public:
+    /// @brief Parameters of a range request that should be sent to a source.
+    struct range_request {
+        endpoint_id_t source_id;
+        span_size_t range_index;
+        url locator;
+    };
+
+    /// @brief Identifies a sent range request that should be stopped.
+    struct stopped_request {
+        endpoint_id_t source_id;
+        message_sequence_t request_id;
+    };
+
+    resource_range_download(
+      const url& locator,
+      shared_holder<target_blob_io> target,
+      const span_size_t total_size,
+      const span_size_t range_size,
+      const span_size_t requests_per_source);
+
+    /// @brief Returns the total size of the resource.
+    auto total_size() const noexcept -> span_size_t {
+        return _total_size;
+    }
+
+    /// @brief Returns the number of ranges the resource is split into.
+    auto range_count() const noexcept -> span_size_t {
+        return span_size(_ranges.size());
+    }
+
+    /// @brief Returns the number of bytes stored into the target I/O so far.
+    auto stored_size() const noexcept -> span_size_t {
+        return _stored.covered_size();
+    }
+
+    /// @brief Returns the number of bytes stored from the specified source.
+    auto source_stored_size(const endpoint_id_t source_id) const noexcept
+      -> span_size_t;
+
+    /// @brief Indicates if the download finished, was cancelled or abandoned.
+    auto is_finished() const noexcept -> bool {
+        return _finished;
+    }
+
+    /// @brief Indicates if there is at least one usable source.
+    auto has_sources() const noexcept -> bool;
+
+    /// @brief Adds a server reporting the resource as a source.
+    void add_source(const endpoint_id_t source_id) noexcept;
+
+    /// @brief Removes a source and puts its pending ranges back to the queue.
+    void remove_source(const endpoint_id_t source_id) noexcept;
+
+    /// @brief Returns the next range request to be sent, if any.
+    auto next_request() -> std::optional<range_request>;
+
+    /// @brief Assigns the id of the sent request to a range request.
+    void assign_request(
+      const range_request& request,
+      const message_sequence_t request_id) noexcept;
+
+    /// @brief Returns the sent requests whose transfers should be stopped.
+    /// @see stopped_request
+    ///
+    /// These are the duplicate requests of finished ranges, the requests
+    /// rejected because of an unsupported range and all pending requests
+    /// once the download is finished.
+    auto take_stopped_requests() noexcept -> std::vector<stopped_request> {
+        return std::exchange(_stopped, {});
+    }
+
+    auto store_fragment(
+      const span_size_t range_index,
+      const endpoint_id_t source_id,
+      const span_size_t offs,
+      const memory::const_block data,
+      const blob_info& info) noexcept -> bool;
+
+    auto check_stored(
+      const span_size_t range_index,
+      const span_size_t offs,
+      const memory::const_block data) noexcept -> bool;
+
+    void handle_range_finished(
+      const span_size_t range_index,
+      const endpoint_id_t source_id,
+      const message_id msg_id,
+      const message_age msg_age,
+      const message_info& message,
+      const blob_info& info) noexcept;
+
+    void handle_range_cancelled(
+      const span_size_t range_index,
+      const endpoint_id_t source_id) noexcept;
+
+    /// @brief Cancels the download and notifies the target I/O.
+    void cancel() noexcept;
+
+    /// @brief Stops the download, the data still arriving is dropped.
+    void abandon() noexcept;
+
+private:
+    using _clock_type = std::chrono::steady_clock;
+
+    struct _range_state {
+        endpoint_id_t source_id{};
+        endpoint_id_t duplicate_id{};
+        message_sequence_t source_request_id{0};
+        message_sequence_t duplicate_request_id{0};
+        _clock_type::time_point start_time{};
+        _clock_type::time_point duplicate_time{};
+        span_size_t stored_size{0};
+        bool is_done{false};
+    };
+
+    struct _source_state {
+        span_size_t active_requests{0};
+        span_size_t stored_size{0};
+        float throughput{0.F};
+        bool is_rejected{false};
+        bool rejects_ranges{false};
+    };
+
+    // the pseudo-range index of the whole resource
+    auto _whole_index() const noexcept -> span_size_t {
+        return range_count();
+    }
+
+    auto _range_of(const span_size_t index) noexcept -> _range_state& {
+        return index == _whole_index() ? _whole : _ranges[std_size(index)];
+    }
+
+    auto _range_begin(const span_size_t index) const noexcept -> span_size_t {
+        return index == _whole_index() ? 0 : index * _range_size;
+    }
+
+    auto _range_end(const span_size_t index) const noexcept -> span_size_t {
+        return index == _whole_index()
+                 ? _total_size
+                 : std::min(_range_begin(index) + _range_size, _total_size);
+    }
+
+    auto _range_locator(const span_size_t index) const -> url;
+    auto _next_whole_request() -> std::optional<range_request>;
+
+    auto _release(
+      const span_size_t index,
+      const endpoint_id_t source_id,
+      const _clock_type::time_point now) noexcept
+      -> std::optional<_clock_type::duration>;
+    auto _drop(
+      const span_size_t index,
+      const endpoint_id_t source_id,
+      const _clock_type::time_point now,
+      const bool stop) noexcept -> std::optional<_clock_type::duration>;
+    void _drop_all(const bool stop) noexcept;
+
+    std::string _locator_prefix;
+    shared_holder<target_blob_io> _target;
+    const span_size_t _total_size;
+    const span_size_t _range_size;
+    const span_size_t _requests_per_source;
+    blob_fragment_tracker _stored;
+    std::vector<_range_state> _ranges;
+    _range_state _whole{};
+    std::vector<span_size_t> _todo;
+    std::vector<span_size_t> _active;
+    std::vector<stopped_request> _stopped;
+    std::map<endpoint_id_t, _source_state> _sources;
+    bool _finished{false};
+};
+//------------------------------------------------------------------------------
 /// @brief Message bus service consuming resource data blocks.
 /// @ingroup msgbus
 export class resource_data_consumer_node
@@ -171,6 +358,22 @@ public:
         return fetch_resource_chunks(params, 4096);
     }
 
+    /// @brief Requests a resource and stores its content into the specified file.
+    /// @see stream_resource
+    /// @see make_file_target_blob_io
+    ///
+    /// The blob_stream_finished signal is emitted once the whole resource
+    /// is stored and the blob_stream_cancelled signal if the request fails.
+    /// Embedded resources are not stored, their content is emitted through
+    /// the blob_stream_data_appended signal as with stream_resource.
+    ///
+    /// Returns a pair of unique resource request identifier and the URL.
+    /// The identifier is zero if the file cannot be created.
+    auto store_resource(
+      const resource_request_params& params,
+      const std::filesystem::path& file_path)
+      -> std::pair<identifier_t, const url&>;
+
     /// @brief Cancels a resource request with the specified identifier.
     auto cancel_resource_stream(identifier_t request_id) noexcept -> bool;
 
@@ -182,6 +385,15 @@ public:
     /// @see has_pending_resource
     auto has_pending_resources() const noexcept -> bool;
 
+    /// @brief Returns the number of bytes of a resource stored from a server.
+    /// @see has_pending_resource
+    ///
+    /// Only resources downloaded in ranges are accounted per server,
+    /// zero is returned for the other and for finished requests.
+    auto stored_resource_size(
+      identifier_t request_id,
+      endpoint_id_t server_id) const noexcept -> span_size_t;
+
 private:
     struct _server_info {
         timeout should_check{};
@@ -227,8 +439,17 @@ private:
         shared_holder<target_blob_io> resource_io{};
         timeout should_search{};
         timeout blob_timeout{};
+        timeout size_timeout{};
         message_sequence_t blob_stream_id{0};
         message_priority blob_priority{message_priority::normal};
+        std::vector<endpoint_id_t> range_source_ids{};
+        shared_holder<resource_range_download> ranges{};
+
+        auto has_source() const noexcept -> bool {
+            return is_valid_id(source_server_id) or
+                   not range_source_ids.empty() or
+                   (ranges and ranges->has_sources());
+        }
     };
 
     auto _query_resource(
@@ -237,10 +458,20 @@ private:
       shared_holder<target_blob_io> io,
       const bool all_in_one) -> std::pair<identifier_t, const url&>;
 
+    auto _can_split(const _streamed_resource_info&) const noexcept -> bool;
+    auto _fetch_resource(_streamed_resource_info&, endpoint_id_t) noexcept
+      -> bool;
+    auto _fetch_ranges(_streamed_resource_info&) noexcept -> bool;
+    auto _stop_ranges(resource_range_download&) noexcept -> bool;
+
     void _handle_server_appeared(endpoint_id_t) noexcept;
     void _handle_server_lost(endpoint_id_t) noexcept;
     void _handle_resource_found(endpoint_id_t, const url&) noexcept;
     void _handle_missing(endpoint_id_t, const url&) noexcept;
+    void _handle_resource_size(
+      endpoint_id_t,
+      const url&,
+      const span_size_t) noexcept;
     void _handle_stream_done(identifier_t) noexcept;
     void _handle_stream_cancelled(identifier_t) noexcept;
     void _handle_stream_data(const blob_stream_chunk&) noexcept;
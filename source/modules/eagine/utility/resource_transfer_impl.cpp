@@ -83,8 +83,467 @@ resource_data_consumer_node_config::resource_data_consumer_node_config(
   , server_response_timeout{c, "resource.consumer.server_response_timeout", std::chrono::seconds{60}}
   , resource_search_interval{c, "resource.consumer.search_interval", std::chrono::seconds{3}}
   , resource_stream_timeout{c, "resource.consumer.stream_timeout", std::chrono::seconds{3600}}
+  , range_size{c, "resource.consumer.range_size", span_size_t(4 * 1024 * 1024)}
+  , range_requests_per_source{c, "resource.consumer.range_requests_per_source", span_size_t(2)}
   , _dummy{0} {}
 //------------------------------------------------------------------------------
+// resource_range_download
+//------------------------------------------------------------------------------
+resource_range_download::resource_range_download(
+  const url& locator,
+  shared_holder<target_blob_io> target,
+  const span_size_t total_size,
+  const span_size_t range_size,
+  const span_size_t requests_per_source)
+  : _locator_prefix{locator.str()}
+  , _target{std::move(target)}
+  , _total_size{total_size}
+  , _range_size{std::max(range_size, span_size(1))}
+  , _requests_per_source{std::max(requests_per_source, span_size(1))} {
+    _locator_prefix.push_back(
+      _locator_prefix.find('?') == std::string::npos ? '?' : '&');
+    const auto count{(_total_size + _range_size - 1) / _range_size};
+    _ranges.resize(std_size(count));
+    // the ranges are taken from the back, lower offsets go first
+    _todo.reserve(std_size(count));
+    for(span_size_t index = count; index > 0; --index) {
+        _todo.push_back(index - 1);
+    }
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::_range_locator(const span_size_t index) const
+  -> url {
+    if(index == _whole_index()) {
+        // without the trailing argument separator
+        return url{_locator_prefix.substr(0, _locator_prefix.size() - 1U)};
+    }
+    return url{std::format(
+      "{}offs={}&size={}",
+      _locator_prefix,
+      _range_begin(index),
+      _range_end(index) - _range_begin(index))};
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::has_sources() const noexcept -> bool {
+    return std::any_of(_sources.begin(), _sources.end(), [](const auto& entry) {
+        return not std::get<1>(entry).is_rejected;
+    });
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::source_stored_size(
+  const endpoint_id_t source_id) const noexcept -> span_size_t {
+    const auto pos{_sources.find(source_id)};
+    return pos != _sources.end() ? std::get<1>(*pos).stored_size : 0;
+}
+//------------------------------------------------------------------------------
+void resource_range_download::add_source(
+  const endpoint_id_t source_id) noexcept {
+    // a source that does not support ranges stays marked as such
+    _sources[source_id].is_rejected = false;
+}
+//------------------------------------------------------------------------------
+void resource_range_download::remove_source(
+  const endpoint_id_t source_id) noexcept {
+    const auto now{_clock_type::now()};
+    for(const auto index : std::vector<span_size_t>{_active}) {
+        _release(index, source_id, now);
+    }
+    _release(_whole_index(), source_id, now);
+    _sources.erase(source_id);
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::_release(
+  const span_size_t index,
+  const endpoint_id_t source_id,
+  const _clock_type::time_point now) noexcept
+  -> std::optional<_clock_type::duration> {
+    auto& range{_range_of(index)};
+    std::optional<_clock_type::duration> elapsed{};
+    if(range.source_id == source_id) {
+        range.source_id = {};
+        range.source_request_id = 0;
+        elapsed = now - range.start_time;
+    } else if(range.duplicate_id == source_id) {
+        range.duplicate_id = {};
+        range.duplicate_request_id = 0;
+        elapsed = now - range.duplicate_time;
+    } else {
+        return {};
+    }
+    if(
+      not range.is_done and not is_valid_id(range.source_id) and
+      not is_valid_id(range.duplicate_id) and (index != _whole_index())) {
+        std::erase(_active, index);
+        _todo.push_back(index);
+    }
+    return elapsed;
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::_drop(
+  const span_size_t index,
+  const endpoint_id_t source_id,
+  const _clock_type::time_point now,
+  const bool stop) noexcept -> std::optional<_clock_type::duration> {
+    if(not is_valid_id(source_id)) {
+        return {};
+    }
+    const auto& range{_range_of(index)};
+    const auto request_id{
+      range.source_id == source_id      ? range.source_request_id
+      : range.duplicate_id == source_id ? range.duplicate_request_id
+                                        : message_sequence_t{0}};
+    const auto elapsed{_release(index, source_id, now)};
+    if(elapsed) {
+        const auto pos{_sources.find(source_id)};
+        if(pos != _sources.end()) {
+            --std::get<1>(*pos).active_requests;
+        }
+        if(stop and (request_id != 0)) {
+            _stopped.push_back({source_id, request_id});
+        }
+    }
+    return elapsed;
+}
+//------------------------------------------------------------------------------
+void resource_range_download::_drop_all(const bool stop) noexcept {
+    const auto now{_clock_type::now()};
+    for(const auto index : std::vector<span_size_t>{_active}) {
+        const auto& range{_range_of(index)};
+        _drop(index, range.duplicate_id, now, stop);
+        _drop(index, range.source_id, now, stop);
+    }
+    _drop(_whole_index(), _whole.source_id, now, stop);
+    _active.clear();
+    _todo.clear();
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::next_request() -> std::optional<range_request> {
+    if(_finished) {
+        return {};
+    }
+    auto source{_sources.end()};
+    for(auto pos{_sources.begin()}; pos != _sources.end(); ++pos) {
+        const auto& state{std::get<1>(*pos)};
+        if(
+          not state.is_rejected and not state.rejects_ranges and
+          (state.active_requests < _requests_per_source)) {
+            if(
+              (source == _sources.end()) or
+              (state.throughput > std::get<1>(*source).throughput)) {
+                source = pos;
+            }
+        }
+    }
+    if(source == _sources.end()) {
+        return _next_whole_request();
+    }
+    auto& [source_id, state] = *source;
+    const auto now{_clock_type::now()};
+
+    if(not _todo.empty()) {
+        const auto index{_todo.back()};
+        _todo.pop_back();
+        auto& range{_ranges[std_size(index)]};
+        range.source_id = source_id;
+        range.start_time = now;
+        _active.push_back(index);
+        ++state.active_requests;
+        return {{source_id, index, _range_locator(index)}};
+    }
+
+    // help with the longest pending range of a slower source
+    const auto throughput_of{[this](const endpoint_id_t id) {
+        const auto pos{_sources.find(id)};
+        return pos != _sources.end() ? std::get<1>(*pos).throughput : 0.F;
+    }};
+    std::optional<span_size_t> slowest{};
+    for(const auto index : _active) {
+        const auto& range{_ranges[std_size(index)]};
+        if(
+          not is_valid_id(range.duplicate_id) and
+          (range.source_id != source_id) and
+          (throughput_of(range.source_id) < state.throughput)) {
+            if(
+              not slowest or
+              (range.start_time < _ranges[std_size(*slowest)].start_time)) {
+                slowest = index;
+            }
+        }
+    }
+    if(slowest) {
+        auto& range{_ranges[std_size(*slowest)]};
+        range.duplicate_id = source_id;
+        range.duplicate_time = now;
+        ++state.active_requests;
+        return {{source_id, *slowest, _range_locator(*slowest)}};
+    }
+    return {};
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::_next_whole_request()
+  -> std::optional<range_request> {
+    if(is_valid_id(_whole.source_id)) {
+        return {};
+    }
+    // the whole resource is fetched only if none of the sources does ranges
+    auto source{_sources.end()};
+    for(auto pos{_sources.begin()}; pos != _sources.end(); ++pos) {
+        const auto& state{std::get<1>(*pos)};
+        if(not state.is_rejected) {
+            if(not state.rejects_ranges) {
+                return {};
+            }
+            if(source == _sources.end()) {
+                source = pos;
+            }
+        }
+    }
+    if(source == _sources.end()) {
+        return {};
+    }
+    auto& [source_id, state] = *source;
+    _whole.source_id = source_id;
+    _whole.start_time = _clock_type::now();
+    ++state.active_requests;
+    return {{source_id, _whole_index(), _range_locator(_whole_index())}};
+}
+//------------------------------------------------------------------------------
+void resource_range_download::assign_request(
+  const range_request& request,
+  const message_sequence_t request_id) noexcept {
+    auto& range{_range_of(request.range_index)};
+    if(range.source_id == request.source_id) {
+        range.source_request_id = request_id;
+    } else if(range.duplicate_id == request.source_id) {
+        range.duplicate_request_id = request_id;
+    }
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::store_fragment(
+  const span_size_t range_index,
+  const endpoint_id_t source_id,
+  const span_size_t offs,
+  const memory::const_block data,
+  const blob_info& info) noexcept -> bool {
+    if(_finished) {
+        return true;
+    }
+    const auto bgn{_range_begin(range_index)};
+    const auto end{_range_end(range_index)};
+    const auto source{_sources.find(source_id)};
+    if(info.total_size != end - bgn) [[unlikely]] {
+        // the source does not support ranges of this resource,
+        // its request is stopped and the range goes back to the queue
+        if(source != _sources.end()) {
+            auto& state{std::get<1>(*source)};
+            state.rejects_ranges = true;
+            // reports a different size for the whole resource
+            state.is_rejected |= (range_index == _whole_index());
+        }
+        _drop(range_index, source_id, _clock_type::now(), true);
+        return false;
+    }
+    const auto frag_bgn{bgn + offs};
+    const auto frag{head(data, std::max(end - frag_bgn, span_size(0)))};
+    if(frag.empty()) {
+        return true;
+    }
+
+    blob_info whole_info{info};
+    whole_info.total_size = _total_size;
+    auto& range{_range_of(range_index)};
+    return _stored.merge(
+      frag_bgn,
+      frag_bgn + frag.size(),
+      {construct_from,
+       [&](
+         const span_size_t sub_bgn,
+         const span_size_t sub_end,
+         const bool existing) noexcept {
+           const auto sub{
+             head(skip(frag, sub_bgn - frag_bgn), sub_end - sub_bgn)};
+           if(existing) {
+               return _target->check_stored(sub_bgn, sub);
+           }
+           range.stored_size += sub.size();
+           if(source != _sources.end()) {
+               std::get<1>(*source).stored_size += sub.size();
+           }
+           return _target->store_fragment(sub_bgn, sub, whole_info);
+       }});
+}
+//------------------------------------------------------------------------------
+auto resource_range_download::check_stored(
+  const span_size_t range_index,
+  const span_size_t offs,
+  const memory::const_block data) noexcept -> bool {
+    if(_finished) {
+        return true;
+    }
+    return _target->check_stored(_range_begin(range_index) + offs, data);
+}
+//------------------------------------------------------------------------------
+void resource_range_download::handle_range_finished(
+  const span_size_t range_index,
+  const endpoint_id_t source_id,
+  const message_id msg_id,
+  const message_age msg_age,
+  const message_info& message,
+  const blob_info& info) noexcept {
+    auto& range{_range_of(range_index)};
+    const auto range_size{_range_end(range_index) - _range_begin(range_index)};
+    if(range.stored_size >= range_size) {
+        range.is_done = true;
+        std::erase(_active, range_index);
+    }
+    const auto now{_clock_type::now()};
+    if(const auto elapsed{_drop(range_index, source_id, now, false)}) {
+        const auto pos{_sources.find(source_id)};
+        if(pos != _sources.end()) {
+            auto& state{std::get<1>(*pos)};
+            const auto seconds{std::chrono::duration<float>(*elapsed).count()};
+            if(seconds > 0.F) {
+                const auto sample{float(range_size) / seconds};
+                state.throughput = state.throughput > 0.F
+                                     ? 0.75F * state.throughput + 0.25F * sample
+                                     : sample;
+            }
+        }
+    }
+    if(range.is_done) {
+        // the other request for the same range is not needed anymore
+        _drop(range_index, range.source_id, now, true);
+        _drop(range_index, range.duplicate_id, now, true);
+    }
+    if(not _finished and (_stored.covered_size() >= _total_size)) {
+        _finished = true;
+        _drop_all(true);
+        blob_info whole_info{info};
+        whole_info.total_size = _total_size;
+        _target->handle_finished(msg_id, msg_age, message, whole_info);
+    }
+}
+//------------------------------------------------------------------------------
+void resource_range_download::handle_range_cancelled(
+  const span_size_t range_index,
+  const endpoint_id_t source_id) noexcept {
+    if(_drop(range_index, source_id, _clock_type::now(), false)) {
+        const auto pos{_sources.find(source_id)};
+        if(pos != _sources.end()) {
+            std::get<1>(*pos).is_rejected = true;
+        }
+    }
+}
+//------------------------------------------------------------------------------
+void resource_range_download::cancel() noexcept {
+    if(not _finished) {
+        _finished = true;
+        _drop_all(true);
+        _target->handle_cancelled();
+    }
+}
+//------------------------------------------------------------------------------
+void resource_range_download::abandon() noexcept {
+    if(not _finished) {
+        _finished = true;
+        _drop_all(true);
+    }
+}
+//------------------------------------------------------------------------------
+// resource_range_io
+//------------------------------------------------------------------------------
+class resource_range_io final : public target_blob_io {
+public:
+    resource_range_io(
+      shared_holder<resource_range_download> download,
+      const endpoint_id_t source_id,
+      const span_size_t range_index) noexcept
+      : _download{std::move(download)}
+      , _source_id{source_id}
+      , _range_index{range_index} {}
+
+    auto store_fragment(
+      const span_size_t offs,
+      const memory::const_block data,
+      const blob_info& info) noexcept -> bool final {
+        return _download->store_fragment(
+          _range_index, _source_id, offs, data, info);
+    }
+
+    auto check_stored(
+      const span_size_t offs,
+      const memory::const_block data) noexcept -> bool final {
+        return _download->check_stored(_range_index, offs, data);
+    }
+
+    void handle_finished(
+      const message_id msg_id,
+      const message_age msg_age,
+      const message_info& message,
+      const blob_info& info) noexcept final {
+        _download->handle_range_finished(
+          _range_index, _source_id, msg_id, msg_age, message, info);
+    }
+
+    void handle_cancelled() noexcept final {
+        _download->handle_range_cancelled(_range_index, _source_id);
+    }
+
+private:
+    shared_holder<resource_range_download> _download;
+    const endpoint_id_t _source_id;
+    const span_size_t _range_index;
+};
+//------------------------------------------------------------------------------
+// resource_file_io
+//------------------------------------------------------------------------------
+class resource_file_io final : public target_blob_io {
+public:
+    resource_file_io(
+      const identifier_t request_id,
+      blob_stream_signals& signals,
+      shared_holder<target_blob_io> file) noexcept
+      : _request_id{request_id}
+      , _signals{signals}
+      , _file{std::move(file)} {}
+
+    void handle_prepared(float progress) noexcept final {
+        _signals.blob_preparation_progressed(_request_id, progress);
+    }
+
+    auto store_fragment(
+      const span_size_t offs,
+      const memory::const_block data,
+      const blob_info& info) noexcept -> bool final {
+        return _file->store_fragment(offs, data, info);
+    }
+
+    auto check_stored(
+      const span_size_t offs,
+      const memory::const_block data) noexcept -> bool final {
+        return _file->check_stored(offs, data);
+    }
+
+    void handle_finished(
+      const message_id msg_id,
+      const message_age msg_age,
+      const message_info& message,
+      const blob_info& info) noexcept final {
+        _file->handle_finished(msg_id, msg_age, message, info);
+        _signals.blob_stream_finished(_request_id);
+    }
+
+    void handle_cancelled() noexcept final {
+        _file->handle_cancelled();
+        _signals.blob_stream_cancelled(_request_id);
+    }
+
+private:
+    const identifier_t _request_id;
+    blob_stream_signals& _signals;
+    shared_holder<target_blob_io> _file;
+};
+//------------------------------------------------------------------------------
 // resource_data_consumer_node
 //------------------------------------------------------------------------------
 resource_data_consumer_node::resource_data_consumer_node(endpoint& bus)
@@ -181,6 +640,8 @@ void resource_data_consumer_node::_init() {
       this, server_has_resource);
     connect<&resource_data_consumer_node::_handle_missing>(
       this, server_has_not_resource);
+    connect<&resource_data_consumer_node::_handle_resource_size>(
+      this, server_resource_size);
     connect<&resource_data_consumer_node::_handle_stream_done>(
       this, blob_stream_finished);
     connect<&resource_data_consumer_node::_handle_stream_cancelled>(
@@ -214,8 +675,36 @@ auto resource_data_consumer_node::update_and_process_all() noexcept
         }
     }
 
-    for(auto& [request_id, info] : _streamed_resources) {
-        if(not is_valid_id(info.source_server_id)) {
+    for(auto pos{_streamed_resources.begin()};
+        pos != _streamed_resources.end();) {
+        const auto request_id{std::get<0>(*pos)};
+        auto& info{std::get<1>(*pos)};
+        ++pos;
+        if(info.ranges) {
+            if(info.ranges->is_finished()) {
+                _stop_ranges(*info.ranges);
+                _handle_stream_done(request_id);
+                continue;
+            }
+            if(info.blob_timeout.is_expired()) {
+                const auto ranges{info.ranges};
+                ranges->cancel();
+                _stop_ranges(*info.ranges);
+                _handle_stream_cancelled(request_id);
+                continue;
+            }
+            something_done(_stop_ranges(*info.ranges));
+            something_done(_fetch_ranges(info));
+        } else if(not info.range_source_ids.empty()) {
+            if(info.size_timeout.is_expired()) {
+                // the server did not respond with the size, fetch it whole
+                const auto server_id{info.range_source_ids.front()};
+                info.range_source_ids.clear();
+                _fetch_resource(info, server_id);
+                something_done();
+            }
+        }
+        if(not info.has_source()) {
             if(info.should_search) {
                 for(auto& [server_id, sinfo] : _current_servers) {
                     if(not sinfo.not_responding) {
@@ -261,6 +750,18 @@ auto resource_data_consumer_node::has_pending_resources() const noexcept
     return not _streamed_resources.empty() or not _embedded_resources.empty();
 }
 //------------------------------------------------------------------------------
+auto resource_data_consumer_node::stored_resource_size(
+  identifier_t request_id,
+  endpoint_id_t server_id) const noexcept -> span_size_t {
+    const auto pos{_streamed_resources.find(request_id)};
+    if(pos != _streamed_resources.end()) {
+        if(const auto& ranges{std::get<1>(*pos).ranges}) {
+            return ranges->source_stored_size(server_id);
+        }
+    }
+    return 0;
+}
+//------------------------------------------------------------------------------
 auto resource_data_consumer_node::get_request_id() noexcept -> identifier_t {
     do {
         ++_res_id_seq;
@@ -322,9 +823,33 @@ auto resource_data_consumer_node::fetch_resource_chunks(
       true);
 }
 //------------------------------------------------------------------------------
+auto resource_data_consumer_node::store_resource(
+  const resource_request_params& params,
+  const std::filesystem::path& file_path)
+  -> std::pair<identifier_t, const url&> {
+    if(auto file_io{make_file_target_blob_io(file_path)}) {
+        const auto request_id{get_request_id()};
+        return _query_resource(
+          request_id,
+          params,
+          shared_holder<target_blob_io>{
+            hold<resource_file_io>, request_id, *this, std::move(file_io)},
+          false);
+    }
+    log_error("failed to create resource file ${filePath}")
+      .tag("resFileErr")
+      .arg("locator", params.locator.str())
+      .arg("filePath", "FsPath", file_path);
+    return {0, params.locator};
+}
+//------------------------------------------------------------------------------
 auto resource_data_consumer_node::cancel_resource_stream(
   identifier_t request_id) noexcept -> bool {
     if(const auto found{find(_streamed_resources, request_id)}) {
+        if(found->ranges) {
+            found->ranges->abandon();
+            _stop_ranges(*found->ranges);
+        }
         const auto locator{found->locator.release_string()};
         _streamed_resources.erase(found.position());
         log_info("resource request id ${reqId} (${locator}) canceled")
@@ -348,6 +873,13 @@ void resource_data_consumer_node::_handle_server_appeared(
     log_info("resource server ${id} appeared")
       .tag("resSrvAppr")
       .arg("id", server_id);
+    // new servers may have replicas of the resources downloaded in ranges
+    for(auto& entry : _streamed_resources) {
+        auto& res_info = std::get<1>(entry);
+        if(res_info.ranges) {
+            search_resource(server_id, res_info.locator);
+        }
+    }
 }
 //------------------------------------------------------------------------------
 void resource_data_consumer_node::_handle_server_lost(
@@ -357,6 +889,10 @@ void resource_data_consumer_node::_handle_server_lost(
         if(info.source_server_id == server_id) {
             info.source_server_id = {};
         }
+        std::erase(info.range_source_ids, server_id);
+        if(info.ranges) {
+            info.ranges->remove_source(server_id);
+        }
     }
     _current_servers.erase(server_id);
     log_info("resource server ${id} lost")
@@ -364,26 +900,103 @@ void resource_data_consumer_node::_handle_server_lost(
       .arg("id", server_id);
 }
 //------------------------------------------------------------------------------
+auto resource_data_consumer_node::_can_split(
+  const _streamed_resource_info& info) const noexcept -> bool {
+    return (_config.range_size.value() > 0) and
+           not info.locator.argument("offs") and
+           not info.locator.argument("size");
+}
+//------------------------------------------------------------------------------
+auto resource_data_consumer_node::_fetch_resource(
+  _streamed_resource_info& info,
+  endpoint_id_t server_id) noexcept -> bool {
+    if(const auto id{query_resource_content(
+         server_id,
+         info.locator,
+         info.resource_io,
+         info.blob_priority,
+         info.blob_timeout)}) {
+        info.source_server_id = server_id;
+        info.blob_stream_id = *id;
+        log_info("fetching resource ${locator} from server ${id}")
+          .tag("qryResCont")
+          .arg("locator", info.locator.str())
+          .arg("priority", info.blob_priority)
+          .arg("id", server_id);
+        return true;
+    }
+    return false;
+}
+//------------------------------------------------------------------------------
+auto resource_data_consumer_node::_fetch_ranges(
+  _streamed_resource_info& info) noexcept -> bool {
+    bool something_done{false};
+    while(const auto request{info.ranges->next_request()}) {
+        if(const auto request_id{query_resource_content(
+             request->source_id,
+             request->locator,
+             shared_holder<target_blob_io>{
+               hold<resource_range_io>,
+               info.ranges,
+               request->source_id,
+               request->range_index},
+             info.blob_priority,
+             info.blob_timeout)}) {
+            info.ranges->assign_request(*request, *request_id);
+            log_debug("fetching range ${index} of ${locator} from ${id}")
+              .tag("qryResRnge")
+              .arg("locator", info.locator.str())
+              .arg("index", request->range_index)
+              .arg("id", request->source_id);
+            something_done = true;
+        } else {
+            info.ranges->handle_range_cancelled(
+              request->range_index, request->source_id);
+            break;
+        }
+    }
+    return something_done;
+}
+//------------------------------------------------------------------------------
+auto resource_data_consumer_node::_stop_ranges(
+  resource_range_download& ranges) noexcept -> bool {
+    bool something_done{false};
+    // the transfers of finished, duplicate or rejected ranges are stopped
+    // instead of being dropped by the download while they still stream
+    for(const auto& request : ranges.take_stopped_requests()) {
+        cancel_resource_content(request.source_id, request.request_id);
+        log_debug("stopped range request ${reqId} to ${id}")
+          .tag("stpResRnge")
+          .arg("reqId", request.request_id)
+          .arg("id", request.source_id);
+        something_done = true;
+    }
+    return something_done;
+}
+//------------------------------------------------------------------------------
 void resource_data_consumer_node::_handle_resource_found(
   endpoint_id_t server_id,
   const url& locator) noexcept {
     for(auto& entry : _streamed_resources) {
         auto& info = std::get<1>(entry);
         if(info.locator == locator) {
-            if(not is_valid_id(info.source_server_id)) {
-                if(const auto id{query_resource_content(
-                     server_id,
-                     info.locator,
-                     info.resource_io,
-                     info.blob_priority,
-                     info.blob_timeout)}) {
-                    info.source_server_id = server_id;
-                    info.blob_stream_id = *id;
-                    log_info("fetching resource ${locator} from server ${id}")
-                      .tag("qryResCont")
-                      .arg("locator", info.locator.str())
-                      .arg("priority", info.blob_priority)
-                      .arg("id", server_id);
+            if(info.ranges) {
+                info.ranges->add_source(server_id);
+            } else if(not is_valid_id(info.source_server_id)) {
+                if(_can_split(info)) {
+                    // the resource size decides if it is fetched in ranges
+                    if(info.range_source_ids.empty()) {
+                        query_resource_size(server_id, info.locator);
+                        info.size_timeout.reset(
+                          _config.resource_search_interval.value());
+                    }
+                    auto& ids{info.range_source_ids};
+                    if(
+                      std::find(ids.begin(), ids.end(), server_id) ==
+                      ids.end()) {
+                        ids.push_back(server_id);
+                    }
+                } else if(_fetch_resource(info, server_id)) {
                     break;
                 }
             }
@@ -391,12 +1004,52 @@ void resource_data_consumer_node::_handle_resource_found(
     }
 }
 //------------------------------------------------------------------------------
+void resource_data_consumer_node::_handle_resource_size(
+  endpoint_id_t server_id,
+  const url& locator,
+  const span_size_t size) noexcept {
+    for(auto& entry : _streamed_resources) {
+        auto& info = std::get<1>(entry);
+        if(
+          (info.locator == locator) and not info.ranges and
+          not is_valid_id(info.source_server_id) and
+          not info.range_source_ids.empty()) {
+            if(size > _config.range_size.value()) {
+                info.ranges = {
+                  hold<resource_range_download>,
+                  info.locator,
+                  info.resource_io,
+                  size,
+                  _config.range_size.value(),
+                  _config.range_requests_per_source.value()};
+                for(const auto source_id : info.range_source_ids) {
+                    info.ranges->add_source(source_id);
+                }
+                info.ranges->add_source(server_id);
+                log_info("fetching resource ${locator} in ${count} ranges")
+                  .tag("qryResRngs")
+                  .arg("locator", info.locator.str())
+                  .arg("size", "ByteSize", size)
+                  .arg("count", info.ranges->range_count())
+                  .arg("sources", info.range_source_ids.size());
+            } else {
+                _fetch_resource(info, server_id);
+            }
+            info.range_source_ids.clear();
+        }
+    }
+}
+//------------------------------------------------------------------------------
 void resource_data_consumer_node::_handle_missing(
   endpoint_id_t server_id,
   const url& locator) noexcept {
     for(auto& entry : _streamed_resources) {
         auto& info = std::get<1>(entry);
         if(info.locator == locator) {
+            std::erase(info.range_source_ids, server_id);
+            if(info.ranges) {
+                info.ranges->remove_source(server_id);
+            }
             if(info.source_server_id == server_id) {
                 info.source_server_id = {};
                 log_debug("resource ${locator} not found on server ${id}")
@@ -112,14 +112,105 @@ void resource_transfer_1(auto& s) {
     the_reg.finish();
 }
 //------------------------------------------------------------------------------
+// test 2
+//------------------------------------------------------------------------------
+void resource_transfer_multi_source(auto& s) {
+    eagitest::case_ test{s, 2, "multi-source"};
+    eagitest::track trck{test, 0, 2};
+    auto& ctx{s.context()};
+    eagine::msgbus::registry the_reg{ctx};
+
+    auto& server_a =
+      the_reg.emplace<eagine::msgbus::resource_data_server_node>("ServerA");
+    auto& server_b =
+      the_reg.emplace<eagine::msgbus::resource_data_server_node>("ServerB");
+    auto& consumer =
+      the_reg.emplace<eagine::msgbus::resource_data_consumer_node>("Consumer");
+
+    if(the_reg.wait_for_id_of(
+         std::chrono::seconds{30}, server_a, server_b, consumer)) {
+        // several ranges with the default range size, the last one partial
+        const eagine::span_size_t total_size{3 * 4 * 1024 * 1024 + 12345};
+        eagine::span_size_t next_offset{0};
+        bool is_consecutive{true};
+        bool is_correct{true};
+
+        const auto expected{[](eagine::span_size_t offs) {
+            // big-endian sequence of 64-bit unsigned integers
+            const auto seq{std::uint64_t(offs / 8)};
+            return eagine::byte((seq >> (8U * (7U - unsigned(offs % 8)))) &
+                                0xFFU);
+        }};
+
+        const auto consume{[&](const eagine::msgbus::blob_stream_chunk& chunk) {
+            is_consecutive = is_consecutive and (chunk.offset == next_offset);
+            auto offs{chunk.offset};
+            for(const auto& blk : chunk.data) {
+                for(auto b : blk) {
+                    is_correct = is_correct and (b == expected(offs));
+                    ++offs;
+                }
+                trck.checkpoint(1);
+            }
+            next_offset = offs;
+        }};
+
+        consumer.blob_stream_data_appended.connect(
+          {eagine::construct_from, consume});
+
+        const auto request_id{
+          consumer
+            .stream_resource(
+              {.locator = eagine::url("eagires:///sequence?count=12595257"),
+               .max_time = std::chrono::minutes{5}})
+            .first};
+
+        test.check(consumer.has_pending_resources(), "has pending");
+
+        // the per-server sizes are available only while the request is pending
+        eagine::span_size_t from_a{0};
+        eagine::span_size_t from_b{0};
+        eagine::timeout transfer_time{std::chrono::minutes{1}};
+        while(consumer.has_pending_resources()) {
+            if(transfer_time.is_expired()) {
+                test.fail("data transfer timeout");
+                break;
+            }
+            the_reg.update_and_process();
+            from_a = std::max(
+              from_a,
+              consumer.stored_resource_size(
+                request_id, server_a.bus_node().get_id()));
+            from_b = std::max(
+              from_b,
+              consumer.stored_resource_size(
+                request_id, server_b.bus_node().get_id()));
+        }
+
+        test.check_equal(next_offset, total_size, "all transferred");
+        test.check(is_consecutive, "consecutive");
+        test.check(is_correct, "content");
+        test.check(from_a > 0, "data from server A");
+        test.check(from_b > 0, "data from server B");
+        test.check_equal(from_a + from_b, total_size, "stored once");
+
+        trck.checkpoint(2);
+    } else {
+        test.fail("get id observer");
+    }
+
+    the_reg.finish();
+}
+//------------------------------------------------------------------------------
 // main
 //------------------------------------------------------------------------------
 auto test_main(eagine::test_ctx& ctx) -> int {
     enable_message_bus(ctx);
     ctx.preinitialize();
 
-    eagitest::ctx_suite test{ctx, "resource transfer", 1};
+    eagitest::ctx_suite test{ctx, "resource transfer", 2};
     test.once(resource_transfer_1);
+    test.once(resource_transfer_multi_source);
     return test.exit_code();
 }
 //------------------------------------------------------------------------------